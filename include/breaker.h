@@ -0,0 +1,50 @@
+#pragma once
+// ============================================================
+//  Per-endpoint circuit breakers
+// ============================================================
+//  One small state machine per remote service. While CLOSED every
+//  request goes out. BREAKER_TRIP failures in a row (transport
+//  error, 5xx or 429) OPEN it: nothing is sent, no handshake is
+//  attempted, until a jittered exponential backoff has passed, or
+//  the server's Retry-After if that is longer. Then it is HALF_OPEN
+//  and exactly one probe goes out. Success closes the breaker;
+//  failure opens it again with the backoff doubled.
+//
+//  Callers ask breakerAllow() before leasing a connection and hand
+//  every outcome to breakerReport(). Other 4xx codes count as the
+//  service answering, so a 401 or 404 never trips a breaker.
+// ============================================================
+
+#include <Arduino.h>
+
+#define BREAKER_TRIP         3                    // consecutive failures that open
+#define BREAKER_BASE_MS      2000UL               // first backoff
+#define BREAKER_MAX_MS       (5UL * 60 * 1000)    // backoff ceiling
+#define BREAKER_RETRY_MAX_S  3600                 // cap on a server's Retry-After
+#define BREAKER_PROBE_MS     30000UL              // a probe never reported is given up
+
+enum Endpoint : uint8_t { EP_SPOTIFY_API, EP_SPOTIFY_ACCOUNTS, EP_ART, EP_COINGECKO,
+                          EP_FINNHUB, EP_COUNT };
+enum BreakerState : uint8_t { BREAKER_CLOSED, BREAKER_OPEN, BREAKER_HALF_OPEN };
+
+// True if a request may go out now. A HALF_OPEN breaker lets one
+// caller through and refuses the rest until that one reports.
+bool breakerAllow(Endpoint ep);
+
+// Outcome of a request: an HTTP status or a negative HTTP_ERR_*.
+// `retryAfterS` is the 429/503 Retry-After in seconds (0 if none).
+void breakerReport(Endpoint ep, int code, uint32_t retryAfterS = 0);
+
+// ── Telemetry ──
+struct BreakerInfo {
+  BreakerState  state;
+  uint8_t       failures;     // consecutive
+  uint8_t       level;        // backoff doublings so far
+  unsigned long retryInMs;    // until the next probe (OPEN only)
+  uint32_t      trips;        // CLOSED -> OPEN transitions
+  uint32_t      refused;      // requests not sent while open
+  uint32_t      throttled;    // 429s seen
+  int           lastCode;
+};
+void        breakerInfo(Endpoint ep, BreakerInfo& out);
+const char* endpointName(Endpoint ep);
@@ -6,14 +6,23 @@
 #include <Arduino.h>
 #include <TFT_eSPI.h>
 #include <TJpg_Decoder.h>
-#include <SpotifyEsp32.h>
 #include <OneButton.h>
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
-#include <HTTPClient.h>
 #include <freertos/semphr.h>
+#include <limits.h>
+#include "seqlock.h"
+#include "spscring.h"
+#include "tlsclient.h"
+#include "httpclient.h"
+#include "h2conn.h"
+#include "dnscache.h"
+#include "connpool.h"
+#include "breaker.h"
+#include "reactor.h"
+#include "jsonpull.h"
 #include "FreeSansBold9pt8b.h"
 #include "FreeSans8pt8b.h"
 #include "FreeSans5pt8b.h"
@@ -22,6 +31,18 @@
 extern const char* SPOTIFY_CLIENT_ID;
 extern const char* SPOTIFY_CLIENT_SECRET;
 #define SPOTIFY_SCOPES "user-read-playback-state%20user-modify-playback-state%20user-read-currently-playing"
+#define SPOTIFY_API_HOST      "api.spotify.com"
+#define SPOTIFY_ACCOUNTS_HOST "accounts.spotify.com"
+#define SPOTIFY_ART_HOST      "i.scdn.co"           // album art CDN (URLs come from the API)
+#define COINGECKO_HOST        "api.coingecko.com"
+#define FINNHUB_HOST          "finnhub.io"
+#define SPOTIFY_API_H2        1   // offer HTTP/2 to the API host (PSRAM only); 0 = HTTP/1.1
+#define TLS_ALLOC_DEFAULT     TLS_ALLOC_SPLIT   // where mbedTLS buffers go (tlsclient.h)
+#define TLS_BENCH_ROUNDS      3   // full + resumed handshake pairs per policy (serial TLSBENCH)
+#define ACCESS_TOKEN_MAX  400   // Spotify access tokens are ~200-300 chars
+#define REFRESH_TOKEN_MAX 256
+#define TOKEN_REFRESH_LEAD_MS (5UL * 60 * 1000)  // refresh this long before expiry
+#define TOKEN_RETRY_MS        30000               // between deferred/failed attempts
 
 // ── Hardware Pins ────────────────────────────────────────
 #define BTN_TOP     0
@@ -82,6 +103,7 @@ extern const char* SPOTIFY_CLIENT_SECRET;
 // ── Ticker ───────────────────────────────────────────────
 #define MAX_TICKERS      8
 #define TICKER_FETCH_MS  60000
+#define TICKER_SLACK_MS  30000   // a due refresh may wait this long for a radio window
 #define TICKER_SCROLL_MS 30
 #define TICKER_Y         148
 #define TICKER_H         16
@@ -89,10 +111,61 @@ extern const char* SPOTIFY_CLIENT_SECRET;
 #define DEFAULT_TICKERS  "NVDA,LMT,PLTR,BTC,XMR,ETH"
 
 // ── Timing ───────────────────────────────────────────────
-#define POLL_MS      1000
+#define POLL_MS      1000     // tight cadence: near track end, after user activity
 #define POLL_IDLE_MS 5000
+#define POLL_MID_MS        5000   // mid-track, local progress interpolation covers the gap
+#define POLL_PAUSED_MS     3000   // paused — base for 304 back-off
+#define POLL_MAX_MS       15000   // back-off ceiling on repeated 304s
+#define POLL_LOW_MS       20000   // nothing playing, low power
+#define POLL_END_MARGIN_MS  400   // poll this long after the predicted end of track
+#define POLL_ACTIVITY_MS  10000   // stay tight this long after buttons / web UI use
+#define ACTION_CONFIRM_MS    250  // poll cadence while waiting for an action to show up
+#define ACTION_CONFIRM_MAX_MS 3000  // give up confirming after this long
+#define ACTION_COALESCE_MS   150  // wait this long after the last press to fold a burst
+#define ACTION_QUEUE_LEN      16  // per producer (buttons, web UI)
 #define BAR_MS       500
-#define WIFI_MS      30000
+#define WIFI_RETRY_MIN_MS    1000UL    // first reconnect attempt after a drop
+#define WIFI_RETRY_MAX_MS   60000UL    // reconnect backoff ceiling
+#define WIFI_FAST_TIMEOUT_MS  3000UL   // directed connect before falling back to a scan
+#define WARM_SAVE_MS          2000UL   // RTC copy of the warm-boot state
+#define WARM_FLASH_MS   (15UL * 60 * 1000)  // flash copy / cover file, at most this often
+#define WARM_FLASH_FIRST_MS  60000UL   // ...and not before this much uptime
+#define WARM_PLAYBACK_MAX_S  3600      // older playback comes back as idle
+
+// ── Radio batching (radio.cpp) ───────────────────────────
+#define RADIO_TAIL_MS     200UL               // radio counted awake this long after a packet
+#define BATCH_WINDOW_MS  2000UL               // deferrable work joins traffic this recent
+#define NTP_RESYNC_MS    (60UL * 60 * 1000)   // clock resync, batched
+#define NTP_SLACK_MS     (15UL * 60 * 1000)
+#define NTP_BACKSTOP_MS  (6UL * 60 * 60 * 1000)   // lwIP's own SNTP timer, if no window comes
+
+// ── Background scheduler (sched.cpp) ─────────────────────
+// Per job class: how long it may wait once due, and how long it may run
+#define JOB_ACTION_DEADLINE_MS     50
+#define JOB_POLL_DEADLINE_MS      250
+#define JOB_ART_DEADLINE_MS      2000
+#define JOB_TICKER_DEADLINE_MS   5000
+#define JOB_HOUSE_DEADLINE_MS   10000
+#define JOB_ACTION_BUDGET_MS     6000
+#define JOB_POLL_BUDGET_MS       4000
+#define JOB_ART_BUDGET_MS       10000   // a full handshake to the CDN
+#define JOB_TICKER_BUDGET_MS     5000   // a quote may queue behind a few others
+#define JOB_HOUSE_BUDGET_MS      5000
+#define JOB_BUDGET_MIN_MS        1000   // floor for a transfer deadline from a spent budget
+#define SCHED_MAX_JOBS             12
+#define SCHED_IDLE_MS              50   // longest sleep between passes at full power
+#define SCHED_NEVER          LONG_MAX   // due(): nothing pending
+#define DNS_CHECK_MS             1000   // DNS pre-resolution looks for work this often
+#define ART_PREWARM_LEAD_MS     20000   // open the art CDN session this long before a track ends
+#define ART_FETCH_MS            10000   // deadline of one cover download
+#define ART_RETRY_MS            30000   // before a failed cover is tried again
+
+// ── Power (power.cpp) ────────────────────────────────────
+#define PWR_IDLE_MS     (2UL * 60 * 1000)   // nothing playing this long -> low power
+#define PWR_CPU_MIN_MHZ  80                 // DFS floor (APB stays at 80 MHz)
+#define PWR_LOOP_IDLE_MS 10                 // loop() pause in low power, screen on (ticker steps are 30 ms)
+#define PWR_LOOP_OFF_MS  20                 // ...screen off: buttons only
+#define PWR_BG_MS        250                // background loop pause in low power
 
 // ── Serial telemetry TUI ─────────────────────────────────
 // When enabled, all log output is suppressed and a fixed-frame
@@ -111,19 +184,68 @@ extern const char* SPOTIFY_CLIENT_SECRET;
   #define LOGP(x)     Serial.print(x)
 #endif
 
-// Per-category byte counters (accumulated across session).
-// HTTPClient doesn't expose wire bytes, so TX uses URL+body+header estimate
-// and RX uses getSize() for the body plus a fudge for response headers.
-#define REQ_HDR_EST  200
-#define RESP_HDR_EST 250
+// Per-category byte counters (accumulated across session). HttpClient
+// credits exact HTTP bytes, headers and chunk framing included (the TLS
+// record overhead is not counted). rxDecoded is what the parsers saw:
+// equal to rxBytes unless a body came gzip-encoded. Atomic: core 1
+// (TUI, web UI) reads them while core 0 credits them.
 struct NetStats {
-  uint32_t txBytes;
-  uint32_t rxBytes;
+  std::atomic<uint32_t> txBytes{0};
+  std::atomic<uint32_t> rxBytes{0};
+  std::atomic<uint32_t> rxDecoded{0};
 };
 extern NetStats netSpotify;   // playback polling + token refresh
 extern NetStats netArt;       // album art CDN
 extern NetStats netTicker;    // CoinGecko + Finnhub
 
+// ── Wi-Fi link (network.cpp) ─────────────────────────────
+enum WifiState : uint8_t { WIFI_UP, WIFI_DOWN, WIFI_CONNECTING };
+struct WifiStats {
+  WifiState     state;
+  uint32_t      drops;
+  uint32_t      attempts;       // reconnects issued
+  uint8_t       lastReason;     // wifi_err_reason_t of the last drop
+  unsigned long lastOutageMs;
+  unsigned long downMs;         // session total, current outage included
+  unsigned long bootIpMs;       // millis() when the boot connect finished
+  bool          bootFast;       // ...via the cached BSSID/lease
+};
+
+// ── Power modes (power.cpp) ──────────────────────────────
+enum PowerSupport : uint8_t { PWR_MODEM_ONLY, PWR_DFS, PWR_LIGHT_SLEEP };
+struct PowerStats {
+  PowerSupport  support;      // what this build's sdkconfig allows
+  bool          low;
+  bool          usbAwake;     // light sleep held off for the USB console
+  uint32_t      cpuMhz;
+  uint32_t      entries;      // times low power was entered
+  unsigned long lowMs;        // session total, current stretch included
+};
+
+// ── Radio duty cycle (radio.cpp) ─────────────────────────
+enum BatchJob : uint8_t { JOB_TICKERS, JOB_TOKEN, JOB_NTP, JOB_DNS, JOB_COUNT };
+struct RadioStats {
+  uint32_t activeMsHour;    // rolling last 60 minutes
+  uint32_t wakesHour;       // bursts in the same window
+  uint32_t batched;         // deferrable jobs run inside a window
+  uint32_t alone;           // ...that had to wake the radio themselves
+};
+
+// ── Background jobs (sched.cpp) ──────────────────────────
+// Highest priority first
+enum JobClass : uint8_t { JC_ACTION, JC_POLL, JC_ART, JC_TICKERS, JC_HOUSEKEEP, JC_COUNT };
+typedef long (*JobDue)();   // ms until due; 0 or less: due (overdue by -n)
+typedef bool (*JobRun)();   // false: yielded, stays queued
+struct JobStats {
+  uint32_t runs;
+  uint32_t lastWaitMs;      // due -> started
+  uint32_t avgWaitMs;       // moving average
+  uint32_t maxWaitMs;
+  uint32_t late;            // waited past the class deadline
+  uint32_t over;            // ran past the class budget
+  uint32_t yielded;         // stepped aside for a higher class
+};
+
 // ── Colors (RGB565) ──────────────────────────────────────
 #define COLOR_DIM_GREY   0x7BEF
 #define COLOR_DARK_GREY  0x4208
@@ -138,10 +260,15 @@ extern NetStats netTicker;    // CoinGecko + Finnhub
 #define RFLAG_PLAY_CHANGED   (1 << 2)
 #define RFLAG_GONE_IDLE      (1 << 3)
 #define RFLAG_GONE_ACTIVE    (1 << 4)
-#define RFLAG_TICKER_READY   (1 << 5)
+#define RFLAG_FRESH          (1 << 5)   // first poll answered (warm-boot state is stale)
+#define RFLAG_ART            (1 << 6)   // a cover was delivered (artDeliver)
 
-// ── Button actions (set by core 1, consumed by core 0) ──
-enum PendingAction { ACTION_NONE, ACTION_SKIP, ACTION_PREV, ACTION_PLAY, ACTION_PAUSE };
+// ── Playback actions (queued by core 1 / web UI, sent by core 0) ──
+enum PendingAction { ACTION_NONE, ACTION_SKIP, ACTION_PREV, ACTION_PLAY, ACTION_PAUSE,
+                     ACTION_SEEK, ACTION_VOLUME };
+// Each source has its own SPSC ring, so each may only queue from one task
+enum ActionSource  { SRC_BUTTON,    // loop() on core 1
+                     SRC_WEB };     // config web server task
 
 // ── CoinGecko crypto mapping ────────────────────────────
 struct CryptoMap { const char* sym; const char* id; };
@@ -163,14 +290,33 @@ struct TickerItem {
   bool  isCommodity;
 };
 
+// Ticker list snapshot as published by core 0
+struct TickerList {
+  TickerItem items[MAX_TICKERS];
+  int        count;
+};
+
+// Price providers, fetched side by side through the reactor (ticker.cpp)
+enum TickerProvider : uint8_t { TP_COINGECKO, TP_FINNHUB, TP_COUNT };
+struct TickerStats {
+  uint32_t lastMs;    // last refresh, first request to last answer
+  uint32_t avgMs;     // moving average
+  uint32_t maxMs;
+  uint32_t runs;
+  uint8_t  got;       // prices current after the last refresh (new or 304)
+  uint8_t  asked;     // ...of this many on the list for this provider
+};
+
 // ── Playback state ──────────────────────────────────────
+// Fixed-size buffers (no String) so snapshots can be published
+// lock-free through a SeqLock and copied with memcpy.
 struct Playback {
-  String trackId;
-  String track;
-  String artist;
-  String album;
-  String device;
-  String imgUrl;
+  char   trackId[24]  = "";
+  char   track[128]   = "";
+  char   artist[96]   = "";
+  char   album[128]   = "";
+  char   device[64]   = "";
+  char   imgUrl[96]   = "";
   bool   playing  = false;
   bool   active   = false;
   int    progress = 0;
@@ -178,9 +324,28 @@ struct Playback {
   unsigned long pollTime = 0;
 };
 
+// ── Warm-boot state (warmstate.cpp) ─────────────────────
+// Shown, marked stale, until the first poll answers. Times are wall
+// clock so they survive a reset; 0 means the clock wasn't set.
+struct WarmState {
+  Playback   playback;                  // progress as of savedAt
+  TickerList tickers;
+  char       token[ACCESS_TOKEN_MAX];   // RTC copy only
+  time_t     tokenExpires;
+  time_t     savedAt;
+};
+enum WarmSource : uint8_t { WARM_NONE, WARM_RTC, WARM_FLASH };
+struct WarmStats {
+  WarmSource source;
+  long       ageS;          // of what was restored; -1 unknown
+  bool       art;           // cover came from flash
+  uint32_t   rtcSaves;
+  uint32_t   flashSaves;
+  uint32_t   artSaves;
+};
+
 // ── Global objects ──────────────────────────────────────
 extern TFT_eSPI    tft;
-extern Spotify*    sp;
 extern OneButton   topBtn;
 extern OneButton   botBtn;
 extern Preferences prefs;
@@ -190,10 +355,15 @@ extern uint8_t       screenRotation;
 extern bool          screenOn;
 extern uint8_t       brightPlay;
 extern uint8_t       brightIdle;
-extern Playback      now;
-extern SemaphoreHandle_t dataMutex;
 extern float         cpuTempC;
 
+// Published snapshots (written by core 0 only, read lock-free anywhere)
+extern SeqLock<Playback>   playbackPub;
+extern SeqLock<TickerList> tickerPub;
+extern Playback            view;        // core 1's copy of playbackPub
+extern TickerList          tickerView;  // core 1's copy of tickerPub
+extern bool                viewStale;   // core 1: screen shows warm-boot state
+
 // Title scroll
 extern TFT_eSprite   titleSpr;
 extern int           scrollX;
@@ -206,7 +376,8 @@ extern bool          scrollPaused;
 extern unsigned long lastClock;
 extern String        lastTimeStr;
 
-// Ticker
+// Ticker (tickerItems/numTickers/stockApiKey are core 0's working copy,
+// written on core 0 under ticker.cpp's lock)
 extern TFT_eSprite   tickerSpr;
 extern TickerItem    tickerItems[MAX_TICKERS];
 extern int           numTickers;
@@ -217,16 +388,18 @@ extern bool          tickerReady;
 extern String        stockApiKey;
 
 // Threading
-extern volatile uint32_t      redrawFlags;
-extern volatile PendingAction  pendingAction;
+extern std::atomic<uint32_t>  redrawFlags;
 extern volatile bool           tickerListChanged;
 extern volatile bool           settingsChanged;
+extern volatile bool           tlsBenchRequested;
 
 // ── Function declarations ───────────────────────────────
 // display.cpp
 bool onJpgBlock(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bmp);
-void showAlbumArt(const String& url);
-void stopAlbumArtClient();
+void artDeliver(const char* url, uint8_t* jpg, size_t len);   // core 0, takes the buffer
+bool artHave(const char* url);       // delivered or on screen
+bool showAlbumArt(const char* url);  // core 1: false if the cover isn't here yet
+bool showCachedArt(const char* url);
 String fitText(const String& s, int maxPx);
 void drawIcon(bool playing);
 void drawBar(int progress, int duration);
@@ -241,9 +414,11 @@ void showStatus(const char* line1, const char* line2 = nullptr);
 // ticker.cpp
 const char* getCoinGeckoId(const char* sym);
 const char* getCommodityFinnhubSymbol(const char* sym);
-void loadTickers();
-void fetchCryptoPrices();
-void fetchStockPrices();
+void loadTickers();      // list and stock key from NVS; drops in-flight results
+void publishTickers();
+void tickerRefresh();    // start both providers' requests; a no-op while a refresh runs
+bool tickerBusy();
+void tickerStats(TickerProvider p, TickerStats& out);
 void recalcTickerWidth();
 int  drawTickerItemsAt(int startX);
 void drawTicker();
@@ -251,8 +426,51 @@ void drawTicker();
 // network.cpp
 String runOAuthFlow();
 void startConfigServer();
-void ensureWiFi();
 void checkSerialInput();
+bool wifiFastConnect(); // directed connect from the cached BSSID/channel/lease
+void wifiSaveLease();   // remember the current association and DHCP lease
+void wifiBegin();       // after the first connect: driver events take over
+bool wifiService();     // core 0, every pass; true right after the link came back
+bool wifiUp();
+void wifiStats(WifiStats& out);
+
+// warmstate.cpp
+time_t     warmNow();                      // wall clock; 0 until it has been set
+WarmSource warmLoad(WarmState& out);       // RTC after a reset, else flash
+void       warmSave(const WarmState& s);   // core 0: RTC now, flash when due
+void       warmMountArt();                 // core 0; formats the partition on first use
+bool       warmSaveArt(const char* url, const uint8_t* jpg, size_t len);   // core 1
+uint8_t*   warmLoadArt(const char* url, size_t& len);   // core 1; caller frees
+void       warmStats(WarmStats& out);
+
+// radio.cpp
+void radioTouch();      // a packet went out or came in
+bool radioAwake();      // traffic within BATCH_WINDOW_MS
+// Deferrable work `overdueMs` past due (negative: not yet). True if it
+// should run now: inside a window, or alone once it has waited `slackMs`.
+bool batchRun(BatchJob job, long overdueMs, unsigned long slackMs);
+void radioStats(RadioStats& out);
+
+// sched.cpp (core 0 unless noted)
+void          schedBegin();                 // from the background task
+void          schedAdd(JobClass cls, const char* name, JobDue due, JobRun run);
+unsigned long schedPass();                  // run what is due; ms until the next due time
+void          schedWait(unsigned long ms);  // sleep, unless woken first
+void          schedWake();                  // any task: new work for core 0
+uint32_t      schedBudget();                // ms left for the running job (a transfer deadline)
+bool          schedPreempted();             // a higher class would run next
+const char*   schedClassName(JobClass c);
+void          schedStats(JobClass c, JobStats& out);   // any task
+
+// power.cpp
+void powerBegin();                              // setup(): PM, locks, GPIO wake
+void powerUpdate(bool screenOn, bool playing);  // core 1, every pass
+void powerNoteActivity();                       // buttons / web UI
+bool powerLow();
+void powerStats(PowerStats& out);
 
 // main.cpp (shared helpers)
-String buildSpotifyBasicAuth();  // returns "Basic <base64(CLIENT_ID:SECRET)>"
+void buildSpotifyBasicAuth(char* out, size_t n);  // "Basic <base64(CLIENT_ID:SECRET)>"
+void notePollActivity();         // user touched buttons / web UI — poll tightly for a while
+// Hand a control verb to core 0; false if that source's queue is full
+bool queueAction(PendingAction action, int arg = 0, ActionSource src = SRC_BUTTON);
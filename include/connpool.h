@@ -0,0 +1,104 @@
+#pragma once
+// ============================================================
+//  Keep-alive TLS connection pool
+// ============================================================
+//  One place that owns every HTTPS connection, keyed by host.
+//  A caller leases a slot (TlsClient + HttpClient), runs its
+//  request(s) and hands it back; the socket stays open for the
+//  next lease to the same host.
+//
+//  Each open TLS session pins internal heap: ~40 KB with every
+//  mbedTLS buffer internal, much less once they go to PSRAM. The
+//  pool charges each session what the TLS allocator measured for
+//  it (POOL_TLS_CTX_BYTES until there is a measurement) and
+//  enforces POOL_HEAP_BUDGET: before a lease that needs a
+//  new handshake it closes idle sessions, lowest priority first
+//  and least recently used within a priority, and refuses the lease
+//  if that isn't enough. A host already leased over HTTP/2 with a
+//  stream to spare shares that session: the slot is leased once more
+//  and the request becomes another stream on it. Otherwise a host
+//  already leased gets a second slot and session, budgeted like any
+//  other. Idle sockets are
+//  probed before they are handed out, so a connection the server
+//  closed while idle is replaced up front instead of failing the
+//  request.
+// ============================================================
+
+#include <Arduino.h>
+#include "tlsclient.h"
+#include "httpclient.h"
+
+#define POOL_SLOTS          5
+#define POOL_TLS_CTX_BYTES  (40 * 1024)   // internal heap per session before one is measured
+#define POOL_HEAP_BUDGET    (3 * POOL_TLS_CTX_BYTES)
+#define POOL_HEAP_RESERVE   (24 * 1024)   // internal heap to leave free after a handshake
+#define POOL_IDLE_MAX_MS    (4UL * 60 * 1000)   // close idle sessions older than this
+
+// Higher wins when the budget forces an eviction
+enum ConnPriority : uint8_t { PRIO_TICKER, PRIO_ART, PRIO_SPOTIFY };
+
+struct PoolConn {
+  TlsClient     client;
+  HttpClient    http{client};
+  char          host[TLS_HOST_MAX];
+  ConnPriority  prio;
+  uint8_t       leased;     // leases holding it; more than one share its h2 session
+  unsigned long lastUsed;
+  uint32_t      leases;
+};
+
+// Lease a connection to `host`. If a new handshake is needed and the
+// budget is full, idle sessions of equal or lower priority are closed;
+// with `mayEvict` false, or with none to close, the lease fails
+// instead. With `mayShare` the lease may be a stream on a session
+// another lease holds; only a caller that writes requests and reads
+// its own response back (the reactor) can live with that. nullptr if
+// no slot or no room.
+PoolConn* poolAcquire(const char* host, ConnPriority prio, bool mayEvict = true,
+                      bool mayShare = false);
+
+// Return a lease. With `keep` false the session is closed (its TLS
+// session stays cached for resumption), once no other lease shares it.
+void poolRelease(PoolConn* c, bool keep = true);
+
+// The network link went away: close every idle session now, and each
+// leased one when it is released (its socket is dead either way).
+void poolInvalidate();
+
+// ── Telemetry ──
+struct PoolSlotInfo {
+  char          host[TLS_HOST_MAX];
+  ConnPriority  prio;
+  bool          open;
+  uint8_t       leased;      // leases holding it (several: a shared h2 session)
+  unsigned long idleMs;
+  uint32_t      leases;
+};
+struct PoolStats {
+  PoolSlotInfo slots[POOL_SLOTS];
+  int          count;
+  int          open;
+  uint32_t     evictions;
+  uint32_t     deadProbes;   // idle sockets found closed before reuse
+  uint32_t     deferred;     // leases refused: no slot, or no room in the budget
+  uint32_t     shared;       // leases that became a stream on a leased h2 session
+};
+void poolStats(PoolStats& out);
+
+// Scoped lease — releases on every return path
+class PoolLease {
+ public:
+  PoolLease(const char* host, ConnPriority prio, bool mayEvict = true)
+    : c_(poolAcquire(host, prio, mayEvict)) {}
+  ~PoolLease() { if (c_) poolRelease(c_, keep_); }
+  PoolLease(const PoolLease&) = delete;
+  PoolLease& operator=(const PoolLease&) = delete;
+
+  explicit operator bool() const { return c_ != nullptr; }
+  PoolConn* operator->() const  { return c_; }
+  void closeOnRelease()         { keep_ = false; }
+
+ private:
+  PoolConn* c_;
+  bool      keep_ = true;
+};
@@ -0,0 +1,52 @@
+#pragma once
+// ============================================================
+//  DNS cache with pre-resolution
+// ============================================================
+//  WiFi.hostByName() blocks every reconnect on a lookup and hides
+//  the record's TTL. This cache asks the Wi-Fi DNS server itself
+//  (one UDP A query), keeps the answer for its TTL, and lets the
+//  background loop re-resolve hosts that are in use before their
+//  entry runs out, so a connect after an idle close goes straight
+//  to TCP. If a lookup fails, an expired address is still served
+//  (serve-stale) rather than failing the request; a TCP connect
+//  that fails drops the entry instead.
+// ============================================================
+
+#include <Arduino.h>
+#include "tlsclient.h"
+
+#define DNS_CACHE_SLOTS      8
+#define DNS_QUERY_TIMEOUT_MS 2000
+#define DNS_TTL_MIN_S        10       // floor, so a 0-TTL record isn't re-queried per connect
+#define DNS_TTL_MAX_S        3600
+#define DNS_TTL_FALLBACK_S   60       // answers from hostByName() carry no TTL
+#define DNS_REFRESH_LEAD_MS  15000    // re-resolve this long before expiry
+#define DNS_WARM_MS          (15UL * 60 * 1000)   // stop refreshing hosts unused this long
+#define DNS_RETRY_MS         10000    // between failed background lookups of one host
+
+// Cached address of `host`, resolving on a miss. `lookupMs` gets the
+// time spent on the network (0 for a hit). False if nothing usable.
+bool dnsResolve(const char* host, IPAddress& ip, uint16_t* lookupMs = nullptr);
+
+// The address didn't take a TCP connection; look it up again next time
+void dnsForget(const char* host);
+
+// Register a host to be resolved ahead of its first connect
+void dnsPin(const char* host);
+
+// Background loop: at most one lookup per call, for the in-use host
+// closest to expiry. Returns true if it went to the network.
+bool dnsRefresh();
+
+// ── Telemetry ──
+struct DnsStats {
+  uint32_t hits;
+  uint32_t misses;        // connect-path lookups
+  uint32_t prefetched;    // background lookups
+  uint32_t failed;
+  uint32_t stale;         // expired addresses served after a failed lookup
+  uint8_t  entries;
+};
+void dnsStats(DnsStats& out);
+// Seconds left on `host`'s entry; -1 if none, 0 once expired
+long dnsTtlLeft(const char* host);
@@ -0,0 +1,140 @@
+#pragma once
+// ============================================================
+//  HTTP/2 session under HttpClient
+// ============================================================
+//  When a TLS connection negotiates "h2" through ALPN, HttpClient
+//  hands its requests to this session instead of writing HTTP/1.1
+//  text. The request head HttpClient formatted is turned into an
+//  HPACK block on a new stream. Responses are demultiplexed by
+//  stream: each one's decoded headers and body land in its own slot,
+//  so requests written back to back (HttpClient's pipelining API)
+//  are answered concurrently and read off in any order.
+//
+//  Each stream's receive window equals its body buffer, so the
+//  server can never send more than fits. The window is credited
+//  back as the caller reads. Request bodies keep to the server's
+//  windows in turn: DATA waits for its WINDOW_UPDATEs, and a stream
+//  whose window stays shut past the deadline is reset. A body nobody wants is cancelled with
+//  RST_STREAM; with HTTP/1.1 its connection would have to close.
+//  PING and SETTINGS are answered whenever the socket is read, idle
+//  probes included. After a GOAWAY the session takes no new streams,
+//  and the connection is closed once the last one ends.
+//
+//  A session lives in PSRAM (about 75 KB). Without PSRAM, "h2" is
+//  never offered, and the connection stays on HTTP/1.1.
+// ============================================================
+
+#include <Arduino.h>
+#include <Client.h>
+#include "hpack.h"
+
+class TlsClient;
+class H2Conn;
+
+#define H2_STREAMS        4        // open streams per session (our MAX_CONCURRENT_STREAMS)
+#define H2_STREAM_WINDOW  8192     // per-stream receive window, which is also its body buffer
+#define H2_FRAME_MAX      16384    // largest frame accepted (the protocol minimum)
+#define H2_BLOCK_MAX      4096     // one header block, sent or received
+#define H2_HDR_KEEP       1024     // decoded response headers kept per stream
+#define H2_HDR_VAL_MAX    160      // longer header values are cut
+#define H2_ENC_TABLE      1024     // HPACK table we fill in the server's decoder
+#define H2_DEC_TABLE      4096     // the server's table in ours (the protocol default)
+#define H2_BODY_MAX       65535    // request body, sent as the server's windows allow
+
+// A stream's response body as a Client, so HttpBody reads it like a
+// socket: available() pulls in frames that have arrived, and
+// connected() turns false once END_STREAM is in and the buffer is
+// empty
+class H2Body : public Client {
+ public:
+  void bind(H2Conn* conn, int slot) { conn_ = conn; slot_ = slot; }
+
+  int     connect(IPAddress, uint16_t) override    { return 0; }
+  int     connect(const char*, uint16_t) override  { return 0; }
+  size_t  write(uint8_t) override                  { return 0; }
+  size_t  write(const uint8_t*, size_t) override   { return 0; }
+  int     available() override;
+  int     read() override;
+  int     read(uint8_t* buf, size_t size) override;
+  int     peek() override                          { return -1; }
+  void    flush() override                         {}
+  void    stop() override                          {}
+  uint8_t connected() override;
+  operator bool() override                         { return connected(); }
+
+ private:
+  H2Conn* conn_ = nullptr;
+  int     slot_ = -1;
+};
+
+class H2Conn {
+ public:
+  static H2Conn* create();   // in PSRAM; nullptr if there is none
+  static void    destroy(H2Conn* c);
+
+  // Client preface and SETTINGS on a connection that just negotiated h2
+  bool start(TlsClient& c);
+  bool bound(const TlsClient& c) const;   // started on c's current connection
+  bool usable() const;                    // may open streams (no GOAWAY, no error)
+  int  room() const;                      // streams open() would take now
+
+  // Send a request formatted as HTTP/1.1 text ("GET /p HTTP/1.1\r\n
+  // Host: h\r\n..." without the blank line) on a new stream. The body
+  // may wait for flow-control credit until `deadline`. Returns the
+  // stream's slot or an HTTP_ERR_*; `wire` gets the bytes written.
+  int  open(const char* head, size_t headLen, const uint8_t* body, size_t len,
+            bool sized, unsigned long deadline, uint32_t& wire);
+
+  // Wait for the final response head on `slot`; false on timeout,
+  // reset or a dead session
+  bool waitHead(int slot, unsigned long deadline);
+  // The same without waiting: 1 once the head is in, 0 while it is
+  // still on its way, -1 if it never will be
+  int  pollHead(int slot);
+  int  status(int slot) const;
+  // Walk the kept response headers; `pos` starts at 0
+  bool header(int slot, size_t& pos, const char*& name, const char*& value) const;
+  Client&  body(int slot);
+  uint32_t headWire(int slot) const;      // HEADERS frames, framing included
+
+  // Done with a stream: reset it if its body isn't finished, and free
+  // the slot. Returns the other bytes received for it (DATA frames and
+  // the connection frames that arrived meanwhile).
+  uint32_t close(int slot);
+
+  // Idle connection: read and answer what arrived (PING, SETTINGS,
+  // GOAWAY) without blocking. False if the session is unusable.
+  bool service();
+
+ private:
+  friend class H2Body;
+  struct Stream;
+  struct Work;
+
+  bool     pump();
+  void     dispatch();
+  void     onHeaders(uint32_t sid, bool endStream);
+  bool     sendFrame(uint8_t type, uint8_t flags, uint32_t sid, const uint8_t* p, size_t n);
+  void     sendWindow(uint32_t sid, uint32_t n);
+  void     fatal(uint32_t err, const char* why);
+  void     consumed(int slot, size_t n);
+  Stream*  find(uint32_t sid);
+  static void onField(const char* name, const char* value, void* ctx);
+
+  TlsClient* c_ = nullptr;
+  Work*      w_ = nullptr;
+};
+
+// ── Telemetry ──
+struct H2Stats {
+  uint32_t sessions;
+  uint32_t streams;
+  uint8_t  maxOpen;       // most streams open at once
+  uint32_t cancelled;     // bodies reset by us instead of read
+  uint32_t resets;        // RST_STREAM from the server
+  uint32_t goaways;
+  uint32_t errors;        // sessions we ended on a protocol error
+  uint32_t headRaw;       // request heads as HTTP/1.1 text...
+  uint32_t headWire;      // ...and as HPACK blocks
+};
+void h2Stats(H2Stats& out);
@@ -0,0 +1,89 @@
+#pragma once
+// ============================================================
+//  HPACK (RFC 7541) header compression for the HTTP/2 client
+// ============================================================
+//  The decoder takes the server's header blocks: static and dynamic
+//  table references, literals and Huffman-coded strings, and table
+//  size updates. The encoder builds our request heads. It indexes
+//  every field it sends, so a repeated poll goes out as a few
+//  one-byte table references. The Authorization header is the bulk
+//  of a request, and it is one of those. The encoder never
+//  Huffman-codes: that saves little on a request this size.
+//
+//  Both tables live in caller-provided storage, so a session can put
+//  them in PSRAM. Nothing here allocates.
+// ============================================================
+
+#include <Arduino.h>
+
+#define HPACK_STATIC_COUNT  61
+#define HPACK_ENTRY_EXTRA   32     // RFC 7541 §4.1 per-entry overhead
+#define HPACK_ENTRIES_MAX   128    // 4096-byte table of the smallest entries
+
+// Called once per decoded field; both strings are NUL-terminated and
+// only valid during the call
+typedef void (*HpackFieldFn)(const char* name, const char* value, void* ctx);
+
+// Dynamic table. Entries sit back to back in `buf`, oldest first;
+// eviction moves the start, and the live ones are slid down when
+// the end runs out of room.
+class HpackTable {
+ public:
+  void     init(uint8_t* buf, uint16_t cap);
+  void     setMax(uint16_t max);     // evicts down to it
+  uint16_t max() const   { return max_; }
+  uint16_t count() const { return n_; }
+  void     add(const char* name, uint16_t nl, const char* value, uint16_t vl);
+  // Entry i, 0 = newest
+  void     get(uint16_t i, const char*& name, uint16_t& nl,
+               const char*& value, uint16_t& vl) const;
+
+ private:
+  void evict();
+
+  uint8_t* buf_   = nullptr;
+  uint16_t cap_   = 0;
+  uint16_t max_   = 0;
+  uint16_t size_  = 0;     // RFC size (lengths + 32 each)
+  uint16_t start_ = 0, end_ = 0;
+  uint16_t off_[HPACK_ENTRIES_MAX];
+  uint8_t  first_ = 0;     // oldest entry in off_
+  uint8_t  n_     = 0;
+};
+
+class HpackDecoder {
+ public:
+  // `limit` is what we announced as SETTINGS_HEADER_TABLE_SIZE; the
+  // scratch holds one decoded name and value
+  void init(uint8_t* table, uint16_t limit, char* scratch, uint16_t scratchLen);
+  // One complete header block. False on a compression error: the
+  // table can't be trusted after that, nor can the connection.
+  bool decode(const uint8_t* p, size_t n, HpackFieldFn fn, void* ctx);
+
+ private:
+  bool lookup(uint32_t index, const char*& name, uint16_t& nl,
+              const char*& value, uint16_t& vl) const;
+
+  HpackTable table_;
+  uint16_t   limit_ = 0;
+  char*      scr_   = nullptr;
+  uint16_t   scrLen_ = 0;
+};
+
+class HpackEncoder {
+ public:
+  void init(uint8_t* table, uint16_t size);
+  // The peer's SETTINGS_HEADER_TABLE_SIZE; we use at most `size` from
+  // init(), and announce the change at the start of the next block
+  void peerLimit(uint32_t limit);
+  // Start a block (a pending size update); bytes written, 0 if no room
+  size_t begin(uint8_t* out, size_t cap);
+  // Append one field (lower-case name); bytes written, 0 if no room
+  size_t field(uint8_t* out, size_t cap, const char* name, const char* value);
+
+ private:
+  HpackTable table_;
+  uint16_t   size_     = 0;
+  uint16_t   want_     = 0;
+  bool       announce_ = false;
+};
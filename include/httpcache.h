@@ -0,0 +1,60 @@
+#pragma once
+// ============================================================
+//  HTTP response cache (validators only)
+// ============================================================
+//  Keyed by host + path. Stores what is needed to avoid a request
+//  or its body: ETag, Last-Modified and the max-age from
+//  Cache-Control. Bodies are not kept, because every fetcher
+//  already holds what it parsed out of the last 200. So a 304, or
+//  a copy still inside max-age, just means "keep what you have".
+//
+//  HttpClient drives it (see HttpClient::useCache()). Whoever
+//  throws away parsed state must forget the URL too, or the next
+//  304 would confirm data that no longer exists.
+// ============================================================
+
+#include <Arduino.h>
+
+#define HTTP_CACHE_SLOTS     12
+#define HTTP_CACHE_ETAG_MAX  80
+#define HTTP_CACHE_DATE_MAX  32     // "Sun, 06 Nov 1994 08:49:37 GMT"
+
+struct HttpCacheEntry {
+  uint32_t      key;                // 0 = empty
+  char          etag[HTTP_CACHE_ETAG_MAX];
+  char          lastModified[HTTP_CACHE_DATE_MAX];
+  unsigned long storedAt;           // millis() of the last 200/304
+  uint32_t      maxAgeMs;
+  uint32_t      bodyBytes;          // wire size of the last full body
+};
+
+uint32_t httpCacheKey(const char* host, const char* path);
+
+// True if `key` is still inside its max-age (counted as a hit)
+bool httpCacheFresh(uint32_t key);
+// Copy of the entry's validators; false if there is no entry
+bool httpCacheLookup(uint32_t key, HttpCacheEntry& out);
+
+// After a complete 200. `cacheControl` may be null; no-store forgets.
+void httpCacheStore(uint32_t key, const char* etag, const char* lastModified,
+                    const char* cacheControl, uint32_t age, uint32_t bodyBytes);
+// After a 304: restart the max-age clock, count the saved body
+void httpCacheNotModified(uint32_t key, const char* cacheControl, uint32_t age);
+
+void httpCacheForget(uint32_t key);
+void httpCacheForget(const char* host, const char* path);
+void httpCacheClear();
+
+// Warm boot: entries with validators, out to RTC memory and back into
+// an empty cache. Imported entries always revalidate.
+int  httpCacheExport(HttpCacheEntry* out, int max);
+void httpCacheImport(const HttpCacheEntry* in, int n);
+
+// ── Telemetry ──
+struct HttpCacheStats {
+  uint32_t fresh;          // requests skipped inside max-age
+  uint32_t notModified;    // 304s
+  uint32_t avoidedBytes;   // body bytes neither sent nor parsed
+  uint8_t  entries;
+};
+void httpCacheStats(HttpCacheStats& out);
@@ -0,0 +1,299 @@
+#pragma once
+// ============================================================
+//  Minimal HTTP/1.1 client
+// ============================================================
+//  Used by every fetch path instead of Arduino HTTPClient. The
+//  request is formatted into a fixed buffer. The status line and
+//  the headers the caller asked for land in a fixed table. The
+//  body is a bounded Stream (Content-Length, chunked or
+//  read-to-close) that never reads past its own end, so a
+//  keep-alive or pipelined connection is always left at the start
+//  of the next response. Every byte written and read is counted,
+//  framing included, no estimates.
+//
+//  With acceptGzip() a gzip body is inflated on the fly between the
+//  socket and the caller (ROM tinfl, 32 KB window in PSRAM), and
+//  both the wire and the decoded byte counts are reported.
+//
+//  If the connection negotiated "h2", the same calls run over an
+//  HTTP/2 session (h2conn.h): each request becomes a stream, and the
+//  head formatted here is sent as HPACK. Pipelined requests are
+//  answered concurrently and can be read as they arrive (next()),
+//  and end() cancels an unread body instead of closing the socket.
+//
+//  send() and readHead() wait for the head. The reactor never waits:
+//  it calls pollHead() when the socket has data, then reads body()
+//  until bodyDone(). Everything a response needs from its request
+//  (cache entry, gzip, HEAD, stats) is queued with the request, so a
+//  new request can be built while an HTTP/2 response is still being
+//  read.
+// ============================================================
+
+#include <Arduino.h>
+#include <Client.h>
+#include "httpcache.h"
+#include "tlsclient.h"
+
+#define HTTP_REQ_MAX       1024   // request line + headers
+#define HTTP_HOST_MAX      40
+#define HTTP_LINE_MAX      160    // response lines are truncated past this
+#define HTTP_HDR_SLOTS     4      // collected response headers
+#define HTTP_HDR_VAL_MAX   80
+#define HTTP_TIMEOUT_MS    10000
+#define HTTP_DRAIN_MAX     4096   // unread body end() will skip to keep the socket
+#define HTTP_INFLATE_IN    512    // compressed bytes staged per inflate step
+#define HTTP_PIPELINE_MAX  8      // requests in flight whose responses use the cache
+
+// Negative results from send() / readHead()
+#define HTTP_ERR_CONNECT   -1
+#define HTTP_ERR_SEND      -2
+#define HTTP_ERR_READ      -3     // no status line (timeout, closed, garbage)
+#define HTTP_ERR_TOO_LONG  -4     // request didn't fit HTTP_REQ_MAX
+
+struct NetStats;
+class H2Conn;
+
+// Response body. available() never reports bytes past the end of the
+// body; chunk framing is consumed as it arrives and never blocks.
+class HttpBody : public Stream {
+ public:
+  explicit HttpBody(Client& c) : c_(&c) {}
+
+  void from(Client& c) { c_ = &c; }         // the socket, or an HTTP/2 stream
+  void reset(long length, bool chunked);   // length -1: until close, 0: none
+
+  int    available() override;
+  int    read() override;
+  size_t readBytes(char* buf, size_t n) override;
+  int    peek() override            { return -1; }
+  size_t write(uint8_t) override    { return 0; }
+  void   flush() override           {}
+
+  bool done() const                 { return state_ == DONE; }
+  bool untilClose() const           { return state_ == TO_CLOSE; }
+  bool cut();                       // the connection closed before the end
+  uint32_t rx = 0;                  // bytes taken off the socket
+
+ private:
+  enum State : uint8_t { SIZE, SIZE_EXT, DATA, DATA_END, TRAILER, TO_CLOSE, DONE };
+  void taken(size_t n);
+  void step(int ch);
+
+  Client* c_;
+  long    left_     = 0;
+  long    chunkLen_ = 0;
+  uint8_t lineLen_  = 0;
+  bool    chunked_  = false;
+  State   state_    = DONE;
+};
+
+// Streaming gzip decoder over an HttpBody. The deflate window doubles
+// as the output buffer, so decoded bytes are handed out straight from
+// it; nothing is copied twice.
+class HttpInflate : public Stream {
+ public:
+  explicit HttpInflate(HttpBody& src) : src_(src) {}
+
+  bool ready();   // allocate the work area (PSRAM) on first use
+  void reset();
+
+  int    available() override;
+  int    read() override;
+  size_t readBytes(char* buf, size_t n) override;
+  int    peek() override            { return -1; }
+  size_t write(uint8_t) override    { return 0; }
+  void   flush() override           {}
+
+  bool failed() const               { return state_ == FAILED; }
+  bool done() const                 { return state_ == DONE && outPos_ == outEnd_; }
+  uint32_t out = 0;                 // decoded bytes handed out
+
+ private:
+  enum State : uint8_t { HDR, HDR_XLEN, HDR_EXTRA, HDR_NAME, HDR_COMMENT, HDR_CRC,
+                         INFLATE, TRAILER, DONE, FAILED };
+  struct Work;
+  bool fill();
+  bool header(uint8_t b);
+
+  HttpBody& src_;
+  Work*     w_       = nullptr;
+  State     state_   = DONE;
+  uint8_t   flags_   = 0;      // gzip FLG byte
+  uint16_t  need_    = 0;      // bytes left in the current header field
+  uint16_t  xlen_    = 0;      // FEXTRA length
+  uint16_t  inPos_   = 0, inLen_  = 0;
+  uint16_t  outPos_  = 0, outEnd_ = 0;   // unread decoded bytes in the window
+  uint16_t  winOfs_  = 0;                // where the next output goes
+};
+
+class HttpClient {
+ public:
+  explicit HttpClient(TlsClient& c) : c_(c), body_(c), inflate_(body_) {}
+
+  // Response headers to keep (the names must outlive the client).
+  // Content-Length, Transfer-Encoding, Connection and Retry-After are
+  // always parsed.
+  void collect(const char* const* names, uint8_t count);
+  void setTimeout(uint32_t ms) { timeoutMs_ = ms; }
+
+  // ── Request ──
+  // Exact wire bytes go to `stats`: requests when written, responses
+  // as their head and body are consumed.
+  void begin(const char* method, const char* host, const char* path,
+             NetStats* stats = nullptr);
+  void header(const char* name, const char* value);
+  void headerf(const char* name, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+  // Ask for a gzip body (after begin). A no-op without PSRAM for the window.
+  void acceptGzip();
+  // Go through the response cache (after begin). True if the copy the
+  // caller parsed last time is still inside max-age: skip the request.
+  // Otherwise the cached validators are sent, a 304 refreshes the entry
+  // and a complete 200 replaces it.
+  bool useCache();
+
+  // write() + readHead(). A reused keep-alive socket that turns out to
+  // be dead before any response byte is reconnected and sent once more.
+  int  send(const uint8_t* body = nullptr, size_t len = 0);
+  int  send(const char* body) { return send((const uint8_t*)body, strlen(body)); }
+
+  // Pipelining: begin() + write() several requests, then readHead() +
+  // end() each response in order. write() returns 0 or an HTTP_ERR_*.
+  int  write(const uint8_t* body = nullptr, size_t len = 0);
+  int  readHead();
+  // readHead() without the wait: 0 until the whole head is in. The
+  // response timeout is then the caller's.
+  int  pollHead();
+  // HTTP/2 answers in any order. stream() names the request just
+  // written; next() puts its response first in line for pollHead() and
+  // abort(), ahead of older ones still on their way. False while
+  // another response is being read, or if it isn't pending.
+  int8_t stream() const;
+  bool   next(int8_t stream);
+  // A byte of the last response arrived, even if its head then failed.
+  // A reused socket that fails without one was closed by the server
+  // before it saw the request, which may go out again.
+  bool answered() const { return rx_ > 0; }
+
+  // The connection can take another request without connecting first.
+  // An HTTP/2 session the server is winding down (GOAWAY) is closed
+  // here once nothing is in flight on it.
+  bool connected();
+  // Streams this connection's HTTP/2 session could open right now
+  // (0 on HTTP/1.1), for the pool to share it between leases
+  int  h2Room() const;
+
+  // ── Response ──
+  int         status() const        { return status_; }
+  long        contentLength() const { return length_; }   // -1 if not given
+  const char* header(const char* name) const;             // nullptr if absent
+  bool        gzipped() const       { return gzipped_; }
+  uint32_t    retryAfter() const    { return retryAfter_; }   // seconds, 0 if none
+  // The caller couldn't use this body; keep a later 304 from vouching for it
+  void        discard();
+  Stream&     body()                { return gzipped_ ? (Stream&)inflate_ : (Stream&)body_; }
+  // For a caller reading the body as it arrives: all of it has been
+  // handed out (decoded, if gzip), or the rest will never come
+  bool        bodyDone() const      { return gzipped_ ? inflate_.done() : body_.done(); }
+  bool        bodyCut()             { return (gzipped_ && inflate_.failed()) || body_.cut(); }
+
+  // Finish the exchange: skip what is left of a short body, credit the
+  // traffic, and close the socket if it can't carry another request.
+  // Returns true if the connection stays open.
+  bool end();
+  // Give up on the response being read, or else the next one due: an
+  // HTTP/2 stream is reset, an HTTP/1.1 connection closed (the rest
+  // of its response can't be skipped without reading it)
+  void abort();
+
+  // Idle-connection probe for the pool (see TlsClient::alive()). An
+  // HTTP/2 session is serviced instead: the frames a server sends
+  // while idle are answered, not taken for a dead socket.
+  bool alive();
+
+  // Free the HTTP/2 session (~75 KB of PSRAM). The pool calls it when
+  // the slot moves to another host; write() does it once the
+  // connection has fallen back to HTTP/1.1.
+  void releaseH2();
+
+ private:
+  // What a response needs from the request it answers
+  struct Pending {
+    uint32_t  key;      // cache entry (0 = not cached)
+    int8_t    slot;     // HTTP/2 stream, -1 on HTTP/1.1
+    bool      gzip;     // Accept-Encoding: gzip sent
+    bool      noBody;   // HEAD
+    NetStats* stats;
+  };
+
+  bool append(const char* s);
+  void queue(int8_t slot);
+  void dropPipeline() { pendCount_ = 0; }
+  void startHead();
+  void newHead();
+  int  lineIn();
+  void onHeader(const char* name, const char* v);
+  void firstByte();
+  int  headH2();
+  int  headDone();
+  int  fail(int err);
+  bool h2Alloc();
+  int  writeH2(const uint8_t* body, size_t len);
+
+  TlsClient&  c_;
+  HttpBody    body_;
+  HttpInflate inflate_;
+  char        req_[HTTP_REQ_MAX];
+  size_t      reqLen_    = 0;
+  bool        overflow_  = false;
+  bool        active_    = false;   // response head read, body not finished
+  bool        noBody_    = false;   // HEAD
+  bool        sized_     = false;   // always send Content-Length (POST/PUT)
+  bool        wantGzip_  = false;   // Accept-Encoding: gzip added
+  bool        gzipped_   = false;   // this response is gzip-encoded
+  bool        cache_     = false;   // useCache() on the request being built
+  uint32_t    key_       = 0;       // cache key of the request being built
+
+  // Written requests, oldest first
+  Pending     pend_[HTTP_PIPELINE_MAX];
+  uint8_t     pendHead_  = 0;
+  uint8_t     pendCount_ = 0;
+  char        host_[HTTP_HOST_MAX] = "";
+  NetStats*   stats_     = nullptr;   // of the request being built
+  H2Conn*     h2_        = nullptr;   // created on the first "h2" connection
+  int8_t      slot_      = -1;        // stream of the response being read
+  unsigned long sentAt_  = 0;       // first unanswered write, for time to first byte
+  uint32_t    timeoutMs_ = HTTP_TIMEOUT_MS;
+
+  // Response being read; its head arrives a line at a time
+  NetStats*   respStats_ = nullptr;
+  bool        respGzip_  = false;   // gzip was asked for
+  bool        respNoBody_ = false;  // answers a HEAD
+  bool        heading_   = false;   // head started, not finished
+  char        line_[HTTP_LINE_MAX];
+  uint16_t    lineLen_   = 0;
+  bool        chunked_   = false;
+  bool        encGzip_   = false;   // Content-Encoding: gzip
+  int         status_    = 0;
+  long        length_    = -1;
+  bool        closing_   = false;   // server sent Connection: close
+  uint32_t    retryAfter_ = 0;      // Retry-After (delta-seconds form)
+  uint32_t    rx_        = 0;       // status line + headers of this response
+
+  // Cache metadata of this response
+  uint32_t    respKey_   = 0;
+  uint32_t    respAge_   = 0;
+  char        respEtag_[HTTP_CACHE_ETAG_MAX];
+  char        respLastMod_[HTTP_CACHE_DATE_MAX];
+  char        respCC_[48];
+
+  const char* const* want_ = nullptr;
+  uint8_t     wantCount_   = 0;
+  struct Hdr { const char* name; char value[HTTP_HDR_VAL_MAX]; };
+  Hdr         hdrs_[HTTP_HDR_SLOTS];
+  uint8_t     hdrCount_    = 0;
+};
+
+// Split an https:// URL: copy the host part, point at the path
+void        urlHost(const char* url, char* out, size_t n);
+const char* urlPath(const char* url);
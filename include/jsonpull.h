@@ -0,0 +1,46 @@
+#pragma once
+// ============================================================
+//  Zero-allocation streaming JSON field extractor
+// ============================================================
+//  Walks one JSON value straight off a Stream and writes a
+//  declared set of paths into caller-owned buffers / numbers.
+//  No DOM, no heap — the only state is a small read buffer and
+//  the current path on the stack.
+//
+//  Paths use dots for object keys and [n] for array indices:
+//    "progress_ms", "item.artists[0].name", "bitcoin.usd"
+//  Subtrees that no declared path can reach are skipped with a
+//  bracket counter instead of being tokenised.
+// ============================================================
+
+#include <Arduino.h>
+
+#define JSON_PATH_MAX   96    // longest path tracked while walking
+#define JSON_DEPTH_MAX  16    // deepest nesting accepted
+
+enum JsonFieldType : uint8_t { JF_STR, JF_INT, JF_FLOAT, JF_BOOL };
+
+struct JsonField {
+  const char*   path;
+  JsonFieldType type;
+  void*         dst;
+  uint16_t      cap;     // JF_STR only: buffer size including NUL
+  bool          found;
+};
+
+inline JsonField jsonStr(const char* path, char* buf, size_t cap) {
+  if (cap) buf[0] = 0;
+  return { path, JF_STR, buf, (uint16_t)cap, false };
+}
+inline JsonField jsonInt(const char* path, int* v)     { return { path, JF_INT,   v, 0, false }; }
+inline JsonField jsonFloat(const char* path, float* v) { return { path, JF_FLOAT, v, 0, false }; }
+inline JsonField jsonBool(const char* path, bool* v)   { return { path, JF_BOOL,  v, 0, false }; }
+
+// Parse exactly one JSON value from `in`, filling any fields whose path
+// matches. Fields that never appear keep their current value with
+// found == false. Returns false on malformed input or if the stream
+// stalls for longer than `timeoutMs`.
+bool jsonExtract(Stream& in, JsonField* fields, size_t count,
+                 uint32_t timeoutMs = 5000);
+// The same over a body already in memory (a reactor transfer's)
+bool jsonExtract(const uint8_t* buf, size_t len, JsonField* fields, size_t count);
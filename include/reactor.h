@@ -0,0 +1,107 @@
+#pragma once
+// ============================================================
+//  Transfer reactor: every HTTP request of the background task
+// ============================================================
+//  A transfer is one request whose connect, handshake, head and
+//  body each move on only when its socket is ready. The background
+//  task waits in a select() over the sockets of every transfer in
+//  flight instead of sleeping, then steps each one as far as the
+//  bytes at hand allow. Nothing here waits on the network: a cold
+//  handshake, a slow server or a long body holds up neither the
+//  scheduler nor the other transfers.
+//
+//  Connections come from the pool. A transfer to a host whose
+//  HTTP/2 session is busy becomes another stream on it if one is
+//  free; otherwise it takes a second slot. FETCH_PIPELINE transfers
+//  ride the connection of an earlier transfer to the same host
+//  instead (Finnhub's one-quote-per-request API, or a poll behind the
+//  verb it confirms). Responses on an HTTP/1.1 connection are read in
+//  the order the requests went out; on HTTP/2 as each head arrives.
+//
+//  Each transfer has its own deadline; past it the transfer fails.
+//  One still queued behind another response on its connection is
+//  reported at once and dropped when its turn comes. A request that
+//  went out on a kept-alive socket the server had already closed
+//  (no response byte before the close) is sent once more on a new
+//  one, and so are pipelined requests that were still waiting when
+//  their connection went down.
+//
+//  The OAuth code exchange (network.cpp) and the TLS benchmark stay
+//  blocking: both run once, at the user's request.
+// ============================================================
+
+#include <Arduino.h>
+#include "connpool.h"
+#include "breaker.h"
+
+#define REACTOR_SLOTS      16
+#define REACTOR_SLICE_MS   10       // longest select() while transfers are in flight
+#define REACTOR_BODY_MAX   300000   // bytes; larger bodies are not kept
+#define REACTOR_BODY_CHUNK 2048     // first buffer for a body of unknown length
+#define REACTOR_HEAP_KEEP  16000    // internal heap left free when PSRAM can't take a body
+
+// FetchReq::flags
+#define FETCH_NO_EVICT  0x01   // don't close another session to make room
+#define FETCH_CLOSE     0x02   // close the session afterwards (rarely used hosts)
+#define FETCH_PIPELINE  0x04   // share a connection with an earlier transfer to the host
+
+struct NetStats;
+class HttpClient;
+
+// Adds headers after HttpClient::begin(). Runs again if the request
+// is re-sent on a new connection.
+typedef void (*FetchHeaders)(HttpClient& http, void* ctx);
+
+// Called on the reactor's task when a transfer ends. code is the HTTP
+// status or an HTTP_ERR_* (HTTP_ERR_READ for a cut-off body or a
+// missed deadline). The body, if there was one and it fit within
+// REACTOR_BODY_MAX, is in `body` and belongs to the callee (free()
+// it); otherwise `body` is nullptr. A gzip body arrives decoded.
+typedef void (*FetchDone)(int code, uint8_t* body, size_t len, void* ctx);
+
+// The path, method and body must outlive the transfer (the host is copied)
+struct FetchReq {
+  const char*  host;
+  const char*  path;
+  const char*  method;       // nullptr: GET
+  const char*  body;         // nullptr: none
+  ConnPriority prio;
+  Endpoint     ep;
+  NetStats*    stats;
+  uint32_t     deadlineMs;
+  uint8_t      flags;        // FETCH_*
+  FetchHeaders headers;      // may be nullptr
+};
+
+// Start a transfer. False if no slot is free, the endpoint's breaker
+// is open or the pool has no connection for it; `done` is then never
+// called. Otherwise `done` is called exactly once, from reactorRun().
+bool fetchRequest(const FetchReq& req, FetchDone done, void* ctx = nullptr);
+
+// GET `url` (kept by the caller) within `deadlineMs`
+bool fetchStart(const char* url, ConnPriority prio, Endpoint ep, NetStats* stats,
+                uint32_t deadlineMs, FetchDone done, void* ctx = nullptr);
+
+// Open a session to `host` ahead of its first request, if the pool
+// has room without evicting anything. Nothing is reported back.
+bool fetchPrewarm(const char* host, ConnPriority prio);
+
+bool fetchBusy();   // any transfer in flight
+
+// Wait up to `waitMs` (at most REACTOR_SLICE_MS) for one of the
+// sockets, then step every transfer that can move. Returns at once
+// if a socket is already readable or a transfer was just started.
+void reactorRun(uint32_t waitMs);
+
+// ── Telemetry ──
+struct ReactorStats {
+  uint8_t  live;
+  uint32_t done;        // answered (any status)
+  uint32_t failed;      // no answer: connect, send or read error
+  uint32_t late;        // dropped at their deadline
+  uint32_t retries;     // re-sent after the connection went down unanswered
+  uint32_t steps;       // passes that moved a transfer
+  uint32_t lastMs;      // duration of the last answered transfer
+  uint32_t lastBytes;
+};
+void reactorStats(ReactorStats& out);
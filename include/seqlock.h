@@ -0,0 +1,65 @@
+#pragma once
+// ============================================================
+//  Double-buffered seqlock — lock-free snapshot publication
+// ============================================================
+//  One writer task publishes plain-old-data snapshots; any number
+//  of readers (other core, web handlers, TUI) copy out a consistent
+//  view without ever blocking. The writer always fills the slot
+//  readers are NOT using, so a reader preempted by — or running on
+//  the same core as — the writer never spins on a half-written copy.
+//
+//  The sequence counter is odd while a write is in flight; the
+//  generation (seq / 2) lets consumers skip work when nothing new
+//  has been published.
+//
+//  T must be trivially copyable (no String members).
+// ============================================================
+
+#include <atomic>
+#include <string.h>
+#include <stdint.h>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock<T> requires a trivially copyable snapshot type");
+
+ public:
+  // Writer side — must only ever be called from a single task.
+  void publish(const T& v) {
+    uint32_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slots_[(s / 2 + 1) & 1], &v, sizeof(T));
+    seq_.store(s + 2, std::memory_order_release);
+  }
+
+  // Copy the latest stable snapshot into `out`. Returns its generation.
+  uint32_t read(T& out) const {
+    while (true) {
+      uint32_t s1 = seq_.load(std::memory_order_acquire) & ~1u;
+      memcpy(&out, &slots_[(s1 / 2) & 1], sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint32_t s2 = seq_.load(std::memory_order_relaxed);
+      // The slot we copied is only rewritten by the publish *after* next,
+      // which moves the counter to s1 + 3. Anything below that is intact.
+      if (s2 - s1 < 3) return s1 / 2;
+    }
+  }
+
+  // Copy only if a newer generation than `gen` exists; updates `gen`.
+  bool readIfNewer(T& out, uint32_t& gen) const {
+    if (generation() == gen) return false;
+    gen = read(out);
+    return true;
+  }
+
+  uint32_t generation() const {
+    return seq_.load(std::memory_order_acquire) / 2;
+  }
+
+ private:
+  T                     slots_[2] = {};
+  std::atomic<uint32_t> seq_{0};
+};
@@ -0,0 +1,62 @@
+#pragma once
+// ============================================================
+//  Single-producer / single-consumer ring buffer
+// ============================================================
+//  Lock-free hand-off of small records from one task to another
+//  (e.g. button presses on core 1 → network task on core 0).
+//  Exactly one task may push and exactly one task may pop.
+//  A full ring rejects the push rather than overwriting, so the
+//  producer can count the drop.
+//
+//  N must be a power of two; T must be trivially copyable.
+// ============================================================
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+template <typename T, size_t N>
+class SpscRing {
+  static_assert((N & (N - 1)) == 0, "SpscRing<T, N> requires N to be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SpscRing<T, N> requires a trivially copyable record type");
+
+ public:
+  // Producer side. Returns false (and stores nothing) when full.
+  bool push(const T& v) {
+    uint32_t h = head_.load(std::memory_order_relaxed);
+    if (h - tail_.load(std::memory_order_acquire) >= N) return false;
+    slots_[h & (N - 1)] = v;
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Oldest record without removing it, or nullptr.
+  const T* front() const {
+    uint32_t t = tail_.load(std::memory_order_relaxed);
+    if (t == head_.load(std::memory_order_acquire)) return nullptr;
+    return &slots_[t & (N - 1)];
+  }
+
+  // Consumer side. Returns false when empty.
+  bool pop(T& out) {
+    const T* f = front();
+    if (!f) return false;
+    out = *f;
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when called from a third task; exact for either end.
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t capacity() { return N; }
+
+ private:
+  T                     slots_[N] = {};
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+};
@@ -0,0 +1,223 @@
+#pragma once
+// ============================================================
+//  TLS client with per-host session resumption
+// ============================================================
+//  Drop-in WiFiClient under HttpClient. Unlike
+//  WiFiClientSecure it keeps the negotiated session of every host
+//  it has talked to, so reconnecting after an idle close or a
+//  token refresh resumes in one round trip (no key exchange, no
+//  certificate chain) instead of running a full handshake.
+//
+//  The offer is ordered for the ESP32-S3: ECDHE-ECDSA before
+//  ECDHE-RSA, AES-GCM first (hardware AES + SHA), X25519/P-256,
+//  TLS 1.2. Certificates are not verified — the same trust model
+//  as setInsecure() everywhere else in this firmware.
+//
+//  Every handshake is timed into a per-host histogram, and the last
+//  connect is split into DNS, TCP, TLS and first response byte.
+//
+//  connect() blocks until the handshake is over. The reactor uses
+//  connectStart() / connectStep() instead: the same connect, moved on
+//  a step at a time whenever select() says the socket is ready.
+//
+//  Hosts marked with tlsOfferH2() are offered "h2" ahead of
+//  "http/1.1" through ALPN; h2() tells HttpClient which one the
+//  server picked.
+//
+//  mbedTLS allocates through tlsAllocInstall()'s allocator, which
+//  places each block by a policy (internal RAM, PSRAM, or split by
+//  size) and charges it to the client that asked for it. The pool
+//  budgets sessions from those numbers instead of an estimate, and
+//  every handshake is timed per policy.
+// ============================================================
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+#include <atomic>
+
+#define TLS_HOST_SLOTS            8      // hosts with a cached session + stats
+#define TLS_HOST_MAX              40     // longest host name tracked
+#define TLS_CONNECT_TIMEOUT_MS    5000   // TCP connect, when the caller gives none
+#define TLS_HANDSHAKE_TIMEOUT_MS  10000
+#define TLS_HIST_BUCKETS          6      // see TLS_HIST_EDGES_MS
+#define TLS_ALLOC_SPLIT_MIN       1024   // TLS_ALLOC_SPLIT: blocks this big go to PSRAM
+
+// Upper bucket edges in ms; the last bucket is everything above
+extern const uint16_t TLS_HIST_EDGES_MS[TLS_HIST_BUCKETS - 1];
+
+// Where mbedTLS memory goes. Small blocks are the bignums of the key
+// exchange and the hash and cipher contexts touched on every record;
+// large ones are the two ~16 KB record buffers, the server's
+// certificate chain and the handshake state. The AES driver bounces
+// PSRAM buffers through its own internal DMA memory, so nothing here
+// has to be DMA-capable.
+enum TlsAllocPolicy : uint8_t {
+  TLS_ALLOC_INTERNAL,   // everything internal (the IDF default)
+  TLS_ALLOC_SPLIT,      // blocks of TLS_ALLOC_SPLIT_MIN and up in PSRAM
+  TLS_ALLOC_PSRAM,      // everything in PSRAM
+  TLS_ALLOC_POLICIES
+};
+
+// Per-host handshake statistics (copied out by tlsHostStats)
+struct TlsHostStats {
+  char     host[TLS_HOST_MAX];
+  uint16_t full;            // full handshakes
+  uint16_t resumed;         // abbreviated handshakes
+  uint16_t failed;
+  uint16_t lastMs;          // TLS handshake
+  uint16_t dnsMs;           // of the last connect (0 = cache hit)
+  uint16_t tcpMs;
+  uint16_t ttfbMs;          // request written -> status line
+  bool     lastResumed;
+  bool     h2;              // last connect negotiated HTTP/2
+  uint32_t fullMsSum;
+  uint32_t resumedMsSum;
+  uint16_t hist[TLS_HIST_BUCKETS];
+};
+
+enum TlsStep : uint8_t { TLS_STEP_PENDING, TLS_STEP_DONE, TLS_STEP_FAILED };
+
+class TlsClient : public WiFiClient {
+ public:
+  TlsClient();
+  ~TlsClient();
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(IPAddress ip, uint16_t port, int32_t timeout) override;
+  int connect(const char* host, uint16_t port) override;
+  int connect(const char* host, uint16_t port, int32_t timeout) override;
+
+  using WiFiClient::write;
+  size_t  write(uint8_t b) override;
+  size_t  write(const uint8_t* buf, size_t size) override;
+  int     available() override;
+  int     read() override;
+  int     read(uint8_t* buf, size_t size) override;
+  int     peek() override;
+  void    flush() override;
+  void    stop() override;
+  uint8_t connected() override;
+
+  // Certificates are never verified; kept so call sites read like WiFiClientSecure
+  void setInsecure() {}
+
+  bool resumed() const { return resumed_; }   // last handshake was abbreviated
+  bool h2() const      { return h2_; }        // the server chose "h2" through ALPN
+  // Counts successful connects, so state kept for one connection can
+  // tell it is looking at a newer one
+  uint32_t epoch() const { return epoch_; }
+
+  // Idle-connection probe: true if the socket is open and nothing
+  // unexpected (FIN, close_notify, stray bytes) arrived since the last
+  // response. Never blocks.
+  bool alive();
+
+  // Non-blocking connect. connectStart() takes the address from the
+  // DNS cache (resolving only on a miss) and starts the TCP connect;
+  // connectStep() takes it, then the handshake, as far as the socket
+  // allows. Call it when fd() is readable, or writable while
+  // wantWrite(). There is no timeout here: the caller gives up with
+  // stop().
+  bool    connectStart(const char* host, uint16_t port);
+  TlsStep connectStep();
+  bool    connecting() const { return phase_ != CONN_IDLE; }
+  bool    wantWrite() const  { return phase_ == CONN_TCP || wantWrite_; }
+
+  // For a caller that select()s over several connections: the socket
+  // (-1 when closed), and whether decrypted bytes are already waiting
+  // where select() can't see them
+  int  fd() const { return connected_ || connecting() ? net_.fd : -1; }
+  bool buffered() const {
+    return connected_ && (peek_ >= 0 || mbedtls_ssl_get_bytes_avail(&ssl_) > 0);
+  }
+
+  // mbedTLS memory this client holds (0 if the allocator isn't ours)
+  struct Mem {
+    std::atomic<uint32_t> internal{0};
+    std::atomic<uint32_t> psram{0};
+    uint32_t              peak = 0;   // internal, since the handshake began
+  };
+  uint32_t memInternal() const { return mem_.internal; }
+  uint32_t memPsram() const    { return mem_.psram; }
+
+ private:
+  enum ConnPhase : uint8_t { CONN_IDLE, CONN_TCP, CONN_TLS };
+
+  int  open(IPAddress ip, uint16_t port, const char* host, int32_t timeoutMs);
+  bool tcpStart(IPAddress ip, uint16_t port, const char* host);
+  void tcpFailed();
+  bool handshakeSetup();
+  bool handshakeDone(int ret);
+  bool waitIo(bool forWrite, int32_t timeoutMs);
+
+  Mem                 mem_;
+  mbedtls_ssl_context ssl_;
+  mbedtls_ssl_config  conf_;
+  mbedtls_net_context net_;
+  bool ready_     = false;   // ssl_/conf_ hold allocations
+  bool connected_ = false;
+  bool closed_    = false;   // peer sent close_notify / FIN
+  bool resumed_   = false;
+  bool h2_        = false;
+  int  peek_      = -1;
+  uint32_t epoch_ = 0;
+  uint16_t dnsMs_ = 0;       // phases of the connect in progress
+  uint16_t tcpMs_ = 0;
+  // Connect in progress
+  ConnPhase      phase_     = CONN_IDLE;
+  bool           wantWrite_ = false;   // the handshake waits to send
+  bool           offered_   = false;   // a cached session was offered
+  TlsAllocPolicy policy_    = TLS_ALLOC_INTERNAL;
+  unsigned long  phaseAt_   = 0;
+  char           host_[TLS_HOST_MAX] = "";
+  unsigned char  master_[sizeof(mbedtls_ssl_session::master)];
+};
+
+// Offer HTTP/2 to `host` on its next connects (off by default; also
+// turned off again if the client can't run a session)
+void tlsOfferH2(const char* host, bool on);
+
+// Drop a host's cached session (next connect does a full handshake)
+void tlsForgetSession(const char* host);
+
+// Time to first response byte, from HttpClient (ignored for unknown hosts)
+void tlsNoteFirstByte(const char* host, unsigned long ms);
+
+// Copy per-host stats into `out`; returns the number of hosts filled
+int tlsHostStats(TlsHostStats* out, int max);
+
+// ── mbedTLS allocator ──
+// Route mbedTLS's calloc/free through the policy allocator. Call it
+// before anything allocates through mbedTLS (top of setup()):
+// free() expects its own header. False if the build fixes mbedTLS's
+// allocator at compile time; the IDF one then stays, untracked.
+bool           tlsAllocInstall(TlsAllocPolicy policy);
+bool           tlsAllocInstalled();
+// Takes effect for new allocations; live blocks are freed where they are
+void           tlsAllocSetPolicy(TlsAllocPolicy policy);
+TlsAllocPolicy tlsAllocPolicy();
+const char*    tlsAllocName(TlsAllocPolicy policy);
+// Internal heap a new session needs under the current policy: the
+// highest handshake peak seen, or `fallback` before the first one
+uint32_t       tlsSessionCost(uint32_t fallback);
+
+struct TlsPolicyStats {
+  uint16_t full, resumed;
+  uint32_t fullMsSum, resumedMsSum;
+  uint32_t peakInternal;       // most internal heap one handshake used
+  uint32_t residentInternal;   // held by the last session once connected...
+  uint32_t residentPsram;      // ...and in PSRAM
+};
+struct TlsAllocStats {
+  bool           installed;
+  TlsAllocPolicy policy;
+  uint32_t       internal, psram;   // mbedTLS blocks live now
+  uint32_t       peakInternal;
+  uint32_t       fallbacks;         // placed in the other region when the preferred one was full
+  uint32_t       failed;
+  TlsPolicyStats policies[TLS_ALLOC_POLICIES];
+};
+void tlsAllocStats(TlsAllocStats& out);
+void tlsAllocResetStats();   // per-policy handshake figures, before a benchmark
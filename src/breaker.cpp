@@ -0,0 +1,132 @@
+// ============================================================
+//  Per-endpoint circuit breakers (see breaker.h)
+// ============================================================
+
+#include "config.h"
+
+namespace {
+
+struct Breaker {
+  BreakerState  state;
+  uint8_t       failures;
+  uint8_t       level;
+  bool          probing;      // HALF_OPEN probe handed out, not yet reported
+  unsigned long openUntil;
+  unsigned long probeAt;
+  uint32_t      trips;
+  uint32_t      refused;
+  uint32_t      throttled;
+  int           lastCode;
+};
+
+const char* const NAMES[EP_COUNT] = { "Spotify API", "Spotify auth", "Album art",
+                                      "CoinGecko", "Finnhub" };
+
+Breaker           breakers[EP_COUNT];
+StaticSemaphore_t breakerLockBuf;
+SemaphoreHandle_t breakerLock = xSemaphoreCreateMutexStatic(&breakerLockBuf);
+
+struct BreakerGuard {
+  BreakerGuard()  { xSemaphoreTake(breakerLock, portMAX_DELAY); }
+  ~BreakerGuard() { xSemaphoreGive(breakerLock); }
+};
+
+// Transport errors, server errors and throttling; any other answer
+// means the service is up
+bool isFailure(int code) {
+  return code < 0 || code == 429 || code >= 500;
+}
+
+void open(Endpoint ep, Breaker& b, uint32_t retryAfterS) {
+  // "Equal jitter": half the step fixed, half random, so devices that
+  // failed together don't all come back in the same second
+  unsigned long step = min(BREAKER_BASE_MS << min<uint8_t>(b.level, 16), BREAKER_MAX_MS);
+  unsigned long wait = step / 2 + esp_random() % (step / 2 + 1);
+  if (retryAfterS) {
+    wait = max(wait, (unsigned long)min<uint32_t>(retryAfterS, BREAKER_RETRY_MAX_S) * 1000UL);
+  }
+  if (b.state == BREAKER_CLOSED) b.trips++;
+  if (b.level < 16) b.level++;
+  b.state     = BREAKER_OPEN;
+  b.probing   = false;
+  b.openUntil = millis() + wait;
+  LOG("[Breaker] %s open for %lus (HTTP %d)\n", NAMES[ep], wait / 1000, b.lastCode);
+}
+
+}  // namespace
+
+bool breakerAllow(Endpoint ep) {
+  BreakerGuard g;
+  Breaker& b = breakers[ep];
+  unsigned long ms = millis();
+  switch (b.state) {
+    case BREAKER_CLOSED:
+      return true;
+    case BREAKER_OPEN:
+      if ((long)(ms - b.openUntil) < 0) break;
+      b.state = BREAKER_HALF_OPEN;
+      b.probing = false;
+      // fall through
+    case BREAKER_HALF_OPEN:
+      if (b.probing && ms - b.probeAt < BREAKER_PROBE_MS) break;
+      b.probing = true;
+      b.probeAt = ms;
+      LOG("[Breaker] %s probing\n", NAMES[ep]);
+      return true;
+  }
+  b.refused++;
+  return false;
+}
+
+void breakerReport(Endpoint ep, int code, uint32_t retryAfterS) {
+  BreakerGuard g;
+  Breaker& b = breakers[ep];
+  b.lastCode = code;
+  if (code == 429) b.throttled++;
+
+  if (!isFailure(code)) {
+    if (b.state != BREAKER_CLOSED) LOG("[Breaker] %s closed\n", NAMES[ep]);
+    b.state    = BREAKER_CLOSED;
+    b.failures = 0;
+    b.level    = 0;
+    b.probing  = false;
+    return;
+  }
+
+  if (b.failures < 255) b.failures++;
+  switch (b.state) {
+    case BREAKER_CLOSED:
+      // Throttling is explicit; don't wait for more of it
+      if (b.failures >= BREAKER_TRIP || code == 429) open(ep, b, retryAfterS);
+      break;
+    case BREAKER_HALF_OPEN:
+      open(ep, b, retryAfterS);
+      break;
+    case BREAKER_OPEN:
+      // A request that was already in flight; only a longer
+      // Retry-After moves the next probe
+      if (retryAfterS) {
+        unsigned long until = millis() + min<uint32_t>(retryAfterS, BREAKER_RETRY_MAX_S) * 1000UL;
+        if ((long)(until - b.openUntil) > 0) b.openUntil = until;
+      }
+      break;
+  }
+}
+
+void breakerInfo(Endpoint ep, BreakerInfo& out) {
+  BreakerGuard g;
+  const Breaker& b = breakers[ep];
+  long left = (long)(b.openUntil - millis());
+  out.state     = b.state;
+  out.failures  = b.failures;
+  out.level     = b.level;
+  out.retryInMs = (b.state == BREAKER_OPEN && left > 0) ? left : 0;
+  out.trips     = b.trips;
+  out.refused   = b.refused;
+  out.throttled = b.throttled;
+  out.lastCode  = b.lastCode;
+}
+
+const char* endpointName(Endpoint ep) {
+  return ep < EP_COUNT ? NAMES[ep] : "?";
+}
@@ -0,0 +1,218 @@
+// ============================================================
+//  Keep-alive TLS connection pool (see connpool.h)
+// ============================================================
+
+#include "config.h"
+#include <esp_heap_caps.h>
+
+namespace {
+
+PoolConn          slots[POOL_SLOTS];
+bool              slotOpen[POOL_SLOTS];   // session open while idle (pool's view)
+bool              slotStale[POOL_SLOTS];  // leased across poolInvalidate()
+bool              slotClose[POOL_SLOTS];  // a sharer asked for a close; the last release does it
+bool              slotShare[POOL_SLOTS];  // leased with mayShare: others may join its session
+uint32_t          evictions  = 0;
+uint32_t          deadProbes = 0;
+uint32_t          deferred   = 0;
+uint32_t          shared     = 0;
+StaticSemaphore_t poolLockBuf;
+SemaphoreHandle_t poolLock = xSemaphoreCreateMutexStatic(&poolLockBuf);
+
+struct PoolGuard {
+  PoolGuard()  { xSemaphoreTake(poolLock, portMAX_DELAY); }
+  ~PoolGuard() { xSemaphoreGive(poolLock); }
+};
+
+int indexOf(const PoolConn* c) { return (int)(c - slots); }
+
+// Idle open session to close for a `prio` lease: lowest priority, then LRU
+PoolConn* pickVictim(ConnPriority prio, const PoolConn* except) {
+  PoolConn* v = nullptr;
+  for (int i = 0; i < POOL_SLOTS; i++) {
+    PoolConn* s = &slots[i];
+    if (s == except || s->leased || !slotOpen[i] || s->prio > prio) continue;
+    if (!v || s->prio < v->prio ||
+        (s->prio == v->prio && (long)(s->lastUsed - v->lastUsed) < 0)) v = s;
+  }
+  return v;
+}
+
+void closeSlot(PoolConn* s, const char* why) {
+  LOG("[Pool] Close %s (%s)\n", s->host, why);
+  s->http.end();
+  s->client.stop();
+  slotOpen[indexOf(s)] = false;
+}
+
+// Will one more session fit? An idle session counts what it holds in
+// internal heap, once the allocator tracks it. A leased slot counts a
+// full handshake: its client may be mid-handshake on the other core.
+bool budgetFits(const PoolConn* except) {
+  uint32_t cost = tlsSessionCost(POOL_TLS_CTX_BYTES);
+  uint32_t used = 0;
+  for (int i = 0; i < POOL_SLOTS; i++) {
+    if (&slots[i] == except || !(slots[i].leased || slotOpen[i])) continue;
+    used += (tlsAllocInstalled() && !slots[i].leased) ? slots[i].client.memInternal() : cost;
+  }
+  size_t freeInt = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  return used + cost <= POOL_HEAP_BUDGET &&
+         freeInt >= cost + POOL_HEAP_RESERVE;
+}
+
+// A leased HTTP/2 session to `host` that can open one more stream
+PoolConn* shareable(const char* host) {
+  for (int i = 0; i < POOL_SLOTS; i++) {
+    PoolConn* s = &slots[i];
+    if (!s->leased || !slotShare[i] || slotStale[i] || slotClose[i]) continue;
+    if (strcmp(s->host, host)) continue;
+    if (s->leased < H2_STREAMS && s->http.h2Room() > 0) return s;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+PoolConn* poolAcquire(const char* host, ConnPriority prio, bool mayEvict, bool mayShare) {
+  PoolGuard g;
+  unsigned long ms = millis();
+
+  // Servers drop keep-alives after a few idle minutes; don't count on them
+  for (int i = 0; i < POOL_SLOTS; i++) {
+    if (!slots[i].leased && slotOpen[i] && ms - slots[i].lastUsed > POOL_IDLE_MAX_MS) {
+      closeSlot(&slots[i], "idle");
+    }
+  }
+
+  // A slot to this host that is leased stays with its holder: this
+  // lease takes another slot and, below, a second session budgeted
+  // like any other
+  PoolConn* c = nullptr;
+  for (int i = 0; i < POOL_SLOTS; i++) {
+    if (!slots[i].leased && strcmp(slots[i].host, host) == 0) { c = &slots[i]; break; }
+  }
+
+  // ...unless the holder's HTTP/2 session has a stream to spare, which
+  // beats a new handshake: the lease shares it
+  if (mayShare && (!c || !slotOpen[indexOf(c)])) {
+    if (PoolConn* s = shareable(host)) {
+      s->leased++;
+      s->prio     = max(s->prio, prio);
+      s->lastUsed = ms;
+      s->leases++;
+      shared++;
+      return s;
+    }
+  }
+
+  if (c) {
+    // Probe before handing it out rather than failing the request on it
+    int i = indexOf(c);
+    if (slotOpen[i] && !c->http.alive()) {
+      deadProbes++;
+      closeSlot(c, "dead");
+    }
+  } else {
+    // Claim an empty slot, else the oldest closed one, else evict
+    for (int i = 0; i < POOL_SLOTS && !c; i++) {
+      if (!slots[i].leased && !slots[i].host[0]) c = &slots[i];
+    }
+    PoolConn* oldest = nullptr;
+    for (int i = 0; i < POOL_SLOTS && !c; i++) {
+      PoolConn* s = &slots[i];
+      if (s->leased || slotOpen[i]) continue;
+      if (!oldest || (long)(s->lastUsed - oldest->lastUsed) < 0) oldest = s;
+    }
+    if (!c) c = oldest;
+    if (!c) {
+      c = pickVictim(prio, nullptr);
+      if (!c || !mayEvict) {
+        deferred++;
+        LOG("[Pool] No slot for %s\n", host);
+        return nullptr;
+      }
+      evictions++;
+      closeSlot(c, "evicted");
+    }
+    c->http.releaseH2();   // another host may not speak h2
+    strlcpy(c->host, host, sizeof(c->host));
+    c->leases = 0;
+  }
+  c->prio = prio;
+
+  // A handshake is coming — make room within the heap budget. If
+  // nothing idle can give way, the lease waits for one to come back.
+  if (!slotOpen[indexOf(c)]) {
+    while (!budgetFits(c)) {
+      PoolConn* v = pickVictim(prio, c);
+      if (!v || !mayEvict) {
+        deferred++;
+        LOG("[Pool] %s deferred — budget full\n", host);
+        return nullptr;
+      }
+      evictions++;
+      closeSlot(v, "budget");
+    }
+  }
+
+  c->leased   = 1;
+  c->lastUsed = ms;
+  c->leases++;
+  slotShare[indexOf(c)] = mayShare;
+  return c;
+}
+
+void poolRelease(PoolConn* c, bool keep) {
+  if (!c) return;
+  int i = indexOf(c);
+  if (c->leased > 1) {
+    // Other streams are still on the session
+    PoolGuard g;
+    c->leased--;
+    if (!keep) slotClose[i] = true;
+    return;
+  }
+  if (slotStale[i] || slotClose[i]) keep = false;
+  if (!keep) {
+    c->http.end();
+    c->client.stop();
+  }
+  bool open = c->client.connected();
+  PoolGuard g;
+  slotOpen[i]  = open;
+  slotStale[i] = false;
+  slotClose[i] = false;
+  c->leased    = 0;
+  c->lastUsed  = millis();
+}
+
+void poolInvalidate() {
+  PoolGuard g;
+  for (int i = 0; i < POOL_SLOTS; i++) {
+    if (slots[i].leased) slotStale[i] = true;
+    else if (slotOpen[i]) closeSlot(&slots[i], "link lost");
+  }
+}
+
+void poolStats(PoolStats& out) {
+  PoolGuard g;
+  unsigned long ms = millis();
+  out.count = 0;
+  out.open  = 0;
+  for (int i = 0; i < POOL_SLOTS; i++) {
+    const PoolConn& s = slots[i];
+    if (!s.host[0]) continue;
+    PoolSlotInfo& o = out.slots[out.count++];
+    strlcpy(o.host, s.host, sizeof(o.host));
+    o.prio   = s.prio;
+    o.leased = s.leased;
+    o.open   = s.leased || slotOpen[i];
+    o.idleMs = s.leased ? 0 : ms - s.lastUsed;
+    o.leases = s.leases;
+    if (o.open) out.open++;
+  }
+  out.evictions  = evictions;
+  out.deadProbes = deadProbes;
+  out.deferred   = deferred;
+  out.shared     = shared;
+}
@@ -3,7 +3,6 @@
 // ============================================================
 
 #include "config.h"
-#include <esp_task_wdt.h>
 
 // ── TJpg_Decoder block-render callback ──────────────────
 bool onJpgBlock(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bmp) {
@@ -12,98 +11,95 @@ bool onJpgBlock(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bmp) {
   return true;
 }
 
-// ── Persistent TLS client for album art (avoids repeated handshakes) ──
-static WiFiClientSecure artClient;
-static HTTPClient       artHttp;
-static bool             artClientInit = false;
-
-// Tear down the keep-alive TLS socket. Callers use this to free mbedtls
-// memory (~30KB) before opening a new TLS connection elsewhere.
-void stopAlbumArtClient() {
-  if (!artClientInit) return;
-  artHttp.end();
-  artClient.stop();
+// ── Album art ───────────────────────────────────────────
+// Covers are downloaded on core 0 (the "cover" job) and handed over
+// here; core 1 only decodes. The last cover drawn is kept, so a
+// redraw (rotation, the same album again) costs no download.
+namespace {
+
+uint8_t*          mailBuf  = nullptr;   // delivered, not yet taken by core 1
+size_t            mailLen  = 0;
+char              mailUrl[sizeof(Playback::imgUrl)]  = "";
+uint8_t*          coverBuf = nullptr;   // core 1's current cover
+size_t            coverLen = 0;
+char              coverUrl[sizeof(Playback::imgUrl)] = "";
+StaticSemaphore_t artLockBuf;
+SemaphoreHandle_t artLock = xSemaphoreCreateMutexStatic(&artLockBuf);
+
+struct ArtGuard {
+  ArtGuard()  { xSemaphoreTake(artLock, portMAX_DELAY); }
+  ~ArtGuard() { xSemaphoreGive(artLock); }
+};
+
+// Make `buf` the current cover (core 1)
+void keepCover(const char* url, uint8_t* buf, size_t len) {
+  uint8_t* old;
+  {
+    ArtGuard g;
+    old      = coverBuf;
+    coverBuf = buf;
+    coverLen = len;
+    strlcpy(coverUrl, url, sizeof(coverUrl));
+  }
+  free(old);
 }
 
-// ── Download & draw album art JPEG ──────────────────────
-void showAlbumArt(const String& url) {
-  if (url.isEmpty()) return;
-
-  if (!artClientInit) {
-    artClient.setInsecure();
-    artHttp.setReuse(true);  // Keep TCP+TLS connection alive
-    artHttp.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-    artHttp.setTimeout(10000);
-    artClientInit = true;
+// Swap in the delivered cover if it is `url`'s; a stale one waits to
+// be replaced
+bool takeDelivery(const char* url) {
+  uint8_t* buf;
+  size_t   len;
+  {
+    ArtGuard g;
+    if (!mailBuf || strcmp(mailUrl, url) != 0) return false;
+    buf = mailBuf;
+    len = mailLen;
+    mailBuf    = nullptr;
+    mailUrl[0] = 0;
   }
+  keepCover(url, buf, len);
+  return true;
+}
 
-  unsigned long t0 = millis();
-  artHttp.begin(artClient, url);
-  // GET <path> HTTP/1.1 + Host + keep-alive — URL is long but headers are minimal
-  netArt.txBytes += url.length() + REQ_HDR_EST;
-  int code = artHttp.GET();
-  // A kept-alive TLS socket can be closed by the CDN during long idle periods.
-  // Retry once on a fresh connection before giving up.
-  if (code != HTTP_CODE_OK) {
-    LOG("[Art] HTTP %d — retrying fresh (%lums)\n", code, millis() - t0);
-    artHttp.end();
-    artClient.stop();
-    artHttp.begin(artClient, url);
-    netArt.txBytes += url.length() + REQ_HDR_EST;
-    code = artHttp.GET();
-  }
-  if (code != HTTP_CODE_OK) {
-    LOG("[Art] HTTP %d (%lums)\n", code, millis() - t0);
-    artHttp.end();
-    return;
-  }
+}  // namespace
 
-  int len = artHttp.getSize();
-  if (len <= 0 || len > 300000) { artHttp.end(); return; }
-
-  // Prefer PSRAM (8MB on T-Display S3) so we don't fight the ~300KB internal
-  // heap — leaves room for TJpgDec work buffers and TLS. Falls back to
-  // internal heap if PSRAM is absent or exhausted.
-  uint8_t* buf = (uint8_t*)ps_malloc(len);
-  if (!buf) {
-    unsigned heap = ESP.getFreeHeap();
-    if ((unsigned)len + 16000 > heap) {
-      LOG("[Art] Skipping — need %d+16000, heap %u, psram %u\n",
-                    len, heap, (unsigned)ESP.getFreePsram());
-      artHttp.end();
-      return;
-    }
-    buf = (uint8_t*)malloc(len);
-    if (!buf) {
-      LOG("[Art] alloc(%d) failed, heap=%u psram=%u\n",
-                    len, heap, (unsigned)ESP.getFreePsram());
-      artHttp.end();
-      return;
-    }
+void artDeliver(const char* url, uint8_t* jpg, size_t len) {
+  uint8_t* old;
+  {
+    ArtGuard g;
+    old     = mailBuf;   // never taken: a newer cover replaces it
+    mailBuf = jpg;
+    mailLen = len;
+    strlcpy(mailUrl, url, sizeof(mailUrl));
   }
+  free(old);
+  redrawFlags |= RFLAG_ART;
+}
 
-  WiFiClient* stream = artHttp.getStreamPtr();
-  size_t got = 0;
-  unsigned long deadline = millis() + 10000;
-
-  while (got < (size_t)len && millis() < deadline) {
-    size_t avail = stream->available();
-    if (avail) {
-      got += stream->readBytes(buf + got, min(avail, (size_t)(len - got)));
-    } else {
-      delay(10);
-    }
-    esp_task_wdt_reset();
-  }
+bool artHave(const char* url) {
+  ArtGuard g;
+  return strcmp(mailUrl, url) == 0 || strcmp(coverUrl, url) == 0;
+}
 
-  LOG("[Art] %u bytes in %lums\n", got, millis() - t0);
-  netArt.rxBytes += (uint32_t)got + RESP_HDR_EST;
+bool showAlbumArt(const char* url) {
+  if (!url[0]) return false;
+  bool fresh = takeDelivery(url);
+  // coverBuf/coverUrl only change on this core
+  if (!coverBuf || strcmp(coverUrl, url) != 0) return false;
+  TJpgDec.drawJpg(ART_X, ART_Y, coverBuf, coverLen);
+  // Rate-limited inside; a write costs this core a few hundred ms
+  if (fresh) warmSaveArt(url, coverBuf, coverLen);
+  return true;
+}
 
-  if (got == (size_t)len) {
-    TJpgDec.drawJpg(ART_X, ART_Y, buf, len);
-  }
-  free(buf);
-  // Don't call artHttp.end() — keep connection alive for next image
+// ── Last session's cover from flash (warm boot) ─────────
+bool showCachedArt(const char* url) {
+  size_t   len = 0;
+  uint8_t* buf = warmLoadArt(url, len);
+  if (!buf) return false;
+  TJpgDec.drawJpg(ART_X, ART_Y, buf, len);
+  keepCover(url, buf, len);
+  return true;
 }
 
 // ── Truncate string to fit pixel width ──────────────────
@@ -195,12 +191,12 @@ void drawTitle() {
 
   if (titlePixelW <= TXT_W) {
     titleSpr.setCursor(0, TITLE_BL);
-    titleSpr.print(now.track);
+    titleSpr.print(view.track);
   } else {
     titleSpr.setCursor(-scrollX, TITLE_BL);
-    titleSpr.print(now.track);
+    titleSpr.print(view.track);
     titleSpr.setCursor(-scrollX + titlePixelW + SCROLL_GAP, TITLE_BL);
-    titleSpr.print(now.track);
+    titleSpr.print(view.track);
   }
   titleSpr.pushSprite(TXT_X, TITLE_Y);
 }
@@ -234,14 +230,15 @@ void drawIdleClock() {
 void drawInfo() {
   tft.setTextColor(TFT_WHITE, TFT_BLACK);
 
-  if (!now.active) {
+  if (!view.active) {
     tft.fillScreen(TFT_BLACK);
     drawIdleClock();
     // Show config URL
     tft.setTextFont(1);
     tft.setTextColor(COLOR_VERY_DARK, TFT_BLACK);
     tft.setCursor(4, 4);
-    tft.print("http://" + WiFi.localIP().toString());
+    if (viewStale) tft.print("cached");   // no address before Wi-Fi anyway
+    else           tft.print("http://" + WiFi.localIP().toString());
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     drawCpuTemp(CPU_TEMP_IDLE_X, CPU_TEMP_IDLE_Y, cpuTempC, COLOR_DIM_GREY);
     tickerScrollX = 0;
@@ -252,7 +249,7 @@ void drawInfo() {
   tft.fillRect(SEP_X, SEP_TOP, SEP_W, SEP_BOT - SEP_TOP, TFT_WHITE);
 
   tft.setFreeFont(&FreeSansBold9pt8b);
-  titlePixelW = tft.textWidth(now.track);
+  titlePixelW = tft.textWidth(view.track);
   tft.setTextFont(2);
   scrollX = 0;
   scrollPaused = true;
@@ -261,22 +258,24 @@ void drawInfo() {
 
   tft.setFreeFont(&FreeSans8pt8b);
   tft.setCursor(TXT_X, ARTIST_Y + 9);
-  tft.print(fitText(now.artist, TXT_W));
+  tft.print(fitText(view.artist, TXT_W));
 
   tft.setFreeFont(&FreeSans8pt8b);
   tft.setCursor(TXT_X, ALBUM_Y + 9);
-  tft.print(fitText(now.album, TXT_W));
+  tft.print(fitText(view.album, TXT_W));
 
-  if (now.device.length() > 0) {
+  if (view.device[0] || viewStale) {
     tft.setFreeFont(&FreeSans5pt8b);
     tft.setTextColor(COLOR_DIM_GREY, TFT_BLACK);
     tft.setCursor(TXT_X, DEVICE_Y + 7);
-    tft.print(fitText(now.device, TXT_W));
+    // Marked until the first poll confirms or replaces it
+    String dev = viewStale ? String("cached  ") + view.device : String(view.device);
+    tft.print(fitText(dev, TXT_W));
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
   }
 
-  drawIcon(now.playing);
-  drawBar(now.progress, now.duration);
+  drawIcon(view.playing);
+  drawBar(view.progress, view.duration);
   drawCpuTemp(CPU_TEMP_PLAY_X, CPU_TEMP_PLAY_Y, cpuTempC, COLOR_DIM_GREY);
 
   lastTimeStr = "";
@@ -0,0 +1,281 @@
+// ============================================================
+//  DNS cache with pre-resolution (see dnscache.h)
+// ============================================================
+
+#include "config.h"
+#include <lwip/sockets.h>
+#include <esp_system.h>
+
+namespace {
+
+#define DNS_PKT_MAX  512   // plain UDP DNS; an A answer always fits
+
+struct Entry {
+  char          host[TLS_HOST_MAX];
+  IPAddress     ip;
+  bool          has;         // ip is valid (possibly expired)
+  unsigned long expiresAt;
+  unsigned long lastUsed;    // last connect that asked for it
+  unsigned long failedAt;    // last failed background lookup (0 = none)
+};
+
+Entry             entries[DNS_CACHE_SLOTS];
+int               entryCount = 0;
+DnsStats          stats;
+StaticSemaphore_t dnsLockBuf;
+SemaphoreHandle_t dnsLock = xSemaphoreCreateMutexStatic(&dnsLockBuf);
+
+struct DnsGuard {
+  DnsGuard()  { xSemaphoreTake(dnsLock, portMAX_DELAY); }
+  ~DnsGuard() { xSemaphoreGive(dnsLock); }
+};
+
+Entry* find(const char* host) {
+  for (int i = 0; i < entryCount; i++) {
+    if (strcmp(entries[i].host, host) == 0) return &entries[i];
+  }
+  return nullptr;
+}
+
+// Find or claim a slot, recycling the least recently used host
+Entry* claim(const char* host) {
+  Entry* e = find(host);
+  if (e) return e;
+  if (entryCount < DNS_CACHE_SLOTS) {
+    e = &entries[entryCount++];
+  } else {
+    e = &entries[0];
+    for (int i = 1; i < entryCount; i++) {
+      if ((long)(entries[i].lastUsed - e->lastUsed) < 0) e = &entries[i];
+    }
+  }
+  strlcpy(e->host, host, sizeof(e->host));
+  e->has      = false;
+  e->lastUsed = millis();
+  e->failedAt = 0;
+  return e;
+}
+
+void store(const char* host, IPAddress ip, uint32_t ttlS) {
+  Entry* e = claim(host);
+  e->ip        = ip;
+  e->has       = true;
+  e->expiresAt = millis() + constrain(ttlS, (uint32_t)DNS_TTL_MIN_S, (uint32_t)DNS_TTL_MAX_S) * 1000UL;
+  e->failedAt  = 0;
+}
+
+// ── Wire format ─────────────────────────────────────────
+uint16_t be16(const uint8_t* p) { return (uint16_t)(p[0] << 8 | p[1]); }
+
+// Offset just past a (possibly compressed) name; 0 if it runs off the end
+size_t skipName(const uint8_t* p, size_t len, size_t i) {
+  while (i < len) {
+    uint8_t b = p[i];
+    if (b == 0) return i + 1;
+    if ((b & 0xC0) == 0xC0) return i + 2 <= len ? i + 2 : 0;
+    i += b + 1;
+  }
+  return 0;
+}
+
+// First A record of the answer, and the smallest TTL on the way to it
+// (a CNAME that expires sooner bounds the address too)
+bool parseAnswer(const uint8_t* p, size_t len, IPAddress& ip, uint32_t& ttlS) {
+  if (len < 12 || !(p[2] & 0x80) || (p[3] & 0x0F)) return false;   // not a response / RCODE
+  uint16_t qd = be16(p + 4), an = be16(p + 6);
+  size_t   i  = 12;
+  while (qd--) {
+    i = skipName(p, len, i);
+    if (!i || i + 4 > len) return false;
+    i += 4;
+  }
+  uint32_t ttlMin = UINT32_MAX;
+  while (an--) {
+    i = skipName(p, len, i);
+    if (!i || i + 10 > len) return false;
+    uint16_t type  = be16(p + i);
+    uint32_t ttl   = (uint32_t)be16(p + i + 4) << 16 | be16(p + i + 6);
+    uint16_t rdlen = be16(p + i + 8);
+    i += 10;
+    if (i + rdlen > len) return false;
+    ttlMin = min(ttlMin, ttl);
+    if (type == 1 && rdlen == 4) {
+      ip   = IPAddress(p[i], p[i + 1], p[i + 2], p[i + 3]);
+      ttlS = ttlMin;
+      return true;
+    }
+    i += rdlen;
+  }
+  return false;
+}
+
+// One recursive A query to the DNS server Wi-Fi handed out
+bool query(const char* host, IPAddress& ip, uint32_t& ttlS) {
+  IPAddress server = WiFi.dnsIP(0);
+  if ((uint32_t)server == 0) return false;
+
+  uint8_t  pkt[DNS_PKT_MAX];
+  uint16_t id = (uint16_t)esp_random();
+  size_t   n  = 0;
+  pkt[n++] = id >> 8;
+  pkt[n++] = id & 0xFF;
+  pkt[n++] = 0x01;   // RD
+  pkt[n++] = 0x00;
+  pkt[n++] = 0;      // QDCOUNT 1, no other sections
+  pkt[n++] = 1;
+  memset(pkt + n, 0, 6);
+  n += 6;
+  for (const char* p = host; *p;) {
+    const char* dot = strchr(p, '.');
+    size_t      len = dot ? (size_t)(dot - p) : strlen(p);
+    if (!len || len > 63 || n + len + 6 > sizeof(pkt)) return false;
+    pkt[n++] = (uint8_t)len;
+    memcpy(pkt + n, p, len);
+    n += len;
+    p += len;
+    if (*p) p++;
+  }
+  pkt[n++] = 0;
+  pkt[n++] = 0; pkt[n++] = 1;   // QTYPE A
+  pkt[n++] = 0; pkt[n++] = 1;   // QCLASS IN
+
+  int fd = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (fd < 0) return false;
+  struct sockaddr_in sa = {};
+  sa.sin_family      = AF_INET;
+  sa.sin_port        = htons(53);
+  sa.sin_addr.s_addr = (uint32_t)server;
+
+  bool ok = false;
+  radioTouch();
+  if (lwip_sendto(fd, pkt, n, 0, (struct sockaddr*)&sa, sizeof(sa)) == (ssize_t)n) {
+    unsigned long t0 = millis();
+    for (;;) {
+      long left = DNS_QUERY_TIMEOUT_MS - (long)(millis() - t0);
+      if (left <= 0) break;
+      fd_set fds;
+      FD_ZERO(&fds);
+      FD_SET(fd, &fds);
+      struct timeval tv = { (time_t)(left / 1000), (suseconds_t)((left % 1000) * 1000) };
+      if (lwip_select(fd + 1, &fds, nullptr, nullptr, &tv) <= 0) break;
+      ssize_t r = lwip_recvfrom(fd, pkt, sizeof(pkt), 0, nullptr, nullptr);
+      radioTouch();
+      if (r < 12 || be16(pkt) != id) continue;   // late answer to an earlier query
+      ok = parseAnswer(pkt, (size_t)r, ip, ttlS);
+      break;
+    }
+  }
+  lwip_close(fd);
+  return ok;
+}
+
+// Our own query first (it has the TTL); lwIP's resolver as a fallback
+bool lookup(const char* host, IPAddress& ip, uint32_t& ttlS) {
+  if (query(host, ip, ttlS)) return true;
+  ttlS = DNS_TTL_FALLBACK_S;
+  return WiFi.hostByName(host, ip) == 1;
+}
+
+}  // namespace
+
+bool dnsResolve(const char* host, IPAddress& ip, uint16_t* lookupMs) {
+  if (lookupMs) *lookupMs = 0;
+  if (ip.fromString(host)) return true;   // already an address
+  {
+    DnsGuard g;
+    Entry* e = find(host);
+    if (e) e->lastUsed = millis();
+    if (e && e->has && (long)(e->expiresAt - millis()) > 0) {
+      ip = e->ip;
+      stats.hits++;
+      return true;
+    }
+    stats.misses++;
+  }
+
+  // Not under the lock: the other core may be resolving too
+  unsigned long t0 = millis();
+  uint32_t ttlS = 0;
+  bool ok = lookup(host, ip, ttlS);
+  if (lookupMs) *lookupMs = (uint16_t)min(millis() - t0, 65535UL);
+
+  DnsGuard g;
+  if (ok) {
+    store(host, ip, ttlS);
+    return true;
+  }
+  stats.failed++;
+  Entry* e = find(host);
+  if (e && e->has) {
+    LOG("[DNS] %s: lookup failed, using last address\n", host);
+    ip = e->ip;
+    stats.stale++;
+    return true;
+  }
+  LOG("[DNS] %s: lookup failed\n", host);
+  return false;
+}
+
+void dnsForget(const char* host) {
+  DnsGuard g;
+  if (Entry* e = find(host)) e->has = false;
+}
+
+void dnsPin(const char* host) {
+  DnsGuard g;
+  Entry* e = claim(host);
+  e->lastUsed = millis();
+}
+
+bool dnsRefresh() {
+  if (WiFi.status() != WL_CONNECTED) return false;
+  char host[TLS_HOST_MAX];
+  {
+    DnsGuard g;
+    unsigned long ms = millis();
+    Entry* pick     = nullptr;
+    long   pickLeft = 0;
+    for (int i = 0; i < entryCount; i++) {
+      Entry& e = entries[i];
+      if (ms - e.lastUsed > DNS_WARM_MS) continue;
+      if (e.failedAt && ms - e.failedAt < DNS_RETRY_MS) continue;
+      long left = e.has ? (long)(e.expiresAt - ms) : -(long)DNS_WARM_MS;
+      if (left > (long)DNS_REFRESH_LEAD_MS) continue;
+      if (!pick || left < pickLeft) {
+        pick     = &e;
+        pickLeft = left;
+      }
+    }
+    if (!pick) return false;
+    strlcpy(host, pick->host, sizeof(host));
+  }
+
+  IPAddress ip;
+  uint32_t  ttlS = 0;
+  bool ok = lookup(host, ip, ttlS);
+
+  DnsGuard g;
+  if (ok) {
+    // store() leaves lastUsed alone: only connects keep a host warm
+    store(host, ip, ttlS);
+    stats.prefetched++;
+  } else {
+    stats.failed++;
+    if (Entry* e = find(host)) e->failedAt = millis();
+  }
+  return true;
+}
+
+void dnsStats(DnsStats& out) {
+  DnsGuard g;
+  out = stats;
+  out.entries = entryCount;
+}
+
+long dnsTtlLeft(const char* host) {
+  DnsGuard g;
+  Entry* e = find(host);
+  if (!e || !e->has) return -1;
+  long left = (long)(e->expiresAt - millis());
+  return left > 0 ? (left + 999) / 1000 : 0;
+}
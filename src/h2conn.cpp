@@ -0,0 +1,767 @@
+// ============================================================
+//  HTTP/2 session (see h2conn.h)
+// ============================================================
+
+#include "config.h"
+#include <esp_heap_caps.h>
+#include <new>
+
+#define H2_TX_MAX  2048   // our HEADERS frame (a request head is at most HTTP_REQ_MAX)
+
+namespace {
+
+// Frame types and flags (RFC 9113 §6)
+enum : uint8_t { FT_DATA, FT_HEADERS, FT_PRIORITY, FT_RST_STREAM, FT_SETTINGS,
+                 FT_PUSH_PROMISE, FT_PING, FT_GOAWAY, FT_WINDOW_UPDATE, FT_CONTINUATION };
+#define FL_END_STREAM   0x01
+#define FL_ACK          0x01
+#define FL_END_HEADERS  0x04
+#define FL_PADDED       0x08
+#define FL_PRIORITY     0x20
+
+// Error codes (§7)
+#define H2E_PROTOCOL     0x1
+#define H2E_FLOW_CONTROL 0x3
+#define H2E_FRAME_SIZE   0x6
+#define H2E_CANCEL       0x8
+#define H2_WINDOW_MAX    0x7FFFFFFF   // largest flow-control window (§6.9.1)
+#define H2_WINDOW_INIT   65535        // before SETTINGS say otherwise (§6.5.2)
+#define H2E_COMPRESSION  0x9
+
+const char PREFACE[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+H2Stats           stats;
+StaticSemaphore_t h2LockBuf;
+SemaphoreHandle_t h2Lock = xSemaphoreCreateMutexStatic(&h2LockBuf);
+
+// Only the stats are shared (the TUI reads them from core 1)
+struct H2Guard {
+  H2Guard()  { xSemaphoreTake(h2Lock, portMAX_DELAY); }
+  ~H2Guard() { xSemaphoreGive(h2Lock); }
+};
+
+uint32_t be32(const uint8_t* p) {
+  return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+void put32(uint8_t* p, uint32_t v) {
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+void frameHead(uint8_t* p, size_t len, uint8_t type, uint8_t flags, uint32_t sid) {
+  p[0] = len >> 16;
+  p[1] = len >> 8;
+  p[2] = len;
+  p[3] = type;
+  p[4] = flags;
+  put32(p + 5, sid);
+}
+
+}  // namespace
+
+struct H2Conn::Stream {
+  uint32_t sid;              // 0 = slot free
+  bool     headed;           // final response head decoded
+  bool     ended;            // END_STREAM received
+  bool     reset;            // RST_STREAM, refused by GOAWAY, or the session died
+  int      status;
+  uint16_t hdrLen;
+  uint16_t rdPos, rdLen;     // unread body bytes in `ring`
+  uint32_t unacked;          // read since the last WINDOW_UPDATE
+  int32_t  sendWin;          // request body the server will take; may go negative
+  uint32_t headWire, dataWire;
+  char     hdr[H2_HDR_KEEP]; // "name\0value\0" pairs
+  uint8_t  ring[H2_STREAM_WINDOW];
+  H2Body   body;
+};
+
+struct H2Conn::Work {
+  uint32_t     epoch;        // TlsClient connection the session runs on
+  bool         started, goaway, dead;
+  uint32_t     nextSid;
+  uint32_t     peerMaxStreams;
+  uint32_t     peerMaxFrame;
+  uint32_t     peerWindow;   // the server's INITIAL_WINDOW_SIZE
+  int32_t      connSendWin;  // request body bytes the connection will take
+  uint32_t     connUnacked;  // connection-level bytes not yet credited back
+  uint32_t     connRx;       // connection frames, credited to the next close()
+  uint32_t     connTx;       // ...and our own, to the next open()
+  // Frame being read
+  uint8_t      rhdr[9];
+  uint32_t     rpos, rlen, rsid;
+  uint8_t      rtype, rflags;
+  // Header block being received
+  uint32_t     contSid;      // CONTINUATION expected on this stream (0 = none)
+  bool         contEnd;      // ...and its HEADERS carried END_STREAM
+  uint32_t     blockLen, blockWire;
+  HpackDecoder dec;
+  HpackEncoder enc;
+  Stream       streams[H2_STREAMS];
+  uint8_t      frame[H2_FRAME_MAX];
+  uint8_t      block[H2_BLOCK_MAX];
+  uint8_t      tx[H2_TX_MAX];
+  char         req[HTTP_REQ_MAX];
+  uint8_t      decTable[H2_DEC_TABLE];
+  uint8_t      encTable[H2_ENC_TABLE];
+  char         scratch[2 * H2_BLOCK_MAX];   // one decoded name + value
+};
+
+H2Conn* H2Conn::create() {
+  void* mem = heap_caps_malloc(sizeof(H2Conn) + sizeof(Work), MALLOC_CAP_SPIRAM);
+  if (!mem) return nullptr;
+  H2Conn* c = new (mem) H2Conn();
+  c->w_ = new ((uint8_t*)mem + sizeof(H2Conn)) Work();
+  c->w_->started = false;
+  return c;
+}
+
+void H2Conn::destroy(H2Conn* c) {
+  if (!c) return;
+  c->w_->~Work();
+  c->~H2Conn();
+  heap_caps_free(c);
+}
+
+// ── Session ─────────────────────────────────────────────
+
+bool H2Conn::start(TlsClient& c) {
+  c_ = &c;
+  Work& w = *w_;
+  w.epoch          = c.epoch();
+  w.started        = true;
+  w.goaway         = false;
+  w.dead           = false;
+  w.nextSid        = 1;
+  w.peerMaxStreams = UINT32_MAX;
+  w.peerMaxFrame   = H2_FRAME_MAX;
+  w.peerWindow     = H2_WINDOW_INIT;
+  w.connSendWin    = H2_WINDOW_INIT;
+  w.connUnacked    = 0;
+  w.connRx         = 0;
+  w.rpos           = 0;
+  w.contSid        = 0;
+  for (int i = 0; i < H2_STREAMS; i++) {
+    w.streams[i].sid = 0;
+    w.streams[i].body.bind(this, i);
+  }
+  w.dec.init(w.decTable, H2_DEC_TABLE, w.scratch, sizeof(w.scratch));
+  w.enc.init(w.encTable, H2_ENC_TABLE);
+
+  // Preface and our SETTINGS leave as one record. The server applies
+  // them before it reads our first HEADERS, so every stream starts
+  // with the smaller window.
+  static const uint16_t IDS[]  = { 0x2 /* ENABLE_PUSH */, 0x3 /* MAX_CONCURRENT_STREAMS */,
+                                   0x4 /* INITIAL_WINDOW_SIZE */ };
+  static const uint32_t VALS[] = { 0, H2_STREAMS, H2_STREAM_WINDOW };
+  size_t n = sizeof(PREFACE) - 1;
+  memcpy(w.tx, PREFACE, n);
+  frameHead(w.tx + n, 6 * 3, FT_SETTINGS, 0, 0);
+  n += 9;
+  for (int i = 0; i < 3; i++, n += 6) {
+    w.tx[n]     = IDS[i] >> 8;
+    w.tx[n + 1] = IDS[i];
+    put32(w.tx + n + 2, VALS[i]);
+  }
+  w.connTx = n;
+  if (c.write(w.tx, n) != n) {
+    w.dead = true;
+    return false;
+  }
+  H2Guard g;
+  stats.sessions++;
+  return true;
+}
+
+bool H2Conn::bound(const TlsClient& c) const {
+  return w_->started && w_->epoch == c.epoch();
+}
+
+bool H2Conn::usable() const {
+  const Work& w = *w_;
+  return w.started && !w.goaway && !w.dead && w.nextSid < 0x7FFFFFFF;
+}
+
+int H2Conn::room() const {
+  if (!usable()) return 0;
+  const Work& w = *w_;
+  uint32_t open = 0;
+  for (int i = 0; i < H2_STREAMS; i++) open += w.streams[i].sid != 0;
+  uint32_t max = min<uint32_t>(H2_STREAMS, w.peerMaxStreams);
+  return open < max ? max - open : 0;
+}
+
+bool H2Conn::sendFrame(uint8_t type, uint8_t flags, uint32_t sid, const uint8_t* p, size_t n) {
+  uint8_t buf[9 + 8];
+  frameHead(buf, n, type, flags, sid);
+  bool ok;
+  if (n <= 8) {
+    if (n) memcpy(buf + 9, p, n);
+    ok = c_->write(buf, 9 + n) == 9 + n;
+  } else {
+    ok = c_->write(buf, 9) == 9 && c_->write(p, n) == n;
+  }
+  w_->connTx += 9 + n;
+  return ok;
+}
+
+void H2Conn::sendWindow(uint32_t sid, uint32_t n) {
+  uint8_t inc[4];
+  put32(inc, n);
+  sendFrame(FT_WINDOW_UPDATE, 0, sid, inc, 4);
+}
+
+// The session is over: tell the server why, and fail every open stream
+void H2Conn::fatal(uint32_t err, const char* why) {
+  Work& w = *w_;
+  if (!w.dead) {
+    LOG("[H2] %s: closing session (error %lu)\n", why, (unsigned long)err);
+    uint8_t p[8];
+    put32(p, 0);       // we accept no streams from the server
+    put32(p + 4, err);
+    sendFrame(FT_GOAWAY, 0, 0, p, 8);
+    H2Guard g;
+    stats.errors++;
+  }
+  w.dead = true;
+  for (Stream& s : w.streams) {
+    if (s.sid && !s.ended) s.reset = true;
+  }
+}
+
+H2Conn::Stream* H2Conn::find(uint32_t sid) {
+  for (Stream& s : w_->streams) {
+    if (s.sid && s.sid == sid) return &s;
+  }
+  return nullptr;
+}
+
+// Body bytes are gone from a buffer (read, padding, or dropped with
+// their stream): give the window back once half of it is used up
+void H2Conn::consumed(int slot, size_t n) {
+  Work& w = *w_;
+  Stream* s = slot >= 0 ? &w.streams[slot] : nullptr;
+  if (s && !s->ended && !s->reset) {
+    s->unacked += n;
+    if (s->unacked >= H2_STREAM_WINDOW / 2) {
+      sendWindow(s->sid, s->unacked);
+      s->unacked = 0;
+    }
+  }
+  w.connUnacked += n;
+  if (w.connUnacked >= H2_STREAM_WINDOW / 2) {
+    sendWindow(0, w.connUnacked);
+    w.connUnacked = 0;
+  }
+}
+
+// Read what has arrived and dispatch whole frames; never blocks.
+// False once the session is dead.
+bool H2Conn::pump() {
+  Work& w = *w_;
+  while (!w.dead && c_->available() > 0) {
+    int n;
+    if (w.rpos < 9) {
+      n = c_->read(w.rhdr + w.rpos, 9 - w.rpos);
+      if (n <= 0) break;
+      w.rpos += n;
+      if (w.rpos < 9) continue;
+      w.rlen   = (uint32_t)w.rhdr[0] << 16 | w.rhdr[1] << 8 | w.rhdr[2];
+      w.rtype  = w.rhdr[3];
+      w.rflags = w.rhdr[4];
+      w.rsid   = be32(w.rhdr + 5) & 0x7FFFFFFF;
+      if (w.rlen > H2_FRAME_MAX) {
+        fatal(H2E_FRAME_SIZE, "oversized frame");
+        break;
+      }
+    } else {
+      n = c_->read(w.frame + (w.rpos - 9), 9 + w.rlen - w.rpos);
+      if (n <= 0) break;
+      w.rpos += n;
+    }
+    if (w.rpos == 9 + w.rlen) {
+      w.rpos = 0;
+      dispatch();
+    }
+  }
+  if (!w.dead && !c_->connected()) {
+    w.dead = true;
+    for (Stream& s : w.streams) {
+      if (s.sid && !s.ended) s.reset = true;
+    }
+  }
+  return !w.dead;
+}
+
+void H2Conn::dispatch() {
+  Work&    w    = *w_;
+  uint8_t* p    = w.frame;
+  uint32_t n    = w.rlen;
+  uint32_t wire = 9 + n;
+  if (w.contSid && w.rtype != FT_CONTINUATION) {
+    fatal(H2E_PROTOCOL, "header block interrupted");
+    return;
+  }
+
+  switch (w.rtype) {
+    case FT_DATA: {
+      uint32_t pad = 0;
+      if (w.rflags & FL_PADDED) {
+        pad = n ? p[0] + 1 : 0;
+        if (!n || pad > n) {
+          fatal(H2E_PROTOCOL, "bad padding");
+          return;
+        }
+      }
+      uint32_t len = n - pad;
+      Stream*  s   = find(w.rsid);
+      if (!s || !s->headed || s->ended || s->reset) {
+        // Cancelled or unknown stream: only the connection window counts it
+        w.connRx += wire;
+        consumed(-1, n);
+        break;
+      }
+      if (len > (uint32_t)(H2_STREAM_WINDOW - s->rdLen)) {
+        fatal(H2E_FLOW_CONTROL, "stream window overrun");
+        return;
+      }
+      const uint8_t* d  = p + (pad ? 1 : 0);
+      uint16_t       at = (s->rdPos + s->rdLen) % H2_STREAM_WINDOW;
+      uint32_t       k  = min(len, (uint32_t)(H2_STREAM_WINDOW - at));
+      memcpy(s->ring + at, d, k);
+      memcpy(s->ring, d + k, len - k);
+      s->rdLen    += len;
+      s->dataWire += wire;
+      if (pad) consumed(s - w.streams, pad);
+      if (w.rflags & FL_END_STREAM) s->ended = true;
+      break;
+    }
+
+    case FT_HEADERS:
+    case FT_CONTINUATION: {
+      uint32_t off = 0, pad = 0;
+      if (w.rtype == FT_HEADERS) {
+        if (!w.rsid) {
+          fatal(H2E_PROTOCOL, "HEADERS on stream 0");
+          return;
+        }
+        if (w.rflags & FL_PADDED)   pad = n ? p[off++] : 0;
+        if (w.rflags & FL_PRIORITY) off += 5;
+        w.blockLen  = 0;
+        w.blockWire = 0;
+        w.contEnd   = w.rflags & FL_END_STREAM;
+      } else if (w.rsid != w.contSid || !w.contSid) {
+        fatal(H2E_PROTOCOL, "stray CONTINUATION");
+        return;
+      }
+      if (off + pad > n || w.blockLen + (n - off - pad) > H2_BLOCK_MAX) {
+        // Undecoded, the block would leave the HPACK table out of step
+        fatal(H2E_PROTOCOL, "header block too big");
+        return;
+      }
+      memcpy(w.block + w.blockLen, p + off, n - off - pad);
+      w.blockLen  += n - off - pad;
+      w.blockWire += wire;
+      if (w.rflags & FL_END_HEADERS) {
+        w.contSid = 0;
+        onHeaders(w.rsid, w.contEnd);
+      } else {
+        w.contSid = w.rsid;
+      }
+      break;
+    }
+
+    case FT_RST_STREAM:
+      w.connRx += wire;
+      if (Stream* s = find(w.rsid)) {
+        if (!s->ended) {
+          s->reset = true;
+          H2Guard g;
+          stats.resets++;
+        }
+      }
+      break;
+
+    case FT_SETTINGS:
+      w.connRx += wire;
+      if (w.rflags & FL_ACK) break;
+      if (w.rsid || n % 6) {
+        fatal(H2E_FRAME_SIZE, "bad SETTINGS");
+        return;
+      }
+      for (uint32_t i = 0; i < n; i += 6) {
+        uint16_t id = p[i] << 8 | p[i + 1];
+        uint32_t v  = be32(p + i + 2);
+        if (id == 0x1)      w.enc.peerLimit(v);        // HEADER_TABLE_SIZE
+        else if (id == 0x3) w.peerMaxStreams = v;      // MAX_CONCURRENT_STREAMS
+        else if (id == 0x5) w.peerMaxFrame   = v;      // MAX_FRAME_SIZE
+        else if (id == 0x4) {                          // INITIAL_WINDOW_SIZE
+          // Applies to open streams too, by the difference (§6.9.2)
+          if (v > H2_WINDOW_MAX) {
+            fatal(H2E_FLOW_CONTROL, "bad INITIAL_WINDOW_SIZE");
+            return;
+          }
+          int64_t delta = (int64_t)v - w.peerWindow;
+          for (Stream& st : w.streams) {
+            if (!st.sid) continue;
+            if (st.sendWin + delta > H2_WINDOW_MAX) {
+              fatal(H2E_FLOW_CONTROL, "stream window overflow");
+              return;
+            }
+            st.sendWin += delta;
+          }
+          w.peerWindow = v;
+        }
+      }
+      sendFrame(FT_SETTINGS, FL_ACK, 0, nullptr, 0);
+      break;
+
+    case FT_PING:
+      w.connRx += wire;
+      if (n != 8) {
+        fatal(H2E_FRAME_SIZE, "bad PING");
+        return;
+      }
+      if (!(w.rflags & FL_ACK)) sendFrame(FT_PING, FL_ACK, 0, p, 8);
+      break;
+
+    case FT_GOAWAY: {
+      w.connRx += wire;
+      if (n < 8) {
+        fatal(H2E_FRAME_SIZE, "bad GOAWAY");
+        return;
+      }
+      uint32_t last = be32(p) & 0x7FFFFFFF;
+      LOG("[H2] GOAWAY (error %lu), last stream %lu\n", (unsigned long)be32(p + 4),
+          (unsigned long)last);
+      w.goaway = true;
+      // Streams past `last` were never processed
+      for (Stream& s : w.streams) {
+        if (s.sid > last && !s.ended) s.reset = true;
+      }
+      H2Guard g;
+      stats.goaways++;
+      break;
+    }
+
+    case FT_WINDOW_UPDATE: {
+      w.connRx += wire;
+      if (n != 4) {
+        fatal(H2E_FRAME_SIZE, "bad WINDOW_UPDATE");
+        return;
+      }
+      uint32_t inc = be32(p) & 0x7FFFFFFF;
+      if (!w.rsid) {
+        if (!inc || (int64_t)w.connSendWin + inc > H2_WINDOW_MAX) {
+          fatal(inc ? H2E_FLOW_CONTROL : H2E_PROTOCOL, "bad connection WINDOW_UPDATE");
+          return;
+        }
+        w.connSendWin += inc;
+      } else if (Stream* s = find(w.rsid)) {
+        if (!inc || (int64_t)s->sendWin + inc > H2_WINDOW_MAX) {
+          // Only this stream is broken
+          uint8_t err[4];
+          put32(err, inc ? H2E_FLOW_CONTROL : H2E_PROTOCOL);
+          sendFrame(FT_RST_STREAM, 0, s->sid, err, 4);
+          if (!s->ended) s->reset = true;
+          break;
+        }
+        s->sendWin += inc;
+      }
+      break;
+    }
+
+    case FT_PUSH_PROMISE:   // disabled in our SETTINGS
+      fatal(H2E_PROTOCOL, "PUSH_PROMISE");
+      return;
+
+    default:                // PRIORITY, unknown types
+      w.connRx += wire;
+      break;
+  }
+}
+
+void H2Conn::onField(const char* name, const char* value, void* ctx) {
+  Stream* s = (Stream*)ctx;
+  if (!s) return;   // trailers, or a stream we no longer track
+  if (name[0] == ':') {
+    if (!strcmp(name, ":status")) s->status = atoi(value);
+    return;
+  }
+  size_t nl = strlen(name) + 1;
+  size_t vl = min(strlen(value), (size_t)H2_HDR_VAL_MAX) + 1;
+  if (s->hdrLen + nl + vl > sizeof(s->hdr)) return;
+  memcpy(s->hdr + s->hdrLen, name, nl);
+  memcpy(s->hdr + s->hdrLen + nl, value, vl - 1);
+  s->hdr[s->hdrLen + nl + vl - 1] = 0;
+  s->hdrLen += nl + vl;
+}
+
+// A complete header block. It is decoded even if nobody wants it: the
+// HPACK table depends on every block, in order.
+void H2Conn::onHeaders(uint32_t sid, bool endStream) {
+  Work&   w    = *w_;
+  Stream* s    = find(sid);
+  Stream* keep = (s && !s->headed) ? s : nullptr;
+  if (keep) {
+    keep->status = 0;
+    keep->hdrLen = 0;
+  }
+  if (!w.dec.decode(w.block, w.blockLen, onField, keep)) {
+    fatal(H2E_COMPRESSION, "HPACK");
+    return;
+  }
+  if (!s) {
+    w.connRx += w.blockWire;
+    return;
+  }
+  s->headWire += w.blockWire;
+  if (keep) {
+    if (s->status >= 200)  s->headed = true;
+    else if (!s->status)   s->reset  = true;   // no :status — malformed
+    // 1xx: interim, the final head follows
+  }
+  if (endStream) s->ended = true;
+}
+
+// ── Streams ─────────────────────────────────────────────
+
+int H2Conn::open(const char* head, size_t headLen, const uint8_t* body, size_t len,
+                 bool sized, unsigned long deadline, uint32_t& wire) {
+  Work& w = *w_;
+  wire = 0;
+  if (!pump() || !usable()) return HTTP_ERR_SEND;
+  if (headLen >= sizeof(w.req) || len > H2_BODY_MAX) return HTTP_ERR_TOO_LONG;
+  int slot = -1, open = 0;
+  for (int i = 0; i < H2_STREAMS; i++) {
+    if (w.streams[i].sid) open++;
+    else if (slot < 0)    slot = i;
+  }
+  if (slot < 0 || (uint32_t)open >= w.peerMaxStreams) return HTTP_ERR_SEND;
+
+  // Take the HTTP/1.1 head apart in a copy: request line, then fields
+  memcpy(w.req, head, headLen);
+  w.req[headLen] = 0;
+  char* method = w.req;
+  char* path   = strchr(method, ' ');
+  if (!path) return HTTP_ERR_SEND;
+  *path++ = 0;
+  char* line = strstr(path, "\r\n");
+  if (!line) return HTTP_ERR_SEND;
+  *line = 0;
+  if (char* ver = strrchr(path, ' ')) *ver = 0;
+  line += 2;
+  char authority[HTTP_HOST_MAX] = "";
+  for (char* l = line; *l;) {
+    char* eol = strstr(l, "\r\n");
+    if (!eol) break;
+    if (!strncasecmp(l, "Host:", 5)) {
+      const char* v = l + 5 + strspn(l + 5, " ");
+      snprintf(authority, sizeof(authority), "%.*s", (int)(eol - v), v);
+    }
+    l = eol + 2;
+  }
+
+  // Pseudo-headers first (§8.3.1), then the fields with lower-case names.
+  // A field that doesn't fit encodes to nothing; none may go missing.
+  uint8_t* b     = w.tx + 9;
+  size_t   cap   = sizeof(w.tx) - 9;
+  size_t   n     = w.enc.begin(b, cap);
+  bool     whole = true;
+  auto put = [&](const char* name, const char* value) {
+    size_t k = w.enc.field(b + n, cap - n, name, value);
+    whole &= k > 0;
+    n += k;
+  };
+  put(":method", method);
+  put(":scheme", "https");
+  put(":authority", authority);
+  put(":path", path);
+  for (char* l = line; *l;) {
+    char* eol = strstr(l, "\r\n");
+    if (!eol) break;
+    *eol = 0;
+    char* colon = strchr(l, ':');
+    if (colon) {
+      *colon = 0;
+      for (char* c = l; *c; c++) *c = tolower((uint8_t)*c);
+      const char* v = colon + 1 + strspn(colon + 1, " ");
+      // Connection-specific fields don't exist in HTTP/2 (§8.2.2)
+      if (strcmp(l, "host") && strcmp(l, "connection") && strcmp(l, "keep-alive") &&
+          strcmp(l, "transfer-encoding")) {
+        put(l, v);
+      }
+    }
+    l = eol + 2;
+  }
+  if (len || sized) {
+    char cl[12];
+    snprintf(cl, sizeof(cl), "%u", (unsigned)len);
+    put("content-length", cl);
+  }
+  // The fields before it are already in the encoder's table, which the
+  // server's decoder will never see now: the session can't go on
+  if (!whole) {
+    fatal(H2E_PROTOCOL, "request head too big");
+    return HTTP_ERR_TOO_LONG;
+  }
+
+  Stream& s  = w.streams[slot];
+  s.sid      = w.nextSid;
+  w.nextSid += 2;
+  s.headed   = s.ended = s.reset = false;
+  s.status   = 0;
+  s.hdrLen   = 0;
+  s.rdPos    = s.rdLen = 0;
+  s.unacked  = 0;
+  s.sendWin  = w.peerWindow;
+  s.headWire = s.dataWire = 0;
+
+  frameHead(w.tx, n, FT_HEADERS, FL_END_HEADERS | (len ? 0 : FL_END_STREAM), s.sid);
+  bool ok = c_->write(w.tx, 9 + n) == 9 + n;
+  w.connTx += 9 + n;
+  // The body goes out as the server's windows allow; while they are
+  // shut, frames are read until a WINDOW_UPDATE opens them
+  bool stalled = false;
+  for (size_t at = 0; ok && at < len;) {
+    int32_t room = min(s.sendWin, w.connSendWin);
+    if (room <= 0) {
+      if (!pump() || s.reset || s.ended || (long)(millis() - deadline) >= 0) {
+        stalled = true;
+        break;
+      }
+      delay(1);
+      continue;
+    }
+    size_t k = min(min(len - at, (size_t)w.peerMaxFrame), (size_t)room);
+    ok = sendFrame(FT_DATA, at + k == len ? FL_END_STREAM : 0, s.sid, body + at, k);
+    s.sendWin     -= k;
+    w.connSendWin -= k;
+    at += k;
+  }
+  wire     = w.connTx;
+  w.connTx = 0;
+  if (!ok) {
+    fatal(H2E_PROTOCOL, "write failed");
+    s.sid = 0;
+    return HTTP_ERR_SEND;
+  }
+  if (stalled) {
+    // The rest of the body can't go out; drop just this stream
+    LOG("[H2] stream %lu: send window stayed shut\n", (unsigned long)s.sid);
+    if (!s.reset && !w.dead) {
+      uint8_t err[4];
+      put32(err, H2E_CANCEL);
+      sendFrame(FT_RST_STREAM, 0, s.sid, err, 4);
+    }
+    s.reset   = true;
+    w.connRx += close(slot);   // still owed to the next close()
+    return HTTP_ERR_SEND;
+  }
+
+  H2Guard g;
+  stats.streams++;
+  stats.maxOpen  = max(stats.maxOpen, (uint8_t)(open + 1));
+  stats.headRaw  += headLen + 2;   // + the blank line
+  stats.headWire += 9 + n;
+  return slot;
+}
+
+bool H2Conn::waitHead(int slot, unsigned long deadline) {
+  for (;;) {
+    int state = pollHead(slot);
+    if (state) return state > 0;
+    if ((long)(millis() - deadline) >= 0) return false;
+    delay(1);
+  }
+}
+
+int H2Conn::pollHead(int slot) {
+  Stream& s = w_->streams[slot];
+  pump();
+  if (s.headed) return 1;
+  return s.reset ? -1 : 0;
+}
+
+int H2Conn::status(int slot) const {
+  return w_->streams[slot].status;
+}
+
+bool H2Conn::header(int slot, size_t& pos, const char*& name, const char*& value) const {
+  const Stream& s = w_->streams[slot];
+  if (pos >= s.hdrLen) return false;
+  name  = s.hdr + pos;
+  value = name + strlen(name) + 1;
+  pos   = (value - s.hdr) + strlen(value) + 1;
+  return true;
+}
+
+Client& H2Conn::body(int slot) {
+  return w_->streams[slot].body;
+}
+
+uint32_t H2Conn::headWire(int slot) const {
+  return w_->streams[slot].headWire;
+}
+
+uint32_t H2Conn::close(int slot) {
+  Work&   w = *w_;
+  Stream& s = w.streams[slot];
+  if (!s.sid) return 0;
+  if (!s.ended && !s.reset && !w.dead) {
+    uint8_t err[4];
+    put32(err, H2E_CANCEL);
+    sendFrame(FT_RST_STREAM, 0, s.sid, err, 4);
+    H2Guard g;
+    stats.cancelled++;
+  }
+  s.reset = true;   // no more stream credit
+  if (s.rdLen) consumed(slot, s.rdLen);
+  uint32_t rx = s.dataWire + w.connRx;
+  w.connRx = 0;
+  s.sid    = 0;
+  return rx;
+}
+
+bool H2Conn::service() {
+  return pump() && usable();
+}
+
+// ── Body ────────────────────────────────────────────────
+
+int H2Body::available() {
+  H2Conn::Stream& s = conn_->w_->streams[slot_];
+  if (!s.rdLen && !s.ended && !s.reset) conn_->pump();
+  return s.rdLen;
+}
+
+int H2Body::read(uint8_t* buf, size_t size) {
+  int avail = available();
+  if (avail <= 0 || !size) return -1;
+  H2Conn::Stream& s = conn_->w_->streams[slot_];
+  size_t n = min(size, (size_t)avail);
+  size_t k = min(n, (size_t)(H2_STREAM_WINDOW - s.rdPos));
+  memcpy(buf, s.ring + s.rdPos, k);
+  memcpy(buf + k, s.ring, n - k);
+  s.rdPos  = (s.rdPos + n) % H2_STREAM_WINDOW;
+  s.rdLen -= n;
+  conn_->consumed(slot_, n);
+  return n;
+}
+
+int H2Body::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+uint8_t H2Body::connected() {
+  const H2Conn::Stream& s = conn_->w_->streams[slot_];
+  return s.rdLen > 0 || (!s.ended && !s.reset);
+}
+
+void h2Stats(H2Stats& out) {
+  H2Guard g;
+  out = stats;
+}
@@ -0,0 +1,389 @@
+// ============================================================
+//  HPACK header compression (see hpack.h)
+// ============================================================
+
+#include "config.h"
+
+namespace {
+
+struct StaticField { const char* name; const char* value; };
+
+// RFC 7541 Appendix A; index 1 is the first entry
+const StaticField STATIC_TABLE[HPACK_STATIC_COUNT] = {
+  { ":authority", "" },
+  { ":method", "GET" },
+  { ":method", "POST" },
+  { ":path", "/" },
+  { ":path", "/index.html" },
+  { ":scheme", "http" },
+  { ":scheme", "https" },
+  { ":status", "200" },
+  { ":status", "204" },
+  { ":status", "206" },
+  { ":status", "304" },
+  { ":status", "400" },
+  { ":status", "404" },
+  { ":status", "500" },
+  { "accept-charset", "" },
+  { "accept-encoding", "gzip, deflate" },
+  { "accept-language", "" },
+  { "accept-ranges", "" },
+  { "accept", "" },
+  { "access-control-allow-origin", "" },
+  { "age", "" },
+  { "allow", "" },
+  { "authorization", "" },
+  { "cache-control", "" },
+  { "content-disposition", "" },
+  { "content-encoding", "" },
+  { "content-language", "" },
+  { "content-length", "" },
+  { "content-location", "" },
+  { "content-range", "" },
+  { "content-type", "" },
+  { "cookie", "" },
+  { "date", "" },
+  { "etag", "" },
+  { "expect", "" },
+  { "expires", "" },
+  { "from", "" },
+  { "host", "" },
+  { "if-match", "" },
+  { "if-modified-since", "" },
+  { "if-none-match", "" },
+  { "if-range", "" },
+  { "if-unmodified-since", "" },
+  { "last-modified", "" },
+  { "link", "" },
+  { "location", "" },
+  { "max-forwards", "" },
+  { "proxy-authenticate", "" },
+  { "proxy-authorization", "" },
+  { "range", "" },
+  { "referer", "" },
+  { "refresh", "" },
+  { "retry-after", "" },
+  { "server", "" },
+  { "set-cookie", "" },
+  { "strict-transport-security", "" },
+  { "transfer-encoding", "" },
+  { "user-agent", "" },
+  { "vary", "" },
+  { "via", "" },
+  { "www-authenticate", "" },
+};
+
+// RFC 7541 Appendix B. The code is canonical: codes are handed out in
+// order of length, then symbol, so the lengths alone define it. Codes
+// per length (EOS is the fourth 30-bit code), and the symbols in code
+// order.
+const uint8_t HUFF_COUNT[31] = {
+  0, 0, 0, 0, 0, 10, 26, 32, 6, 0, 5, 3, 2, 6, 2, 3,
+  0, 0, 0, 3, 8, 13, 26, 29, 12, 4, 15, 19, 29, 0, 4,
+};
+const uint8_t HUFF_SYMS[256] = {
+   48,  49,  50,  97,  99, 101, 105, 111, 115, 116,  32,  37,  45,  46,  47,  51,
+   52,  53,  54,  55,  56,  57,  61,  65,  95,  98, 100, 102, 103, 104, 108, 109,
+  110, 112, 114, 117,  58,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,
+   77,  78,  79,  80,  81,  82,  83,  84,  85,  86,  87,  89, 106, 107, 113, 118,
+  119, 120, 121, 122,  38,  42,  44,  59,  88,  90,  33,  34,  40,  41,  63,  39,
+   43, 124,  35,  62,   0,  36,  64,  91,  93, 126,  94, 125,  60,  96, 123,  92,
+  195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161, 167, 172, 176, 177,
+  179, 209, 216, 217, 227, 229, 230, 129, 132, 133, 134, 136, 146, 154, 156, 160,
+  163, 164, 169, 170, 173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+  233,   1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150, 151, 152, 155, 157,
+  158, 165, 166, 168, 174, 175, 180, 182, 183, 188, 191, 197, 231, 239,   9, 142,
+  144, 145, 148, 159, 171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+  200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243, 255, 203, 204, 211,
+  212, 214, 221, 222, 223, 241, 244, 245, 246, 247, 248, 250, 251, 252, 253, 254,
+    2,   3,   4,   5,   6,   7,   8,  11,  12,  14,  15,  16,  17,  18,  19,  20,
+   21,  23,  24,  25,  26,  27,  28,  29,  30,  31, 127, 220, 249,  10,  13,  22,
+};
+
+// Integer with an N-bit prefix (§5.1); false if it runs off the end
+bool readInt(const uint8_t* p, size_t n, size_t& i, uint8_t bits, uint32_t& out) {
+  if (i >= n) return false;
+  uint32_t mask = (1u << bits) - 1;
+  out = p[i++] & mask;
+  if (out < mask) return true;
+  for (uint8_t shift = 0; shift <= 21; shift += 7) {
+    if (i >= n) return false;
+    uint8_t b = p[i++];
+    out += (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;   // longer than any length or index we accept
+}
+
+size_t writeInt(uint8_t* out, size_t cap, uint8_t flags, uint8_t bits, uint32_t v) {
+  uint32_t mask = (1u << bits) - 1;
+  if (!cap) return 0;
+  if (v < mask) {
+    out[0] = flags | v;
+    return 1;
+  }
+  out[0] = flags | mask;
+  size_t n = 1;
+  for (v -= mask; v >= 0x80; v >>= 7) {
+    if (n >= cap) return 0;
+    out[n++] = (uint8_t)(v | 0x80);
+  }
+  if (n >= cap) return 0;
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+// Raw string with a 7-bit length prefix (no Huffman)
+size_t writeStr(uint8_t* out, size_t cap, const char* s, size_t len) {
+  size_t n = writeInt(out, cap, 0x00, 7, len);
+  if (!n || n + len > cap) return 0;
+  memcpy(out + n, s, len);
+  return n + len;
+}
+
+bool huffDecode(const uint8_t* p, size_t n, char* out, size_t cap, size_t& len) {
+  // Canonical decode, one bit at a time, resumed across bytes
+  uint32_t code = 0, first = 0, index = 0, raw = 0;
+  uint8_t  bits = 0;
+  len = 0;
+  for (size_t i = 0; i < n; i++) {
+    for (int b = 7; b >= 0; b--) {
+      uint32_t bit = (p[i] >> b) & 1;
+      code |= bit;
+      raw   = raw << 1 | bit;
+      bits++;
+      uint32_t count = HUFF_COUNT[bits];
+      if (code - first < count) {
+        uint32_t sym = index + (code - first);
+        if (sym >= sizeof(HUFF_SYMS) || len + 1 >= cap) return false;   // EOS / too long
+        out[len++] = (char)HUFF_SYMS[sym];
+        code = first = index = raw = 0;
+        bits = 0;
+        continue;
+      }
+      if (bits == 30) return false;
+      index += count;
+      first  = (first + count) << 1;
+      code <<= 1;
+    }
+  }
+  out[len] = 0;
+  // Padding: at most 7 bits, all ones (a prefix of EOS)
+  return bits <= 7 && raw == (1u << bits) - 1;
+}
+
+bool readStr(const uint8_t* p, size_t n, size_t& i, char* out, size_t cap, size_t& len) {
+  if (i >= n) return false;
+  bool     huff = p[i] & 0x80;
+  uint32_t sl;
+  if (!readInt(p, n, i, 7, sl) || sl > n - i) return false;
+  if (huff) {
+    if (!huffDecode(p + i, sl, out, cap, len)) return false;
+  } else {
+    if (sl >= cap) return false;
+    memcpy(out, p + i, sl);
+    out[sl] = 0;
+    len = sl;
+  }
+  i += sl;
+  return true;
+}
+
+}  // namespace
+
+// ── Dynamic table ───────────────────────────────────────
+
+void HpackTable::init(uint8_t* buf, uint16_t cap) {
+  buf_   = buf;
+  cap_   = cap;
+  max_   = cap;
+  size_  = 0;
+  start_ = end_ = 0;
+  first_ = n_ = 0;
+}
+
+void HpackTable::evict() {
+  const uint8_t* e = buf_ + off_[first_];
+  uint16_t nl = e[0] | e[1] << 8, vl = e[2] | e[3] << 8;
+  size_  -= nl + vl + HPACK_ENTRY_EXTRA;
+  start_  = off_[first_] + 4 + nl + vl;
+  first_  = (first_ + 1) % HPACK_ENTRIES_MAX;
+  if (--n_ == 0) start_ = end_ = 0;
+}
+
+void HpackTable::setMax(uint16_t max) {
+  max_ = min(max, cap_);
+  while (n_ && size_ > max_) evict();
+}
+
+void HpackTable::add(const char* name, uint16_t nl, const char* value, uint16_t vl) {
+  uint32_t sz = (uint32_t)nl + vl + HPACK_ENTRY_EXTRA;
+  // An entry bigger than the table empties it and isn't added (§4.4)
+  while (n_ && (size_ + sz > max_ || n_ == HPACK_ENTRIES_MAX)) evict();
+  if (sz > max_) return;
+
+  // Stored bytes never exceed the RFC size, so sliding always makes room
+  uint16_t need = 4 + nl + vl;
+  if (end_ + need > cap_) {
+    memmove(buf_, buf_ + start_, end_ - start_);
+    for (uint8_t k = 0; k < n_; k++) off_[(first_ + k) % HPACK_ENTRIES_MAX] -= start_;
+    end_  -= start_;
+    start_ = 0;
+  }
+  uint8_t* e = buf_ + end_;
+  e[0] = nl & 0xFF;
+  e[1] = nl >> 8;
+  e[2] = vl & 0xFF;
+  e[3] = vl >> 8;
+  memcpy(e + 4, name, nl);
+  memcpy(e + 4 + nl, value, vl);
+  off_[(first_ + n_) % HPACK_ENTRIES_MAX] = end_;
+  n_++;
+  end_  += need;
+  size_ += sz;
+}
+
+void HpackTable::get(uint16_t i, const char*& name, uint16_t& nl,
+                     const char*& value, uint16_t& vl) const {
+  const uint8_t* e = buf_ + off_[(first_ + n_ - 1 - i) % HPACK_ENTRIES_MAX];
+  nl    = e[0] | e[1] << 8;
+  vl    = e[2] | e[3] << 8;
+  name  = (const char*)e + 4;
+  value = name + nl;
+}
+
+// ── Decoder ─────────────────────────────────────────────
+
+void HpackDecoder::init(uint8_t* table, uint16_t limit, char* scratch, uint16_t scratchLen) {
+  table_.init(table, limit);
+  limit_  = limit;
+  scr_    = scratch;
+  scrLen_ = scratchLen;
+}
+
+bool HpackDecoder::lookup(uint32_t index, const char*& name, uint16_t& nl,
+                          const char*& value, uint16_t& vl) const {
+  if (index == 0) return false;
+  if (index <= HPACK_STATIC_COUNT) {
+    name  = STATIC_TABLE[index - 1].name;
+    value = STATIC_TABLE[index - 1].value;
+    nl    = strlen(name);
+    vl    = strlen(value);
+    return true;
+  }
+  index -= HPACK_STATIC_COUNT + 1;
+  if (index >= table_.count()) return false;
+  table_.get(index, name, nl, value, vl);
+  return true;
+}
+
+bool HpackDecoder::decode(const uint8_t* p, size_t n, HpackFieldFn fn, void* ctx) {
+  // Name and value are copied into the scratch: a literal's name can
+  // point at the very entry its insertion evicts
+  uint16_t half = scrLen_ / 2;
+  char*    name = scr_;
+  char*    val  = scr_ + half;
+  size_t   i    = 0;
+  while (i < n) {
+    uint8_t  b = p[i];
+    uint32_t idx;
+    size_t   nl = 0, vl = 0;
+    const char* en;
+    const char* ev;
+    uint16_t enl, evl;
+
+    if (b & 0x80) {                        // indexed field
+      if (!readInt(p, n, i, 7, idx) || !lookup(idx, en, enl, ev, evl)) return false;
+      if (enl >= half || evl >= half) return false;
+      memcpy(name, en, enl);
+      name[enl] = 0;
+      memcpy(val, ev, evl);
+      val[evl] = 0;
+      fn(name, val, ctx);
+      continue;
+    }
+    if ((b & 0xE0) == 0x20) {              // table size update
+      if (!readInt(p, n, i, 5, idx) || idx > limit_) return false;
+      table_.setMax(idx);
+      continue;
+    }
+
+    // Literal: with incremental indexing, without, or never indexed
+    bool    index = (b & 0xC0) == 0x40;
+    uint8_t bits  = index ? 6 : 4;
+    if (!readInt(p, n, i, bits, idx)) return false;
+    if (idx) {
+      if (!lookup(idx, en, enl, ev, evl) || enl >= half) return false;
+      memcpy(name, en, enl);
+      name[enl] = 0;
+      nl = enl;
+    } else if (!readStr(p, n, i, name, half, nl)) {
+      return false;
+    }
+    if (!readStr(p, n, i, val, half, vl)) return false;
+    if (index) table_.add(name, nl, val, vl);
+    fn(name, val, ctx);
+  }
+  return true;
+}
+
+// ── Encoder ─────────────────────────────────────────────
+
+void HpackEncoder::init(uint8_t* table, uint16_t size) {
+  table_.init(table, size);
+  size_ = size;
+  // The peer's decoder starts at the protocol default (4096); say up
+  // front that we use less
+  want_     = size;
+  announce_ = true;
+}
+
+void HpackEncoder::peerLimit(uint32_t limit) {
+  uint16_t want = (uint16_t)min(limit, (uint32_t)size_);
+  if (want == table_.max() && !announce_) return;
+  want_     = want;
+  announce_ = true;
+}
+
+size_t HpackEncoder::begin(uint8_t* out, size_t cap) {
+  if (!announce_) return 0;
+  size_t n = writeInt(out, cap, 0x20, 5, want_);
+  if (!n) return 0;
+  table_.setMax(want_);
+  announce_ = false;
+  return n;
+}
+
+size_t HpackEncoder::field(uint8_t* out, size_t cap, const char* name, const char* value) {
+  size_t   nl = strlen(name), vl = strlen(value);
+  uint32_t nameIdx = 0;
+  for (int i = 0; i < HPACK_STATIC_COUNT; i++) {
+    if (strcmp(STATIC_TABLE[i].name, name)) continue;
+    if (!strcmp(STATIC_TABLE[i].value, value)) return writeInt(out, cap, 0x80, 7, i + 1);
+    if (!nameIdx) nameIdx = i + 1;
+  }
+  for (uint16_t i = 0; i < table_.count(); i++) {
+    const char* en;
+    const char* ev;
+    uint16_t    enl, evl;
+    table_.get(i, en, enl, ev, evl);
+    if (enl != nl || memcmp(en, name, nl)) continue;
+    uint32_t idx = HPACK_STATIC_COUNT + 1 + i;
+    if (evl == vl && !memcmp(ev, value, vl)) return writeInt(out, cap, 0x80, 7, idx);
+    if (!nameIdx) nameIdx = idx;
+  }
+
+  // Literal; indexed unless it couldn't fit the table anyway
+  bool   index = nl + vl + HPACK_ENTRY_EXTRA <= table_.max();
+  size_t n     = index ? writeInt(out, cap, 0x40, 6, nameIdx) : writeInt(out, cap, 0x00, 4, nameIdx);
+  if (!n) return 0;
+  if (!nameIdx) {
+    size_t s = writeStr(out + n, cap - n, name, nl);
+    if (!s) return 0;
+    n += s;
+  }
+  size_t s = writeStr(out + n, cap - n, value, vl);
+  if (!s) return 0;
+  if (index) table_.add(name, nl, value, vl);
+  return n + s;
+}
@@ -0,0 +1,144 @@
+// ============================================================
+//  HTTP response cache (see httpcache.h)
+// ============================================================
+
+#include "config.h"
+
+namespace {
+
+HttpCacheEntry    entries[HTTP_CACHE_SLOTS];
+uint32_t          hitsFresh    = 0;
+uint32_t          hits304      = 0;
+uint32_t          avoidedBytes = 0;
+StaticSemaphore_t cacheLockBuf;
+SemaphoreHandle_t cacheLock = xSemaphoreCreateMutexStatic(&cacheLockBuf);
+
+struct CacheGuard {
+  CacheGuard()  { xSemaphoreTake(cacheLock, portMAX_DELAY); }
+  ~CacheGuard() { xSemaphoreGive(cacheLock); }
+};
+
+HttpCacheEntry* find(uint32_t key) {
+  for (auto& e : entries) {
+    if (e.key == key) return &e;
+  }
+  return nullptr;
+}
+
+// max-age minus Age, in ms; 0 for no-cache or when absent
+uint32_t maxAgeMs(const char* cc, uint32_t age) {
+  if (!cc || strcasestr(cc, "no-cache")) return 0;
+  const char* p = strcasestr(cc, "max-age=");
+  if (!p) return 0;
+  long s = atol(p + 8) - (long)age;
+  return s > 0 ? (uint32_t)min(s, 86400L) * 1000UL : 0;
+}
+
+}  // namespace
+
+uint32_t httpCacheKey(const char* host, const char* path) {
+  // FNV-1a over "host" + "path"; 0 is reserved for empty slots
+  uint32_t h = 2166136261u;
+  for (const char* p = host; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+  for (const char* p = path; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+  return h ? h : 1;
+}
+
+bool httpCacheFresh(uint32_t key) {
+  CacheGuard g;
+  HttpCacheEntry* e = find(key);
+  if (!e || !e->maxAgeMs || millis() - e->storedAt >= e->maxAgeMs) return false;
+  hitsFresh++;
+  avoidedBytes += e->bodyBytes;
+  return true;
+}
+
+bool httpCacheLookup(uint32_t key, HttpCacheEntry& out) {
+  CacheGuard g;
+  HttpCacheEntry* e = find(key);
+  if (!e) return false;
+  out = *e;
+  return true;
+}
+
+void httpCacheStore(uint32_t key, const char* etag, const char* lastModified,
+                    const char* cacheControl, uint32_t age, uint32_t bodyBytes) {
+  CacheGuard g;
+  HttpCacheEntry* e = find(key);
+  bool useless = (cacheControl && strcasestr(cacheControl, "no-store")) ||
+                 (!etag && !lastModified && !maxAgeMs(cacheControl, age));
+  if (useless) {
+    if (e) e->key = 0;
+    return;
+  }
+  if (!e) {
+    // Empty slot, else the one stored longest ago
+    e = &entries[0];
+    for (auto& s : entries) {
+      if (!s.key) { e = &s; break; }
+      if ((long)(s.storedAt - e->storedAt) < 0) e = &s;
+    }
+  }
+  e->key = key;
+  strlcpy(e->etag, etag ? etag : "", sizeof(e->etag));
+  strlcpy(e->lastModified, lastModified ? lastModified : "", sizeof(e->lastModified));
+  e->storedAt  = millis();
+  e->maxAgeMs  = maxAgeMs(cacheControl, age);
+  e->bodyBytes = bodyBytes;
+}
+
+void httpCacheNotModified(uint32_t key, const char* cacheControl, uint32_t age) {
+  CacheGuard g;
+  HttpCacheEntry* e = find(key);
+  hits304++;
+  if (!e) return;
+  avoidedBytes += e->bodyBytes;
+  e->storedAt = millis();
+  e->maxAgeMs = maxAgeMs(cacheControl, age);
+}
+
+void httpCacheForget(uint32_t key) {
+  CacheGuard g;
+  if (HttpCacheEntry* e = find(key)) e->key = 0;
+}
+
+void httpCacheForget(const char* host, const char* path) {
+  httpCacheForget(httpCacheKey(host, path));
+}
+
+void httpCacheClear() {
+  CacheGuard g;
+  for (auto& e : entries) e.key = 0;
+}
+
+int httpCacheExport(HttpCacheEntry* out, int max) {
+  CacheGuard g;
+  int n = 0;
+  for (auto& e : entries) {
+    // An entry that is only a max-age means nothing after a reset
+    if (!e.key || (!e.etag[0] && !e.lastModified[0])) continue;
+    if (n == max) break;
+    out[n++] = e;
+  }
+  return n;
+}
+
+void httpCacheImport(const HttpCacheEntry* in, int n) {
+  CacheGuard g;
+  for (int i = 0; i < n && i < HTTP_CACHE_SLOTS; i++) {
+    entries[i]          = in[i];
+    entries[i].storedAt = millis();
+    entries[i].maxAgeMs = 0;   // the max-age clock didn't survive; revalidate
+  }
+}
+
+void httpCacheStats(HttpCacheStats& out) {
+  CacheGuard g;
+  out.fresh        = hitsFresh;
+  out.notModified  = hits304;
+  out.avoidedBytes = avoidedBytes;
+  out.entries      = 0;
+  for (auto& e : entries) {
+    if (e.key) out.entries++;
+  }
+}
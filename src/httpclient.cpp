@@ -0,0 +1,767 @@
+// ============================================================
+//  Minimal HTTP/1.1 client (see httpclient.h)
+// ============================================================
+
+#include "config.h"
+#include <stdarg.h>
+#include <esp_heap_caps.h>
+#include <rom/miniz.h>
+
+// Room kept at the end of the request buffer for Content-Length + CRLF
+#define HTTP_TAIL_RESERVE  32
+
+// ── HttpBody ────────────────────────────────────────────
+
+void HttpBody::reset(long length, bool chunked) {
+  rx        = 0;
+  chunked_  = chunked;
+  chunkLen_ = 0;
+  lineLen_  = 0;
+  left_     = chunked ? 0 : length;
+  if (chunked)         state_ = SIZE;
+  else if (length < 0) state_ = TO_CLOSE;
+  else                 state_ = length > 0 ? DATA : DONE;
+}
+
+int HttpBody::available() {
+  // Chunk framing is consumed here, a byte at a time, so callers only
+  // ever see data bytes
+  while (state_ != DATA && state_ != TO_CLOSE && state_ != DONE && c_->available() > 0) {
+    step(c_->read());
+  }
+  if (state_ == TO_CLOSE) {
+    int n = c_->available();
+    if (n <= 0 && !c_->connected()) state_ = DONE;
+    return max(n, 0);
+  }
+  if (state_ != DATA) return 0;
+  return (int)min((long)c_->available(), left_);
+}
+
+bool HttpBody::cut() {
+  if (state_ == DONE || state_ == TO_CLOSE) return false;
+  return c_->available() <= 0 && !c_->connected();
+}
+
+int HttpBody::read() {
+  if (available() <= 0) return -1;
+  int ch = c_->read();
+  if (ch >= 0) taken(1);
+  return ch;
+}
+
+size_t HttpBody::readBytes(char* buf, size_t n) {
+  int avail = available();
+  if (avail <= 0) return 0;
+  int got = c_->read((uint8_t*)buf, min(n, (size_t)avail));
+  if (got <= 0) return 0;
+  taken(got);
+  return got;
+}
+
+void HttpBody::taken(size_t n) {
+  rx += n;
+  if (state_ != DATA) return;
+  left_ -= n;
+  if (left_ == 0) state_ = chunked_ ? DATA_END : DONE;
+}
+
+void HttpBody::step(int ch) {
+  if (ch < 0) return;
+  rx++;
+  switch (state_) {
+    case SIZE:
+    case SIZE_EXT:
+      if (ch == '\n') {
+        left_     = chunkLen_;
+        chunkLen_ = 0;
+        lineLen_  = 0;
+        state_    = left_ > 0 ? DATA : TRAILER;
+      } else if (state_ == SIZE && isxdigit(ch)) {
+        chunkLen_ = chunkLen_ * 16 + (isdigit(ch) ? ch - '0' : tolower(ch) - 'a' + 10);
+      } else if (ch != '\r') {
+        state_ = SIZE_EXT;     // ";ext=..." — ignored
+      }
+      break;
+    case DATA_END:             // CRLF after the chunk data
+      if (ch == '\n') state_ = SIZE;
+      break;
+    case TRAILER:              // trailer lines until an empty one
+      if (ch == '\n') {
+        if (lineLen_ == 0) state_ = DONE;
+        lineLen_ = 0;
+      } else if (ch != '\r' && lineLen_ < 255) {
+        lineLen_++;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// ── HttpInflate ─────────────────────────────────────────
+// gzip (RFC 1952) is a small header, a raw deflate stream and an
+// 8-byte CRC/size trailer. The header and trailer are walked byte by
+// byte; the deflate stream goes through the ROM's tinfl, whose
+// wrapping output buffer is the 32 KB window itself.
+
+#define GZ_FHCRC     0x02
+#define GZ_FEXTRA    0x04
+#define GZ_FNAME     0x08
+#define GZ_FCOMMENT  0x10
+
+struct HttpInflate::Work {
+  tinfl_decompressor d;
+  uint8_t            window[TINFL_LZ_DICT_SIZE];
+  uint8_t            in[HTTP_INFLATE_IN];
+};
+
+bool HttpInflate::ready() {
+  if (!w_) w_ = (Work*)heap_caps_malloc(sizeof(Work), MALLOC_CAP_SPIRAM);
+  return w_ != nullptr;
+}
+
+void HttpInflate::reset() {
+  out     = 0;
+  flags_  = 0;
+  need_   = 10;   // ID1 ID2 CM FLG MTIME(4) XFL OS
+  inPos_  = inLen_  = 0;
+  outPos_ = outEnd_ = 0;
+  winOfs_ = 0;
+  state_  = w_ ? HDR : FAILED;
+  if (w_) tinfl_init(&w_->d);
+}
+
+// One gzip header byte; false if the stream isn't gzip/deflate
+bool HttpInflate::header(uint8_t b) {
+  switch (state_) {
+    case HDR: {
+      uint8_t i = 10 - need_;
+      if ((i == 0 && b != 0x1f) || (i == 1 && b != 0x8b) || (i == 2 && b != 8)) return false;
+      if (i == 3) flags_ = b;
+      if (--need_) return true;
+      break;
+    }
+    case HDR_XLEN:   // little-endian length of the extra field
+      xlen_ = (need_ == 2) ? b : (uint16_t)(xlen_ | (b << 8));
+      if (--need_) return true;
+      if (xlen_) {
+        state_ = HDR_EXTRA;
+        need_  = xlen_;
+        return true;
+      }
+      flags_ &= ~GZ_FEXTRA;
+      break;
+    case HDR_EXTRA:
+      if (--need_) return true;
+      flags_ &= ~GZ_FEXTRA;
+      break;
+    case HDR_NAME:
+      if (b) return true;
+      flags_ &= ~GZ_FNAME;
+      break;
+    case HDR_COMMENT:
+      if (b) return true;
+      flags_ &= ~GZ_FCOMMENT;
+      break;
+    case HDR_CRC:
+      if (--need_) return true;
+      flags_ &= ~GZ_FHCRC;
+      break;
+    default:
+      return false;
+  }
+  // Next optional field in RFC order, else the deflate stream
+  if (flags_ & GZ_FEXTRA)        { state_ = HDR_XLEN; need_ = 2; }
+  else if (flags_ & GZ_FNAME)    state_ = HDR_NAME;
+  else if (flags_ & GZ_FCOMMENT) state_ = HDR_COMMENT;
+  else if (flags_ & GZ_FHCRC)    { state_ = HDR_CRC; need_ = 2; }
+  else                           { state_ = INFLATE; need_ = 0; }
+  return true;
+}
+
+// Decode more into the window. False when nothing can be produced
+// right now (input not here yet, stream finished, or corrupt).
+bool HttpInflate::fill() {
+  while (state_ != DONE && state_ != FAILED) {
+    if (inPos_ == inLen_) {
+      inPos_ = inLen_ = 0;
+      if (src_.available() > 0) inLen_ = src_.readBytes((char*)w_->in, sizeof(w_->in));
+    }
+    bool starved = inPos_ == inLen_;
+
+    if (state_ == INFLATE) {
+      size_t inSize  = inLen_ - inPos_;
+      size_t outSize = sizeof(w_->window) - winOfs_;
+      uint32_t more  = src_.done() ? 0 : TINFL_FLAG_HAS_MORE_INPUT;
+      tinfl_status st = tinfl_decompress(&w_->d, w_->in + inPos_, &inSize, w_->window,
+                                         w_->window + winOfs_, &outSize, more);
+      inPos_ += inSize;
+      outPos_ = winOfs_;
+      outEnd_ = winOfs_ + outSize;
+      winOfs_ = (winOfs_ + outSize) & (sizeof(w_->window) - 1);
+      if (st < 0)                     state_ = FAILED;
+      else if (st == TINFL_STATUS_DONE) { state_ = TRAILER; need_ = 8; }
+      if (outSize) return true;
+      if (st == TINFL_STATUS_NEEDS_MORE_INPUT && starved) return false;
+      continue;
+    }
+
+    if (starved) {
+      if (src_.done()) state_ = (state_ == TRAILER) ? DONE : FAILED;
+      return false;
+    }
+    uint8_t b = w_->in[inPos_++];
+    if (state_ == TRAILER) {
+      if (--need_ == 0) state_ = DONE;   // CRC32 + ISIZE, not checked
+    } else if (!header(b)) {
+      state_ = FAILED;
+    }
+  }
+  return false;
+}
+
+int HttpInflate::available() {
+  if (outPos_ == outEnd_) fill();
+  return outEnd_ - outPos_;
+}
+
+int HttpInflate::read() {
+  if (available() <= 0) return -1;
+  out++;
+  return w_->window[outPos_++];
+}
+
+size_t HttpInflate::readBytes(char* buf, size_t n) {
+  size_t avail = (size_t)max(available(), 0);
+  if (n > avail) n = avail;
+  memcpy(buf, w_->window + outPos_, n);
+  outPos_ += n;
+  out     += n;
+  return n;
+}
+
+// ── Request ─────────────────────────────────────────────
+
+void HttpClient::collect(const char* const* names, uint8_t count) {
+  want_      = names;
+  wantCount_ = count;
+}
+
+bool HttpClient::append(const char* s) {
+  size_t n = strlen(s);
+  if (reqLen_ + n + HTTP_TAIL_RESERVE > sizeof(req_)) {
+    overflow_ = true;
+    return false;
+  }
+  memcpy(req_ + reqLen_, s, n);
+  reqLen_ += n;
+  return true;
+}
+
+void HttpClient::begin(const char* method, const char* host, const char* path,
+                       NetStats* stats) {
+  // An HTTP/1.1 response still being read is finished first; one on
+  // an HTTP/2 stream carries on beside the new request
+  if (active_ && slot_ < 0) end();
+  strlcpy(host_, host, sizeof(host_));
+  stats_    = stats;
+  reqLen_   = 0;
+  overflow_ = false;
+  noBody_   = strcmp(method, "HEAD") == 0;
+  wantGzip_ = false;
+  cache_    = false;
+  key_      = httpCacheKey(host, path);
+  if (!active_ && !heading_) retryAfter_ = 0;
+  // POST/PUT always carry a length — Spotify answers 411 without one
+  sized_    = strcmp(method, "GET") != 0 && !noBody_;
+  append(method);
+  append(" ");
+  append(path);
+  append(" HTTP/1.1\r\nHost: ");
+  append(host);
+  append("\r\nUser-Agent: ESP32\r\n");
+}
+
+void HttpClient::header(const char* name, const char* value) {
+  append(name);
+  append(": ");
+  append(value);
+  append("\r\n");
+}
+
+void HttpClient::headerf(const char* name, const char* fmt, ...) {
+  append(name);
+  append(": ");
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(req_ + reqLen_, sizeof(req_) - reqLen_, fmt, ap);
+  va_end(ap);
+  if (n < 0 || reqLen_ + n + HTTP_TAIL_RESERVE > sizeof(req_)) {
+    overflow_ = true;
+    return;
+  }
+  reqLen_ += n;
+  append("\r\n");
+}
+
+void HttpClient::acceptGzip() {
+  if (wantGzip_ || !inflate_.ready()) return;
+  header("Accept-Encoding", "gzip");
+  wantGzip_ = !overflow_;
+}
+
+bool HttpClient::useCache() {
+  if (httpCacheFresh(key_)) return true;
+  HttpCacheEntry e;
+  if (httpCacheLookup(key_, e)) {
+    if (e.etag[0])         header("If-None-Match", e.etag);
+    if (e.lastModified[0]) header("If-Modified-Since", e.lastModified);
+  }
+  cache_ = true;
+  return false;
+}
+
+bool HttpClient::connected() {
+  if (c_.h2() && h2_ && h2_->bound(c_) && !h2_->usable() && !pendCount_) c_.stop();
+  if (c_.connected()) return true;
+  dropPipeline();   // whatever was in flight died with the old socket
+  return false;
+}
+
+int HttpClient::h2Room() const {
+  if (!c_.h2() || !h2_ || !h2_->bound(c_) || pendCount_ >= HTTP_PIPELINE_MAX) return 0;
+  return h2_->room();
+}
+
+// Remember what the response will need from this request
+void HttpClient::queue(int8_t slot) {
+  uint8_t i = (pendHead_ + pendCount_++) % HTTP_PIPELINE_MAX;
+  pend_[i] = { cache_ ? key_ : 0, slot, wantGzip_, noBody_, stats_ };
+}
+
+int HttpClient::write(const uint8_t* body, size_t len) {
+  if (overflow_) return HTTP_ERR_TOO_LONG;
+  if (!connected() && !c_.connect(host_, 443)) return HTTP_ERR_CONNECT;
+  if (c_.h2() && !h2Alloc()) {
+    // No memory for a session: reconnect, this time without offering h2
+    c_.stop();
+    if (!c_.connect(host_, 443)) return HTTP_ERR_CONNECT;
+  }
+  // An HTTP/1.1 connection has no use for a session left from an
+  // earlier one; keep it only while its streams are still pending
+  if (h2_ && !c_.h2() && !pendCount_) releaseH2();
+  if (c_.h2()) return writeH2(body, len);
+
+  // Content-Length and the blank line go past reqLen_, so the same
+  // request can be written again after a reconnect. The head and a
+  // small body leave as one TLS record.
+  size_t n = reqLen_;
+  if (len || sized_) {
+    n += snprintf(req_ + n, sizeof(req_) - n, "Content-Length: %u\r\n", (unsigned)len);
+  }
+  n += strlcpy(req_ + n, "\r\n", sizeof(req_) - n);
+  bool together = len && len <= sizeof(req_) - n;
+  if (together) {
+    memcpy(req_ + n, body, len);
+    n += len;
+  }
+
+  size_t sent = c_.write((const uint8_t*)req_, n);
+  bool ok = sent == n;
+  if (ok && len && !together) {
+    size_t b = c_.write(body, len);
+    sent += b;
+    ok = b == len;
+  }
+  if (stats_) stats_->txBytes += sent;
+  if (!ok) {
+    c_.stop();
+    dropPipeline();
+    return HTTP_ERR_SEND;
+  }
+  if (pendCount_ < HTTP_PIPELINE_MAX) queue(-1);
+  if (!sentAt_) sentAt_ = millis();   // first request of a pipelined batch
+  return 0;
+}
+
+// ── HTTP/2 ──────────────────────────────────────────────
+
+bool HttpClient::h2Alloc() {
+  if (!h2_) h2_ = H2Conn::create();
+  if (h2_) return true;
+  LOG("[HTTP] %s: no PSRAM for an HTTP/2 session, staying on HTTP/1.1\n", host_);
+  if (host_[0]) tlsOfferH2(host_, false);
+  return false;
+}
+
+// The head in req_ goes out as a HEADERS frame on a new stream
+int HttpClient::writeH2(const uint8_t* body, size_t len) {
+  if (pendCount_ >= HTTP_PIPELINE_MAX) return HTTP_ERR_SEND;
+  if (!h2_->bound(c_) && !h2_->start(c_)) {
+    c_.stop();
+    dropPipeline();
+    return HTTP_ERR_SEND;
+  }
+  uint32_t wire;
+  int slot = h2_->open(req_, reqLen_, body, len, sized_, millis() + timeoutMs_, wire);
+  if (stats_) stats_->txBytes += wire;
+  if (slot < 0) {
+    // All streams busy leaves the session as it was; a dead one goes
+    if (!h2_->usable()) {
+      c_.stop();
+      dropPipeline();
+    }
+    return slot;
+  }
+  queue(slot);
+  if (!sentAt_) sentAt_ = millis();
+  return 0;
+}
+
+int HttpClient::headH2() {
+  firstByte();
+  status_ = h2_->status(slot_);
+  size_t pos = 0;
+  const char *name, *v;
+  while (h2_->header(slot_, pos, name, v)) onHeader(name, v);
+  // No Content-Length: the body runs to END_STREAM, which the stream
+  // reports as a close
+  chunked_ = false;
+  body_.from(h2_->body(slot_));
+  return headDone();
+}
+
+void HttpClient::releaseH2() {
+  if (!h2_) return;
+  if (active_) end();
+  dropPipeline();   // pending responses may be streams on it
+  body_.from(c_);
+  H2Conn::destroy(h2_);
+  h2_ = nullptr;
+}
+
+bool HttpClient::alive() {
+  if (!c_.h2()) return c_.alive();
+  if (!h2Alloc()) return false;
+  if (!h2_->bound(c_) && !h2_->start(c_)) return false;
+  return h2_->service();
+}
+
+int HttpClient::send(const uint8_t* body, size_t len) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    bool reused = c_.connected();
+    rx_ = 0;
+    int code = write(body, len);
+    if (code == 0) code = readHead();
+    // A keep-alive socket the server closed while idle fails before a
+    // single response byte; anything else is a real answer or error
+    if (code >= 0 || !reused || answered() || code == HTTP_ERR_TOO_LONG) return code;
+    LOG("[HTTP] %s: stale keep-alive (%d), reconnecting\n", host_, code);
+    c_.stop();
+  }
+  return status_;
+}
+
+// ── Response ────────────────────────────────────────────
+
+// Head bytes as they arrive: 1 once line_ holds a whole line, 0 while
+// the rest is on its way, -1 if the connection closed first
+int HttpClient::lineIn() {
+  while (c_.available() > 0) {
+    int ch = c_.read();
+    if (ch < 0) break;
+    rx_++;
+    if (ch == '\n') {
+      if (lineLen_ && line_[lineLen_ - 1] == '\r') lineLen_--;
+      line_[lineLen_] = 0;
+      lineLen_ = 0;
+      return 1;
+    }
+    if (lineLen_ < sizeof(line_) - 1) line_[lineLen_++] = (char)ch;
+  }
+  return c_.connected() ? 0 : -1;
+}
+
+int HttpClient::fail(int err) {
+  bool drop = true;
+  if (slot_ >= 0) {
+    // One stream failed; the others on the session carry on
+    rx_  += h2_->close(slot_);
+    slot_ = -1;
+    drop  = !h2_->usable();
+  }
+  if (respStats_) {
+    respStats_->rxBytes   += rx_;
+    respStats_->rxDecoded += rx_;
+  }
+  if (drop) {
+    c_.stop();
+    dropPipeline();
+  }
+  heading_ = false;
+  body_.reset(0, false);
+  sentAt_  = 0;
+  respKey_ = 0;
+  active_  = false;
+  gzipped_ = false;
+  status_  = err;
+  return err;
+}
+
+int HttpClient::readHead() {
+  unsigned long deadline = millis() + timeoutMs_;
+  for (;;) {
+    int code = pollHead();
+    if (code) return code;
+    if ((long)(millis() - deadline) >= 0) return fail(HTTP_ERR_READ);
+    delay(1);
+  }
+}
+
+// Take the oldest written request off the queue; its response is next
+void HttpClient::startHead() {
+  heading_    = true;
+  rx_         = 0;
+  lineLen_    = 0;
+  hdrCount_   = 0;
+  respKey_    = 0;
+  slot_       = -1;
+  respStats_  = stats_;   // past HTTP_PIPELINE_MAX nothing was queued
+  respGzip_   = wantGzip_;
+  respNoBody_ = noBody_;
+  if (pendCount_) {
+    const Pending& p = pend_[pendHead_];
+    respKey_    = p.key;
+    slot_       = p.slot;
+    respStats_  = p.stats;
+    respGzip_   = p.gzip;
+    respNoBody_ = p.noBody;
+    pendHead_   = (pendHead_ + 1) % HTTP_PIPELINE_MAX;
+    pendCount_--;
+  }
+  respAge_ = 0;
+  respEtag_[0] = respLastMod_[0] = respCC_[0] = 0;
+  newHead();
+  if (slot_ < 0) body_.from(c_);
+}
+
+int8_t HttpClient::stream() const {
+  if (!pendCount_) return -1;
+  return pend_[(pendHead_ + pendCount_ - 1) % HTTP_PIPELINE_MAX].slot;
+}
+
+bool HttpClient::next(int8_t stream) {
+  if (active_ || stream < 0) return false;
+  if (heading_) {
+    if (slot_ == stream) return true;
+    if (slot_ < 0) return false;
+    // An HTTP/2 head not in yet has nothing parsed: back in line it goes
+    pendHead_ = (pendHead_ + HTTP_PIPELINE_MAX - 1) % HTTP_PIPELINE_MAX;
+    pendCount_++;
+    pend_[pendHead_] = { respKey_, slot_, respGzip_, respNoBody_, respStats_ };
+    heading_ = false;
+  }
+  for (uint8_t k = 0; k < pendCount_; k++) {
+    if (pend_[(pendHead_ + k) % HTTP_PIPELINE_MAX].slot != stream) continue;
+    Pending p = pend_[(pendHead_ + k) % HTTP_PIPELINE_MAX];
+    for (; k > 0; k--) {
+      pend_[(pendHead_ + k) % HTTP_PIPELINE_MAX] = pend_[(pendHead_ + k - 1) % HTTP_PIPELINE_MAX];
+    }
+    pend_[pendHead_] = p;
+    return true;
+  }
+  return false;
+}
+
+// Also between a 1xx interim response and the final one
+void HttpClient::newHead() {
+  status_     = 0;
+  length_     = -1;
+  closing_    = false;
+  retryAfter_ = 0;
+  chunked_    = false;
+  encGzip_    = false;
+}
+
+int HttpClient::pollHead() {
+  if (!heading_) startHead();
+  if (slot_ >= 0) {
+    int state = h2_->pollHead(slot_);
+    if (!state) return 0;
+    rx_ = h2_->headWire(slot_);
+    return state > 0 ? headH2() : fail(HTTP_ERR_READ);
+  }
+  for (;;) {
+    int got = lineIn();
+    if (got < 0) return fail(HTTP_ERR_READ);
+    if (!got) return 0;
+    if (!status_) {
+      if (sscanf(line_, "HTTP/1.%*d %d", &status_) != 1) return fail(HTTP_ERR_READ);
+      firstByte();
+      continue;
+    }
+    if (line_[0]) {
+      char* colon = strchr(line_, ':');
+      if (!colon) continue;
+      *colon = 0;
+      const char* v = colon + 1;
+      while (*v == ' ' || *v == '\t') v++;
+      onHeader(line_, v);
+      continue;
+    }
+    // 1xx is interim: the final head follows
+    if (status_ >= 100 && status_ < 200) {
+      newHead();
+      continue;
+    }
+    return headDone();
+  }
+}
+
+void HttpClient::firstByte() {
+  if (!sentAt_) return;
+  tlsNoteFirstByte(host_, millis() - sentAt_);
+  sentAt_ = 0;
+}
+
+void HttpClient::onHeader(const char* name, const char* v) {
+  if (!strcasecmp(name, "Content-Length")) {
+    length_ = atol(v);
+  } else if (!strcasecmp(name, "Transfer-Encoding")) {
+    chunked_ = strcasestr(v, "chunked") != nullptr;
+  } else if (!strcasecmp(name, "Connection")) {
+    closing_ = strcasestr(v, "close") != nullptr;
+  } else if (!strcasecmp(name, "Content-Encoding")) {
+    encGzip_ = strcasestr(v, "gzip") != nullptr;
+  } else if (!strcasecmp(name, "Retry-After")) {
+    retryAfter_ = isdigit((uint8_t)*v) ? atol(v) : 0;   // HTTP-date form not supported
+  } else {
+    for (uint8_t i = 0; i < wantCount_ && hdrCount_ < HTTP_HDR_SLOTS; i++) {
+      if (strcasecmp(name, want_[i])) continue;
+      hdrs_[hdrCount_].name = want_[i];
+      strlcpy(hdrs_[hdrCount_].value, v, sizeof(hdrs_[0].value));
+      hdrCount_++;
+      break;
+    }
+  }
+  if (respKey_) {
+    if (!strcasecmp(name, "ETag"))               strlcpy(respEtag_, v, sizeof(respEtag_));
+    else if (!strcasecmp(name, "Last-Modified")) strlcpy(respLastMod_, v, sizeof(respLastMod_));
+    else if (!strcasecmp(name, "Cache-Control")) strlcpy(respCC_, v, sizeof(respCC_));
+    else if (!strcasecmp(name, "Age"))           respAge_ = atol(v);
+  }
+}
+
+// The head is in: set up the body
+int HttpClient::headDone() {
+  heading_ = false;
+  if (respStats_) {
+    respStats_->rxBytes   += rx_;
+    respStats_->rxDecoded += rx_;
+  }
+
+  if (respNoBody_ || status_ == 204 || status_ == 304) body_.reset(0, false);
+  else                                                  body_.reset(chunked_ ? 0 : length_, chunked_);
+  if (chunked_) length_ = -1;
+  // Only decode what we asked for; contentLength() stays the wire size
+  gzipped_ = encGzip_ && respGzip_ && !body_.done();
+  if (gzipped_) inflate_.reset();
+  if (respKey_ && status_ == 304) {
+    httpCacheNotModified(respKey_, respCC_[0] ? respCC_ : nullptr, respAge_);
+  }
+  active_ = true;
+  return status_;
+}
+
+const char* HttpClient::header(const char* name) const {
+  for (uint8_t i = 0; i < hdrCount_; i++) {
+    if (!strcasecmp(hdrs_[i].name, name)) return hdrs_[i].value;
+  }
+  return nullptr;
+}
+
+void HttpClient::discard() {
+  if (!respKey_) return;
+  httpCacheForget(respKey_);
+  respKey_ = 0;
+}
+
+bool HttpClient::end() {
+  if (!active_) return c_.connected();
+  active_ = false;
+
+  bool     keep;
+  uint32_t wire;
+  if (slot_ >= 0) {
+    // Whatever is left of the body is cancelled, not drained; the
+    // session stays up for the streams still open on it
+    body_.available();   // notices END_STREAM right after the last byte
+    wire  = h2_->close(slot_);
+    slot_ = -1;
+    keep  = h2_->usable() || (pendCount_ && c_.connected());
+  } else {
+    keep = !closing_ && !body_.untilClose();
+    if (keep && !body_.done()) {
+      // Skip a short leftover (error JSON, a field past the last one we
+      // wanted); anything bigger is cheaper to close than to download
+      unsigned long deadline = millis() + 1000;
+      char scratch[64];
+      while (!body_.done() && body_.rx < (uint32_t)HTTP_DRAIN_MAX + 64) {
+        if (body_.readBytes(scratch, sizeof(scratch)) == 0) {
+          if (body_.done() || !c_.connected() || (long)(millis() - deadline) >= 0) break;
+          delay(1);
+        }
+      }
+      keep = body_.done();
+    }
+    wire = body_.rx;
+  }
+  if (respStats_) {
+    respStats_->rxBytes   += wire;
+    respStats_->rxDecoded += gzipped_ ? inflate_.out : body_.rx;
+  }
+  // Only a body that arrived whole may be vouched for by a later 304
+  if (respKey_ && status_ == 200 && body_.done()) {
+    httpCacheStore(respKey_, respEtag_[0] ? respEtag_ : nullptr,
+                   respLastMod_[0] ? respLastMod_ : nullptr,
+                   respCC_[0] ? respCC_ : nullptr, respAge_, body_.rx);
+  }
+  respKey_ = 0;
+  if (!keep) {
+    c_.stop();
+    dropPipeline();
+  }
+  return keep;
+}
+
+void HttpClient::abort() {
+  if (active_) {
+    if (slot_ < 0) c_.stop();
+    end();
+    return;
+  }
+  if (!heading_) {
+    if (!pendCount_) return;
+    startHead();
+  }
+  fail(HTTP_ERR_READ);
+}
+
+// ── URL helpers ─────────────────────────────────────────
+
+void urlHost(const char* url, char* out, size_t n) {
+  const char* p = strstr(url, "://");
+  p = p ? p + 3 : url;
+  size_t len = strcspn(p, ":/?");
+  if (len >= n) len = n - 1;
+  memcpy(out, p, len);
+  out[len] = 0;
+}
+
+const char* urlPath(const char* url) {
+  const char* p = strstr(url, "://");
+  p = p ? p + 3 : url;
+  p += strcspn(p, "/?");
+  return *p == '/' ? p : "/";
+}
@@ -0,0 +1,346 @@
+// ============================================================
+//  Streaming JSON field extractor (see jsonpull.h)
+// ============================================================
+
+#include "jsonpull.h"
+
+namespace {
+
+// ── Buffered byte source over a Stream or a buffer ──────
+// Only ever asks for bytes that are already available, so it never
+// blocks past the end of a keep-alive response body. A buffer is read
+// in place.
+class Reader {
+ public:
+  Reader(Stream& s, uint32_t timeoutMs) : s_(&s), timeoutMs_(timeoutMs), data_(buf_) {}
+  Reader(const uint8_t* buf, size_t len) : data_(buf), len_(buf ? len : 0) {}
+
+  int next() {
+    if (pos_ == len_ && !fill()) return -1;
+    return data_[pos_++];
+  }
+
+  // One byte of pushback — only valid directly after a successful next()
+  void unread() { if (pos_ > 0) pos_--; }
+
+  int nextNonWs() {
+    int c;
+    do { c = next(); } while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+    return c;
+  }
+
+ private:
+  bool fill() {
+    if (!s_) return false;
+    unsigned long start = millis();
+    while (true) {
+      int avail = s_->available();
+      if (avail > 0) {
+        len_ = s_->readBytes((char*)buf_, min((size_t)avail, sizeof(buf_)));
+        pos_ = 0;
+        if (len_ > 0) return true;
+      }
+      if (millis() - start >= timeoutMs_) return false;
+      delay(1);
+    }
+  }
+
+  Stream*        s_ = nullptr;
+  uint32_t       timeoutMs_ = 0;
+  uint8_t        buf_[128];
+  const uint8_t* data_;
+  size_t         pos_ = 0;
+  size_t         len_ = 0;
+};
+
+// ── Path-tracking pull parser ───────────────────────────
+class Parser {
+ public:
+  Parser(Reader& r, JsonField* fields, size_t count)
+    : r_(r), fields_(fields), count_(count) { path_[0] = 0; }
+
+  bool run();
+
+ private:
+  struct Frame {
+    uint8_t  base;    // path length of the container itself
+    bool     array;
+    uint16_t index;
+  };
+
+  void setLen(size_t len) { plen_ = len; path_[len] = 0; }
+
+  // Path no longer fits — poison it so nothing below can match
+  void overflow() {
+    plen_ = JSON_PATH_MAX;
+    path_[JSON_PATH_MAX - 1] = '\x01';
+    path_[JSON_PATH_MAX] = 0;
+  }
+
+  void appendIndex(uint16_t i) {
+    char tmp[8];
+    int k = snprintf(tmp, sizeof(tmp), "[%u]", i);
+    if (plen_ + k > JSON_PATH_MAX) { overflow(); return; }
+    memcpy(path_ + plen_, tmp, k + 1);
+    plen_ += k;
+  }
+
+  JsonField* match() {
+    for (size_t i = 0; i < count_; i++) {
+      if (strcmp(fields_[i].path, path_) == 0) return &fields_[i];
+    }
+    return nullptr;
+  }
+
+  // Could any declared path live below the container at path_?
+  bool reachable() const {
+    for (size_t i = 0; i < count_; i++) {
+      const char* p = fields_[i].path;
+      if (strncmp(p, path_, plen_) != 0) continue;
+      char nx = p[plen_];
+      if (nx == '.' || nx == '[' || (plen_ == 0 && nx)) return true;
+    }
+    return false;
+  }
+
+  bool readHex4(uint32_t& out);
+  bool readString(char* dst, size_t cap, size_t* outLen);
+  bool readKey();
+  bool skipContainer();
+  bool scalar(int c);
+
+  Reader&    r_;
+  JsonField* fields_;
+  size_t     count_;
+  char       path_[JSON_PATH_MAX + 1];
+  size_t     plen_  = 0;
+  Frame      stack_[JSON_DEPTH_MAX];
+  int        depth_ = 0;
+};
+
+bool Parser::readHex4(uint32_t& out) {
+  out = 0;
+  for (int i = 0; i < 4; i++) {
+    int c = r_.next();
+    out <<= 4;
+    if (c >= '0' && c <= '9')      out |= c - '0';
+    else if (c >= 'a' && c <= 'f') out |= c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F') out |= c - 'A' + 10;
+    else return false;
+  }
+  return true;
+}
+
+// Decode a string body (opening quote already consumed). With dst ==
+// nullptr the string is only skipped. *outLen receives the full decoded
+// length even when it did not fit.
+bool Parser::readString(char* dst, size_t cap, size_t* outLen) {
+  size_t n = 0;
+  auto put = [&](uint8_t ch) {
+    if (dst && n + 1 < cap) dst[n] = (char)ch;
+    n++;
+  };
+
+  while (true) {
+    int c = r_.next();
+    if (c < 0) return false;
+    if (c == '"') break;
+    if (c != '\\') { put(c); continue; }
+
+    int e = r_.next();
+    switch (e) {
+      case '"': case '\\': case '/': put(e); break;
+      case 'b': put('\b'); break;
+      case 'f': put('\f'); break;
+      case 'n': put('\n'); break;
+      case 'r': put('\r'); break;
+      case 't': put('\t'); break;
+      case 'u': {
+        uint32_t cp;
+        if (!readHex4(cp)) return false;
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+          uint32_t lo;
+          if (r_.next() != '\\' || r_.next() != 'u' || !readHex4(lo)) return false;
+          if (lo < 0xDC00 || lo > 0xDFFF) return false;
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+        }
+        if (cp < 0x80) {
+          put(cp);
+        } else if (cp < 0x800) {
+          put(0xC0 | (cp >> 6));
+          put(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+          put(0xE0 | (cp >> 12));
+          put(0x80 | ((cp >> 6) & 0x3F));
+          put(0x80 | (cp & 0x3F));
+        } else {
+          put(0xF0 | (cp >> 18));
+          put(0x80 | ((cp >> 12) & 0x3F));
+          put(0x80 | ((cp >> 6) & 0x3F));
+          put(0x80 | (cp & 0x3F));
+        }
+        break;
+      }
+      default: return false;
+    }
+  }
+
+  if (dst && cap) {
+    size_t w = (n < cap) ? n : cap - 1;
+    if (n >= cap && w > 0) {
+      // Truncated — don't leave half a UTF-8 sequence at the end
+      size_t i = w - 1;
+      while (i > 0 && ((uint8_t)dst[i] & 0xC0) == 0x80) i--;
+      uint8_t lead = (uint8_t)dst[i];
+      size_t need = (lead < 0x80) ? 1 : (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : 2;
+      if (i + need > w) w = i;
+    }
+    dst[w] = 0;
+  }
+  if (outLen) *outLen = n;
+  return true;
+}
+
+// Read an object key (opening quote consumed) onto the path, then ':'
+bool Parser::readKey() {
+  size_t l = plen_;
+  if (l > 0 && l < JSON_PATH_MAX) path_[l++] = '.';
+  size_t n = 0;
+  if (!readString(path_ + l, sizeof(path_) - l, &n)) return false;
+  if (l + n > JSON_PATH_MAX) overflow();
+  else plen_ = l + n;
+  return r_.nextNonWs() == ':';
+}
+
+// Skip the rest of a container whose opening bracket was consumed
+bool Parser::skipContainer() {
+  int depth = 1;
+  while (depth > 0) {
+    int c = r_.next();
+    if (c < 0) return false;
+    if (c == '"') {
+      if (!readString(nullptr, 0, nullptr)) return false;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      depth--;
+    }
+  }
+  return true;
+}
+
+bool Parser::scalar(int c) {
+  JsonField* f = match();
+
+  if (c == '"') {
+    if (f && f->type == JF_STR) {
+      if (!readString((char*)f->dst, f->cap, nullptr)) return false;
+      f->found = true;
+      return true;
+    }
+    return readString(nullptr, 0, nullptr);
+  }
+
+  if (c == '-' || (c >= '0' && c <= '9')) {
+    char tok[32];
+    size_t n = 0;
+    bool isReal = false;
+    while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' ||
+           (c >= '0' && c <= '9')) {
+      if (c == '.' || c == 'e' || c == 'E') isReal = true;
+      if (n < sizeof(tok) - 1) tok[n++] = (char)c;
+      c = r_.next();
+    }
+    if (c >= 0) r_.unread();
+    else if (depth_ > 0) return false;
+    tok[n] = 0;
+    if (f && f->type == JF_INT) {
+      *(int*)f->dst = isReal ? (int)strtod(tok, nullptr) : (int)strtol(tok, nullptr, 10);
+      f->found = true;
+    } else if (f && f->type == JF_FLOAT) {
+      *(float*)f->dst = strtof(tok, nullptr);
+      f->found = true;
+    }
+    return true;
+  }
+
+  if (c == 't' || c == 'f' || c == 'n') {
+    const char* rest = (c == 't') ? "rue" : (c == 'f') ? "alse" : "ull";
+    for (; *rest; rest++) {
+      if (r_.next() != *rest) return false;
+    }
+    if (f && f->type == JF_BOOL && c != 'n') {
+      *(bool*)f->dst = (c == 't');
+      f->found = true;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+bool Parser::run() {
+  while (true) {
+    // ── Expecting a value at path_ ──
+    int c = r_.nextNonWs();
+    if (c < 0) return false;
+
+    if (c == '{' || c == '[') {
+      bool arr = (c == '[');
+      if (!reachable()) {
+        if (!skipContainer()) return false;
+      } else {
+        if (depth_ >= JSON_DEPTH_MAX) return false;
+        stack_[depth_++] = { (uint8_t)plen_, arr, 0 };
+        int d = r_.nextNonWs();
+        if (d < 0) return false;
+        if (d == (arr ? ']' : '}')) {
+          depth_--;                       // empty container
+        } else if (arr) {
+          r_.unread();
+          appendIndex(0);
+          continue;
+        } else if (d == '"') {
+          if (!readKey()) return false;
+          continue;
+        } else {
+          return false;
+        }
+      }
+    } else if (!scalar(c)) {
+      return false;
+    }
+
+    // ── A value just finished: advance or close containers ──
+    while (true) {
+      if (depth_ == 0) return true;
+      Frame& top = stack_[depth_ - 1];
+      setLen(top.base);
+      int d = r_.nextNonWs();
+      if (d == ',') {
+        if (top.array) {
+          appendIndex(++top.index);
+        } else if (r_.nextNonWs() != '"' || !readKey()) {
+          return false;
+        }
+        break;
+      }
+      if (d != (top.array ? ']' : '}')) return false;
+      depth_--;
+    }
+  }
+}
+
+}  // namespace
+
+bool jsonExtract(Stream& in, JsonField* fields, size_t count, uint32_t timeoutMs) {
+  Reader r(in, timeoutMs);
+  Parser p(r, fields, count);
+  return p.run();
+}
+
+bool jsonExtract(const uint8_t* buf, size_t len, JsonField* fields, size_t count) {
+  Reader r(buf, len);
+  Parser p(r, fields, count);
+  return p.run();
+}
@@ -23,14 +23,19 @@
 //   Open http://<device-ip> in browser to manage tickers
 //
 //  ARCHITECTURE:
-//   Core 0 — background: Spotify API, ticker fetches, WiFi
+//   Core 0 — background: Spotify API, prices, WiFi; every request a
+//            transfer in one select()-driven reactor
 //   Core 1 — foreground: all rendering, button handling, scrolling
+//   Core 0 owns playback/ticker state and publishes snapshots via
+//   SeqLock; core 1, web handlers and the TUI read them lock-free.
 // ============================================================
 
 #include "config.h"
 #include <WiFiManager.h>
 #include <time.h>
+#include <esp_sntp.h>
 #include <esp_task_wdt.h>
+#include <esp_heap_caps.h>
 #include <mbedtls/base64.h>
 
 // ── Credentials ─────────────────────────────────────────
@@ -60,14 +65,11 @@ const CommodityMap COMMODITY_MAP[] = {
 
 // ── Global object definitions ───────────────────────────
 TFT_eSPI    tft;
-Spotify*    sp          = nullptr;
 OneButton   topBtn(BTN_TOP,    true, true);
 OneButton   botBtn(BTN_BOTTOM, true, true);
 Preferences prefs;
 WiFiManager wm;
 
-SemaphoreHandle_t dataMutex;
-
 bool          spotifyReady   = false;
 uint8_t       screenRotation = 1;
 bool          screenOn       = true;
@@ -76,9 +78,17 @@ uint8_t       brightIdle     = 8;
 uint8_t       brightCurrent  = 16;
 unsigned long brightSettingsAt = 0;
 static uint8_t blLevel       = 0;     // Backlight chip state: 0=off, 1-16
-Playback      now;
 float         cpuTempC       = 0;
 
+// Playback state: `now` is core 0's working copy, published through
+// playbackPub; `view` is the snapshot core 1 renders from.
+static Playback     now;
+SeqLock<Playback>   playbackPub;
+Playback            view;
+static uint32_t     viewGen = 0;
+bool                viewStale = false;
+static bool         warmOnScreen = false;   // setup(): warm-boot screen not painted over
+
 // T-Display S3 backlight uses a one-wire pulse protocol (NOT PWM).
 // The chip has 16 brightness levels. Each LOW→HIGH pulse decrements
 // by one step (wrapping from 1 back to 16). Pulling LOW for >3ms resets to off.
@@ -134,6 +144,9 @@ String        lastTimeStr    = "";
 TFT_eSprite   tickerSpr(&tft);
 TickerItem    tickerItems[MAX_TICKERS];
 int           numTickers       = 0;
+SeqLock<TickerList> tickerPub;
+TickerList    tickerView       = {};
+static uint32_t tickerViewGen  = 0;
 int           tickerTextW      = 0;
 int           tickerScrollX    = 0;
 unsigned long lastTickerScroll = 0;
@@ -141,17 +154,15 @@ bool          tickerReady      = false;
 String        stockApiKey;
 
 // Threading
-volatile uint32_t      redrawFlags    = 0;
-volatile PendingAction pendingAction  = ACTION_NONE;
+std::atomic<uint32_t>  redrawFlags{0};
 volatile bool          tickerListChanged = false;
 volatile bool          settingsChanged   = false;
+volatile bool          tlsBenchRequested = false;
 
-// Data usage counters (session total). HTTPClient doesn't expose wire bytes,
-// so TX is estimated from URL + headers + POST body; RX uses getSize() for
-// body plus a ~250 B fudge for response headers on 200s, or ~200 B on 304.
-NetStats netSpotify = {0, 0};
-NetStats netArt     = {0, 0};
-NetStats netTicker  = {0, 0};
+// Data usage counters (session total), credited by HttpClient
+NetStats netSpotify;
+NetStats netArt;
+NetStats netTicker;
 
 // CPU usage tracking (per-core busy time measurement)
 static unsigned long cpuLastReport     = 0;
@@ -159,368 +170,1083 @@ static unsigned long core1BusyUs       = 0;
 static unsigned long core0BusyUs       = 0;
 #define CPU_REPORT_MS 5000
 
+// ── Boot timeline ──
+// Once Wi-Fi is up, boot runs as overlapping stages: core 0 fetches the
+// token and first poll while core 1 builds sprites, paints and starts
+// the config server; NTP settles on its own. Each stage records when it
+// started and finished (millis(), 0 = not yet); a stage with no start is
+// a milestone counted from power-on.
+enum BootStage : uint8_t { BOOT_WIFI, BOOT_NTP, BOOT_TOKEN, BOOT_POLL, BOOT_SPRITES,
+                           BOOT_PAINT, BOOT_SERVER, BOOT_PRICES, BOOT_TRACK, BOOT_STAGES };
+static const char* const BOOT_NAMES[BOOT_STAGES] = {
+  "wifi", "ntp", "token", "poll", "sprites", "paint", "server", "prices", "track" };
+static unsigned long bootStartAt[BOOT_STAGES];
+static unsigned long bootEndAt[BOOT_STAGES];
+static bool          bootLogged = false;
+#define BOOT_REPORT_MS 20000   // log the timeline by now even if a stage never ran
+
+// First occurrence only — later refreshes and polls don't move the marks
+static void bootBegin(BootStage s) { if (!bootStartAt[s]) bootStartAt[s] = max(millis(), 1UL); }
+static void bootEnd(BootStage s)   { if (!bootEndAt[s]) bootEndAt[s] = max(millis(), 1UL); }
+
+// SNTP task: the first sync ends the NTP stage
+static std::atomic<unsigned long> ntpSyncedAt{0};
+static void onTimeSync(struct timeval*) {
+  bootEnd(BOOT_NTP);
+  ntpSyncedAt = millis();
+}
+
+// Log the timeline once every stage is done, or at BOOT_REPORT_MS
+static void logBootTimeline(unsigned long ms) {
+  bool all = true;
+  for (int i = 0; i < BOOT_STAGES; i++) all = all && bootEndAt[i];
+  if (!all && ms < BOOT_REPORT_MS) return;
+  bootLogged = true;
+  LOGLN("[Boot] Timeline (ms since power-on):");
+  for (int i = 0; i < BOOT_STAGES; i++) {
+    if (!bootEndAt[i]) {
+      LOG("[Boot]   %-8s -\n", BOOT_NAMES[i]);
+      continue;
+    }
+    LOG("[Boot]   %-8s %6lu -> %6lu  (%lu)\n", BOOT_NAMES[i], bootStartAt[i], bootEndAt[i],
+        bootEndAt[i] - bootStartAt[i]);
+  }
+}
+
 // Background task timing (owned by core 0)
 static unsigned long bgLastPoll       = 0;
 static unsigned long bgLastTickerFetch = 0;
-static unsigned long bgLastWifi       = 0;
 static bool          bgTickerFetchNeeded = true;  // fetch on first idle
 
-// ── Persistent Spotify polling client (keep-alive TLS) ──
-static WiFiClientSecure pollClient;
-static HTTPClient       pollHttp;
-static bool             pollClientInit = false;
-static String           accessToken;
-static String           lastETag;
-static const char*      etagHeader = "ETag";
+// ── Spotify polling state (connection comes from the pool) ──
+static char             accessToken[ACCESS_TOKEN_MAX] = "";
+
+// ── Access token lifetime ──
+// The token is refreshed ahead of expiry from the background loop, while
+// the keep-alive poll and art sessions stay up if the pool budget allows.
+static unsigned long tokenExpiresAt   = 0;   // millis(); 0 = unknown
+static unsigned long tokenLastAttempt = 0;
+static uint16_t      tokenRefreshes   = 0;
+static uint16_t      tokenDeferred    = 0;   // attempts refused by the pool budget
+static bool          tokenWarm        = false; // carried over a reset (RTC)
+
+// ── Adaptive poll scheduling (core 0) ───────────────────
+// Mid-track the bar is interpolated locally, so polls are sparse; they
+// tighten around the predicted end of track and after user activity,
+// and back off while the server keeps answering 304.
+static std::atomic<unsigned long> pollActivityAt{0};
+static uint8_t       poll304Streak   = 0;
+static unsigned long pollIntervalMs  = POLL_MS;   // last computed (TUI)
+static unsigned long pollLastDoneAt  = 0;
+static uint16_t      pollMinuteCount[60];        // requests per minute, last hour
+static uint32_t      pollMinuteId[60];
+static unsigned long trackLagLastMs  = 0;        // track-change detection latency
+static unsigned long trackLagSumMs   = 0;
+static uint32_t      trackLagCount   = 0;
+
+// ── Playback action queue ──
+// Presses are timestamped into one SPSC ring per producer. Core 0 drains
+// both in press order once a burst has settled and folds them into one
+// net intent: three skips become "skip 3", play/pause toggles cancel out,
+// and only the last seek / volume survives.
+struct ActionEvent {
+  PendingAction action;
+  int           arg;
+  unsigned long at;
+};
+static SpscRing<ActionEvent, ACTION_QUEUE_LEN> buttonActions;
+static SpscRing<ActionEvent, ACTION_QUEUE_LEN> webActions;
+static std::atomic<unsigned long> actionLastPushAt{0};
+static std::atomic<uint16_t>      actionDrops{0};
+static uint16_t      actionDepthMax  = 0;
+static uint32_t      actionMerged    = 0;        // events that needed no request of their own
+static uint32_t      actionFailed    = 0;        // events whose request failed or was never sent
+
+// ── Action confirmation (core 0) ──
+// After a batch is accepted, polls run at ACTION_CONFIRM_MS until the
+// server-side state reflects it. Latency is measured from the first press.
+struct ActionConfirm {
+  unsigned long pressedAt;
+  char          fromTrack[24];
+  int           fromProgress;
+  int           steps;          // net skips (+) / previous (-)
+  int8_t        playing;        // expected play state, -1 = don't care
+  int           seek;           // expected position, -1 = don't care
+  bool          pending;
+};
+static ActionConfirm actionConfirm   = {};
+static unsigned long actionRttLastMs = 0;        // last batch's request time
+static unsigned long actionLatLastMs = 0;        // press → confirmed
+static unsigned long actionLatSumMs  = 0;
+static uint32_t      actionLatCount  = 0;
+static uint16_t      actionUnconfirmed = 0;
+
+void notePollActivity() {
+  pollActivityAt = millis();
+  powerNoteActivity();
+}
+
+static void countPollRequest() {
+  uint32_t minute = millis() / 60000;
+  int slot = minute % 60;
+  if (pollMinuteId[slot] != minute) {
+    pollMinuteId[slot] = minute;
+    pollMinuteCount[slot] = 0;
+  }
+  pollMinuteCount[slot]++;
+}
+
+static uint32_t pollRequestsLastHour() {
+  uint32_t minute = millis() / 60000;
+  uint32_t total = 0;
+  for (int i = 0; i < 60; i++) {
+    if (minute - pollMinuteId[i] < 60) total += pollMinuteCount[i];
+  }
+  return total;
+}
+
+// Delay after `lastPoll` before the next poll is due
+static unsigned long nextPollInterval(unsigned long lastPoll) {
+  if (actionConfirm.pending) {
+    if (millis() - actionConfirm.pressedAt < ACTION_CONFIRM_MAX_MS) return ACTION_CONFIRM_MS;
+    actionConfirm.pending = false;
+    actionUnconfirmed++;
+    LOG("[Action] Not confirmed after %dms\n", ACTION_CONFIRM_MAX_MS);
+  }
+  bool recent = millis() - pollActivityAt < POLL_ACTIVITY_MS;
+  if (!now.active) return (powerLow() && !recent) ? POLL_LOW_MS : POLL_IDLE_MS;
+  if (recent) return POLL_MS;
+
+  unsigned long interval = now.playing ? POLL_MID_MS : POLL_PAUSED_MS;
+  interval = min(interval << min<uint8_t>(poll304Streak, 3), (unsigned long)POLL_MAX_MS);
+
+  if (now.playing && now.duration > 0) {
+    // Land a poll just after the predicted track end; keep polling
+    // tightly once past it until the change shows up.
+    long endAt    = (long)(now.pollTime + (now.duration - now.progress) + POLL_END_MARGIN_MS);
+    long untilEnd = endAt - (long)lastPoll;
+    if (untilEnd < (long)interval) interval = max(untilEnd, (long)POLL_MS);
+  }
+  return interval;
+}
+
+// Called on a track change seen by a poll (before `now` is overwritten).
+// `prevPoll` is when the previous poll completed.
+static void recordTrackChangeLatency(unsigned long seenAt, unsigned long prevPoll) {
+  unsigned long lag;
+  long predictedEnd = (long)(now.pollTime + (now.duration - now.progress));
+  if (now.playing && now.duration > 0 && (long)seenAt >= predictedEnd) {
+    lag = seenAt - predictedEnd;          // natural end of track
+  } else {
+    lag = seenAt - prevPoll;              // skipped elsewhere: upper bound
+  }
+  trackLagLastMs = lag;
+  trackLagSumMs += lag;
+  trackLagCount++;
+}
 
-// ── JSON filter for Spotify response (built once) ───────
-static JsonDocument     pollFilter;
-static bool             pollFilterInit = false;
+// Does a freshly parsed state show the pending action took effect?
+static void checkActionConfirmed(const Playback& p) {
+  if (!actionConfirm.pending) return;
+  const ActionConfirm& a = actionConfirm;
+  bool changed = strcmp(p.trackId, a.fromTrack) != 0;
+  // "previous" may restart the current track instead of changing it
+  if (a.steps > 0 && !changed) return;
+  if (a.steps < 0 && !changed && p.progress + 1000 >= a.fromProgress) return;
+  if (a.playing >= 0 && p.playing != (bool)a.playing) return;
+  if (a.seek >= 0 && abs(p.progress - a.seek) >= 2000) return;
+
+  actionConfirm.pending = false;
+  actionLatLastMs = millis() - a.pressedAt;
+  actionLatSumMs += actionLatLastMs;
+  actionLatCount++;
+  LOG("[Action] Confirmed %lums after press\n", actionLatLastMs);
+}
 
 // ── Build "Basic <base64(client_id:client_secret)>" auth header value
-String buildSpotifyBasicAuth() {
-  String creds = String(SPOTIFY_CLIENT_ID) + ":" + String(SPOTIFY_CLIENT_SECRET);
-  char b64[256];
+void buildSpotifyBasicAuth(char* out, size_t n) {
+  char creds[80];
+  int len = snprintf(creds, sizeof(creds), "%s:%s", SPOTIFY_CLIENT_ID, SPOTIFY_CLIENT_SECRET);
   size_t outLen = 0;
-  mbedtls_base64_encode((unsigned char*)b64, sizeof(b64), &outLen,
-                        (const unsigned char*)creds.c_str(), creds.length());
-  b64[outLen] = 0;
-  return String("Basic ") + b64;
+  int pre = snprintf(out, n, "Basic ");
+  if (mbedtls_base64_encode((unsigned char*)out + pre, n - pre, &outLen,
+                            (const unsigned char*)creds, len) != 0) outLen = 0;
+  out[pre + outLen] = 0;
 }
 
 // ── Refresh the Spotify access token ────────────────────
-static bool refreshAccessToken() {
-  LOGLN("[Token] Refreshing access token...");
-  // Free mbedtls memory held by our keep-alive TLS sockets — the token
-  // handshake needs ~30KB and the ESP32 can't allocate it while we hold
-  // poll + art contexts (each ~30KB) alongside the library's own client.
-  stopAlbumArtClient();
-  pollHttp.end();
-  pollClient.stop();
-  pollClientInit = false;
-  lastETag = "";
-
-  WiFiClientSecure tokenClient;
-  tokenClient.setInsecure();
-  HTTPClient http;
-  http.begin(tokenClient, "https://accounts.spotify.com/api/token");
-  http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-  http.addHeader("Authorization", buildSpotifyBasicAuth());
-
-  String rtoken = prefs.getString("rtoken", "");
-  String body = "grant_type=refresh_token&refresh_token=" + rtoken;
-  netSpotify.txBytes += body.length() + 48 /*URL path*/ + REQ_HDR_EST + 64 /*Basic auth*/;
-  int code = http.POST(body);
-  int rxSz = http.getSize();
-  if (rxSz > 0) netSpotify.rxBytes += (uint32_t)rxSz + RESP_HDR_EST;
-  else netSpotify.rxBytes += RESP_HDR_EST;
+// A reactor transfer; polls and presses hold off while it runs (their
+// due() says never). The token endpoint is used once an hour, so its
+// session is closed after the request. With `mayEvict` false the pool
+// refuses (and the refresh is deferred) rather than closing a hot
+// session to make room. The current token and cached validators
+// survive a failure, unless the API has `rejected` the token: then
+// there is none to keep. A poll waiting for the token goes as soon
+// as it is in.
+static bool tokenBusy     = false;
+static bool tokenRejected = false;
+static bool tokenThenPoll = false;
+static char tokenAuth[128];
+static char tokenBody[REFRESH_TOKEN_MAX + 48];
+
+static void tokenHeaders(HttpClient& http, void*) {
+  http.header("Content-Type", "application/x-www-form-urlencoded");
+  http.header("Authorization", tokenAuth);
+}
 
+static void onToken(int code, uint8_t* body, size_t len, void*) {
+  tokenBusy = false;
+  bootEnd(BOOT_TOKEN);
+  bool ok = false;
   if (code == 200) {
-    JsonDocument doc;
-    deserializeJson(doc, http.getStream());
-    accessToken = doc["access_token"] | "";
-    // Spotify may issue a new refresh token
-    const char* newRt = doc["refresh_token"] | (const char*)nullptr;
-    if (newRt && strlen(newRt) > 0) {
-      prefs.putString("rtoken", newRt);
-      LOGLN("[Token] New refresh token saved");
+    char newAt[ACCESS_TOKEN_MAX];
+    char newRt[REFRESH_TOKEN_MAX];
+    int  expiresIn = 3600;
+    JsonField fields[] = {
+      jsonStr("access_token",  newAt, sizeof(newAt)),
+      jsonStr("refresh_token", newRt, sizeof(newRt)),
+      jsonInt("expires_in",    &expiresIn),
+    };
+    if (!jsonExtract(body, len, fields, 3)) {
+      LOGLN("[Token] Malformed token response");
+    }
+    if (newAt[0]) {
+      // Swap in place — the next poll picks it up on the same connection
+      // and keeps sending the ETag (it names the resource, not the token).
+      memcpy(accessToken, newAt, sizeof(accessToken));
+      tokenExpiresAt = millis() + (unsigned long)max(expiresIn, 60) * 1000UL;
+      tokenRefreshes++;
+      // Spotify may issue a new refresh token
+      if (newRt[0]) {
+        prefs.putString("rtoken", newRt);
+        LOGLN("[Token] New refresh token saved");
+      }
+      LOG("[Token] Access token obtained (%u chars, %ds)\n",
+          (unsigned)strlen(accessToken), expiresIn);
+      ok = true;
     }
-    http.end();
-    LOG("[Token] Access token obtained (%d chars)\n", accessToken.length());
-    return accessToken.length() > 0;
+  } else {
+    LOG("[Token] Refresh failed: %d\n", code);
+  }
+  free(body);
+
+  if (!ok && tokenRejected) accessToken[0] = 0;
+  if (ok && tokenThenPoll) bgLastPoll = 0;
+  tokenRejected = false;
+  tokenThenPoll = false;
+}
+
+// True if a refresh is under way (this one or one already running)
+static bool refreshAccessToken(bool mayEvict = true, bool rejected = false) {
+  if (tokenBusy) {
+    tokenRejected |= rejected;
+    return true;
+  }
+  tokenLastAttempt = millis();
+  buildSpotifyBasicAuth(tokenAuth, sizeof(tokenAuth));
+  snprintf(tokenBody, sizeof(tokenBody), "grant_type=refresh_token&refresh_token=%s",
+           prefs.getString("rtoken", "").c_str());
+  FetchReq req = { SPOTIFY_ACCOUNTS_HOST, "/api/token", "POST", tokenBody, PRIO_SPOTIFY,
+                   EP_SPOTIFY_ACCOUNTS, &netSpotify, schedBudget(),
+                   (uint8_t)(FETCH_CLOSE | (mayEvict ? 0 : FETCH_NO_EVICT)), tokenHeaders };
+  if (!fetchRequest(req, onToken)) {
+    // Accounts service backing off, or no room for its session
+    tokenDeferred++;
+    LOGLN("[Token] Deferred");
+    bootEnd(BOOT_TOKEN);
+    if (rejected) accessToken[0] = 0;
+    return false;
   }
+  LOGLN("[Token] Refreshing access token...");
+  tokenBusy     = true;
+  tokenRejected = rejected;
+  return true;
+}
+
+// Housekeeping job: refresh a few minutes before expiry without
+// evicting anything, and only force it once the token is about to
+// lapse. Until then it waits for a radio window (a poll).
+static long tokenDue() {
+  if (!wifiUp() || !spotifyReady || !accessToken[0] || !tokenExpiresAt || tokenBusy) return SCHED_NEVER;
+  unsigned long ms = millis();
+  long left = (long)(tokenExpiresAt - ms);
+  long wait = max(left - (long)TOKEN_REFRESH_LEAD_MS, (long)TOKEN_RETRY_MS - (long)(ms - tokenLastAttempt));
+  if (wait > 0) return wait;
+  return batchRun(JOB_TOKEN, (long)TOKEN_REFRESH_LEAD_MS - left,
+                  TOKEN_REFRESH_LEAD_MS - TOKEN_RETRY_MS * 2) ? 0 : SCHED_IDLE_MS;
+}
 
-  LOG("[Token] Refresh failed: %d\n", code);
-  http.end();
-  return false;
+static bool tokenRun() {
+  refreshAccessToken((long)(tokenExpiresAt - millis()) < (long)TOKEN_RETRY_MS * 2);
+  return true;
 }
 
 // ============================================================
-//  Spotify data fetch (runs on core 0 — no drawing!)
-//  Uses persistent TLS connection, ETag caching, and stream
-//  parsing with a JSON filter for minimal memory usage.
+//  Playback control (runs on core 0)
+//  Verbs go out on the keep-alive poll connection, so a press costs
+//  one request on a warm TLS session instead of a fresh handshake.
+//  Each is a reactor transfer; `done` gets the HTTP status.
 // ============================================================
-static void pollSpotifyData() {
-  if (!spotifyReady) return;
+static const char* PLAYER_PATH = "/v1/me/player";
 
-  // One-time init: persistent TLS client + JSON filter
-  if (!pollClientInit) {
-    pollClient.setInsecure();
-    pollHttp.setReuse(true);
-    pollHttp.setTimeout(10000);
-    pollHttp.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-    pollHttp.collectHeaders(&etagHeader, 1);
-    pollClientInit = true;
-  }
-  if (!pollFilterInit) {
-    pollFilter["progress_ms"] = true;
-    pollFilter["is_playing"] = true;
-    pollFilter["item"]["id"] = true;
-    pollFilter["item"]["name"] = true;
-    pollFilter["item"]["artists"][0]["name"] = true;
-    pollFilter["item"]["album"]["name"] = true;
-    pollFilter["item"]["album"]["images"][0]["url"] = true;
-    pollFilter["item"]["duration_ms"] = true;
-    pollFilter["device"]["name"] = true;
-    pollFilterInit = true;
-  }
+static void bearerHeader(HttpClient& http, void*) {
+  http.headerf("Authorization", "Bearer %s", accessToken);
+}
 
-  // Get access token if we don't have one yet
-  if (accessToken.length() == 0 && !refreshAccessToken()) {
-    LOGLN("[Poll] No access token — skipping");
-    return;
+// `path` must outlive the transfer
+static bool spotifyControl(PendingAction action, int arg, char* path, size_t n,
+                           FetchDone done) {
+  const char* method = "PUT";
+  switch (action) {
+    case ACTION_PLAY:   snprintf(path, n, "%s/play", PLAYER_PATH);  break;
+    case ACTION_PAUSE:  snprintf(path, n, "%s/pause", PLAYER_PATH); break;
+    case ACTION_SKIP:   method = "POST"; snprintf(path, n, "%s/next", PLAYER_PATH);     break;
+    case ACTION_PREV:   method = "POST"; snprintf(path, n, "%s/previous", PLAYER_PATH); break;
+    case ACTION_SEEK:   snprintf(path, n, "%s/seek?position_ms=%d", PLAYER_PATH, max(arg, 0)); break;
+    case ACTION_VOLUME: snprintf(path, n, "%s/volume?volume_percent=%d", PLAYER_PATH,
+                                 constrain(arg, 0, 100)); break;
+    default: return false;
   }
+  // Empty body, Content-Length: 0
+  FetchReq req = { SPOTIFY_API_HOST, path, method, nullptr, PRIO_SPOTIFY, EP_SPOTIFY_API,
+                   &netSpotify, schedBudget(), 0, bearerHeader };
+  return fetchRequest(req, done);
+}
 
-#ifdef VERBOSE_POLL
-  LOG("[Poll] Heap: %u\n", ESP.getFreeHeap());
-#endif
+// ============================================================
+//  Spotify data fetch (runs on core 0 — no drawing!)
+//  A reactor transfer on the persistent TLS connection, through the
+//  shared HTTP cache; the answer is extracted field by field straight
+//  into a Playback struct.
+// ============================================================
+static bool          pollBusy   = false;
+static unsigned long pollSentAt = 0;
 
-  pollHttp.begin(pollClient, "https://api.spotify.com/v1/me/player");
-  pollHttp.addHeader("Authorization", "Bearer " + accessToken);
-  pollHttp.addHeader("Connection", "keep-alive");
-  if (lastETag.length() > 0) {
-    pollHttp.addHeader("If-None-Match", lastETag);
-  }
+static void noteFirstAnswer();
 
-  // ~90 B request line + Bearer token + headers. Bearer is ~180 chars.
-  netSpotify.txBytes += 90 + accessToken.length() + lastETag.length() + REQ_HDR_EST;
+static void pollHeaders(HttpClient& http, void*) {
+  bearerHeader(http, nullptr);
+  http.acceptGzip();
+  http.useCache();
+}
 
-  unsigned long t0 = millis();
-  int code = pollHttp.GET();
-  unsigned long rtt = millis() - t0;
+static void onPoll(int code, uint8_t* body, size_t len, void*) {
+  pollBusy = false;
+  unsigned long rtt = millis() - pollSentAt;
+  countPollRequest();
+  poll304Streak = (code == 304) ? min(poll304Streak + 1, 255) : 0;
 
   if (code == 304) {
     // Not Modified — nothing changed, just update poll time for interpolation
-    netSpotify.rxBytes += RESP_HDR_EST;  // headers only
     LOG("[Poll] 304 (%lums)\n", rtt);
-    xSemaphoreTake(dataMutex, portMAX_DELAY);
-    if (now.active) now.pollTime = millis();
-    xSemaphoreGive(dataMutex);
-    pollHttp.end();
-    return;
-  }
-
-  if (code == 200) {
-    int sz = pollHttp.getSize();
-    netSpotify.rxBytes += (sz > 0 ? (uint32_t)sz : 0) + RESP_HDR_EST;
-    // Capture ETag for next request
-    if (pollHttp.hasHeader("ETag")) {
-      lastETag = pollHttp.header("ETag");
-    }
-
-    // Stream-parse with filter — only extracts fields we need
-    JsonDocument doc;
-    DeserializationError err = deserializeJson(doc, pollHttp.getStream(),
-                                               DeserializationOption::Filter(pollFilter));
-    pollHttp.end();
-
-    if (err) {
-      LOG("[Poll] JSON error: %s (%lums)\n", err.c_str(), rtt);
-      return;
+    if (now.active) {
+      now.pollTime = millis();
+      playbackPub.publish(now);
     }
+    pollLastDoneAt = millis();
+
+  } else if (code == 200) {
+    // Only the fields we need, straight into a Playback.
+    // Prefer the 300px image (images[1]); fall back to the first one.
+    Playback p;
+    char img0[sizeof(p.imgUrl)];
+    JsonField fields[] = {
+      jsonInt ("progress_ms",              &p.progress),
+      jsonBool("is_playing",               &p.playing),
+      jsonStr ("item.id",                  p.trackId, sizeof(p.trackId)),
+      jsonStr ("item.name",                p.track,   sizeof(p.track)),
+      jsonStr ("item.artists[0].name",     p.artist,  sizeof(p.artist)),
+      jsonStr ("item.album.name",          p.album,   sizeof(p.album)),
+      jsonStr ("item.album.images[1].url", p.imgUrl,  sizeof(p.imgUrl)),
+      jsonStr ("item.album.images[0].url", img0,      sizeof(img0)),
+      jsonInt ("item.duration_ms",         &p.duration),
+      jsonStr ("device.name",              p.device,  sizeof(p.device)),
+    };
+    bool ok = jsonExtract(body, len, fields, sizeof(fields) / sizeof(fields[0]));
+    // The validators were stored with the body; a 304 must not
+    // confirm what wasn't parsed
+    if (!ok) httpCacheForget(SPOTIFY_API_HOST, PLAYER_PATH);
+
+    unsigned long prevPoll = pollLastDoneAt;
+    pollLastDoneAt = millis();
+    if (!ok) {
+      LOG("[Poll] JSON error (%lums)\n", rtt);
+    } else {
+      if (!p.imgUrl[0]) strlcpy(p.imgUrl, img0, sizeof(p.imgUrl));
+      checkActionConfirmed(p);
 
-    String tid  = doc["item"]["id"] | "";
-    int    prog = doc["progress_ms"] | 0;
-    bool   play = doc["is_playing"] | false;
-
-    // Check if track ID changed (triggers full metadata redraw)
-    xSemaphoreTake(dataMutex, portMAX_DELAY);
-    bool wasInactive = !now.active;
-    bool idChanged   = (tid != now.trackId) || wasInactive;
+      bool play = p.playing;
+      int  prog = p.progress;
 
-    // If paused and already idle, just stay idle
-    if (!play && !now.active && !idChanged) {
-      xSemaphoreGive(dataMutex);
-      LOG("[Poll] Idle, no change (%lums)\n", rtt);
-      return;
-    }
+      // Check if track ID changed (triggers full metadata redraw)
+      bool wasInactive = !now.active;
+      bool idChanged   = strcmp(p.trackId, now.trackId) != 0 || wasInactive;
 
-    if (idChanged) {
-      // ── Full metadata update ──
-      String trk = doc["item"]["name"] | "";
-      String alb = doc["item"]["album"]["name"] | "";
-      int    dur = doc["item"]["duration_ms"] | 0;
-      String art;
-      JsonArray artists = doc["item"]["artists"];
-      if (artists.size() > 0) art = artists[0]["name"] | "";
-      String dev = doc["device"]["name"] | "";
-      String img;
-      JsonArray images = doc["item"]["album"]["images"];
-      if (images.size() > 1)      img = images[1]["url"] | "";
-      else if (images.size() > 0) img = images[0]["url"] | "";
-
-      now.trackId  = tid;
-      now.track    = trk;
-      now.artist   = art;
-      now.album    = alb;
-      now.device   = dev;
-      now.imgUrl   = img;
-      now.progress = prog;
-      now.duration = dur;
-      now.playing  = play;
-      now.pollTime = millis();
-      now.active   = true;
-      xSemaphoreGive(dataMutex);
+      if (!play && !now.active && !idChanged) {
+        // If paused and already idle, just stay idle
+        LOG("[Poll] Idle, no change (%lums)\n", rtt);
 
-      LOG("[Poll] New track: %s | %s (%lums)\n", trk.c_str(), art.c_str(), rtt);
-      if (wasInactive) redrawFlags |= RFLAG_GONE_ACTIVE;
-      redrawFlags |= RFLAG_TRACK_CHANGED;
+      } else if (idChanged) {
+        // ── Full metadata update ──
+        if (!wasInactive) recordTrackChangeLatency(pollLastDoneAt, prevPoll);
+        now = p;
+        now.pollTime = millis();
+        now.active   = true;
+        playbackPub.publish(now);
 
-    } else {
-      // ── Same track — lightweight update (progress + play state) ──
-      bool playChanged   = (play != now.playing);
-      String dev = doc["device"]["name"] | "";
-      bool deviceChanged = (dev != now.device);
-      if (deviceChanged) now.device = dev;
-      now.progress = prog;
-      now.playing  = play;
-      now.pollTime = millis();
-      xSemaphoreGive(dataMutex);
+        LOG("[Poll] New track: %s | %s (%lums)\n", now.track, now.artist, rtt);
+        if (wasInactive) redrawFlags |= RFLAG_GONE_ACTIVE;
+        redrawFlags |= RFLAG_TRACK_CHANGED;
 
-      LOG("[Poll] Update: prog=%d play=%d (%lums)\n", prog, play, rtt);
-      if (deviceChanged)       redrawFlags |= RFLAG_DEVICE_CHANGED;
-      else if (playChanged)    redrawFlags |= RFLAG_PLAY_CHANGED;
-      // No flag = progress-only (handled by interpolation in loop)
+      } else {
+        // ── Same track — lightweight update (progress + play state) ──
+        bool playChanged   = (play != now.playing);
+        bool deviceChanged = strcmp(p.device, now.device) != 0;
+        if (deviceChanged) strlcpy(now.device, p.device, sizeof(now.device));
+        now.progress = prog;
+        now.playing  = play;
+        now.pollTime = millis();
+        playbackPub.publish(now);
+
+        LOG("[Poll] Update: prog=%d play=%d (%lums)\n", prog, play, rtt);
+        if (deviceChanged)       redrawFlags |= RFLAG_DEVICE_CHANGED;
+        else if (playChanged)    redrawFlags |= RFLAG_PLAY_CHANGED;
+        // No flag = progress-only (handled by interpolation in loop)
+      }
     }
 
   } else if (code == 204) {
-    netSpotify.rxBytes += RESP_HDR_EST;
-    pollHttp.end();
+    pollLastDoneAt = millis();
     LOG("[Poll] Nothing playing (%lums)\n", rtt);
-    xSemaphoreTake(dataMutex, portMAX_DELAY);
     bool wasActive = now.active;
-    if (wasActive) now = Playback{};
-    xSemaphoreGive(dataMutex);
     if (wasActive) {
+      now = Playback{};
+      playbackPub.publish(now);
       redrawFlags |= RFLAG_GONE_IDLE;
       bgTickerFetchNeeded = true;
-      lastETag = "";
-      // CDN will close the keep-alive during idle — drop it now so the next
-      // wake opens a fresh handshake instead of retrying on a dead socket.
-      stopAlbumArtClient();
+      httpCacheForget(SPOTIFY_API_HOST, PLAYER_PATH);
     }
 
   } else if (code == 401) {
-    pollHttp.end();
     LOG("[Poll] 401 — refreshing token (%lums)\n", rtt);
-    accessToken = "";
-    lastETag = "";
-    refreshAccessToken();
+    // Revoked or clock drift — the proactive refresh didn't get there first
+    if (refreshAccessToken(true, true)) tokenThenPoll = true;
 
   } else {
-    pollHttp.end();
+    // A transport error has already closed the socket; the next
+    // transfer opens a fresh (resumed) session
     LOG("[Poll] HTTP %d (%lums)\n", code, rtt);
-    if (code < 0) {
-      // Connection lost — reset client for fresh TLS handshake
-      pollClient.stop();
+  }
+  free(body);
+
+  if (pollLastDoneAt) bootEnd(BOOT_POLL);
+  noteFirstAnswer();
+}
+
+// `flags` FETCH_PIPELINE: ride the verb just sent (the confirmation poll)
+static void pollSpotifyData(uint8_t flags = 0) {
+  if (!spotifyReady) return;
+
+  // Get access token if we don't have one yet; the poll follows it
+  if (!accessToken[0]) {
+    if (refreshAccessToken()) tokenThenPoll = true;
+    else LOGLN("[Poll] No access token — skipping");
+    return;
+  }
+  if (httpCacheFresh(httpCacheKey(SPOTIFY_API_HOST, PLAYER_PATH))) {
+    // Still fresh per max-age — what we parsed last time stands
+    pollLastDoneAt = millis();
+    return;
+  }
+
+#ifdef VERBOSE_POLL
+  LOG("[Poll] Heap: %u\n", ESP.getFreeHeap());
+#endif
+
+  // Refused while the API is failing or throttling us (not even a
+  // handshake), or with no connection slot
+  FetchReq req = { SPOTIFY_API_HOST, PLAYER_PATH, nullptr, nullptr, PRIO_SPOTIFY,
+                   EP_SPOTIFY_API, &netSpotify, schedBudget(), flags, pollHeaders };
+  pollSentAt = millis();
+  pollBusy   = fetchRequest(req, onPoll);
+  if (!pollBusy) LOGLN("[Poll] Not sent — skipping");
+}
+
+// ============================================================
+//  Playback action queue — consumer side (core 0)
+//  A folded burst goes out one verb at a time: each verb's callback
+//  starts the next. Polls hold off until the burst is done, except
+//  the one that confirms it, which goes out with the last verb.
+// ============================================================
+// Oldest event across both producer rings
+static bool popOldestAction(ActionEvent& e) {
+  const ActionEvent* b = buttonActions.front();
+  const ActionEvent* w = webActions.front();
+  if (!b && !w) return false;
+  if (b && (!w || (long)(b->at - w->at) <= 0)) return buttonActions.pop(e);
+  return webActions.pop(e);
+}
+
+// In press order of effect; once a request fails the rest are
+// abandoned, and the events behind both count as failed
+struct Intent { PendingAction action; int arg; int count; int events; };
+
+struct ActionBurst {
+  bool          live;
+  bool          waitToken;   // a verb waits for a new token
+  bool          retried;     // this verb already went again after a 401
+  bool          ok;
+  Intent        plan[4];
+  int           step;        // index into plan
+  int           done;        // requests accepted for plan[step]
+  int           events;
+  int           requests;
+  int8_t        play;
+  ActionConfirm confirm;
+  unsigned long startAt;
+  char          path[64];    // of the verb in flight
+};
+static ActionBurst burst = {};
+
+static void sendNextAction();
+
+// One verb answered (or not sent); on to the next
+static void actionAnswered(int code) {
+  ActionBurst& b = burst;
+  LOG("[Action] %d: HTTP %d\n", b.plan[b.step].action, code);
+  b.requests++;
+  if (code >= 200 && code < 300) {
+    b.done++;
+  } else {
+    // e.g. 404 no active device — undo the optimistic state with a full
+    // re-poll; a 304 would leave it in place.
+    httpCacheForget(SPOTIFY_API_HOST, PLAYER_PATH);
+    bgLastPoll = 0;
+    b.ok = false;
+  }
+  sendNextAction();
+}
+
+static void onAction(int code, uint8_t* body, size_t, void*) {
+  free(body);   // any short error body
+  ActionBurst& b = burst;
+  if (code == 401 && !b.retried && refreshAccessToken(true, true)) {
+    // Sent again once the new token is in (actionDue() says when)
+    b.retried   = true;
+    b.waitToken = true;
+    return;
+  }
+  b.retried = false;
+  actionAnswered(code);
+}
+
+// The verb about to go out is the burst's last
+static bool lastVerb(const ActionBurst& b) {
+  if (b.done + 1 < b.plan[b.step].count) return false;
+  for (int k = b.step + 1; k < 4; k++) {
+    if (b.plan[k].count) return false;
+  }
+  return true;
+}
+
+// Confirm with short-interval polls instead of a fixed wait. The first
+// rides the last verb's connection: on HTTP/2 another stream on the
+// same session, on HTTP/1.1 pipelined behind the verb, so the server
+// answers it once the verb is handled.
+static void confirmAlong(ActionBurst& b) {
+  ActionConfirm& c = b.confirm;
+  if (!c.steps && c.seek < 0 && c.playing < 0) return;   // volume: nothing to see
+  c.pending     = true;
+  actionConfirm = c;
+  if (pollBusy) return;   // the next one after it confirms
+  bgLastPoll = millis();
+  pollSpotifyData(FETCH_PIPELINE);
+}
+
+static void sendNextAction() {
+  ActionBurst& b = burst;
+  for (; b.step < 4; b.step++, b.done = 0) {
+    const Intent& in = b.plan[b.step];
+    if (b.ok && b.done < in.count) break;
+    if (b.done == in.count) actionMerged += in.events - in.count;
+    else                    actionFailed += in.events - b.done;
+  }
+  if (b.step < 4) {
+    const Intent& in = b.plan[b.step];
+    if (in.action == ACTION_PLAY || in.action == ACTION_PAUSE) {
+      // Apply the optimistic play state core 1 already drew
+      now.playing = b.play;
+      playbackPub.publish(now);
+    }
+    if (!accessToken[0]) {
+      if (refreshAccessToken()) b.waitToken = true;
+      else                      actionAnswered(401);
+    } else if (!spotifyControl(in.action, in.arg, b.path, sizeof(b.path), onAction)) {
+      actionAnswered(-1);
+    } else if (lastVerb(b)) {
+      confirmAlong(b);
+    }
+    return;
+  }
+
+  b.live = false;
+  if (b.requests) actionRttLastMs = millis() - b.startAt;
+  LOG("[Action] %d event(s) -> %d request(s)%s, %lums\n", b.events, b.requests,
+      b.ok ? "" : ", failed", actionRttLastMs);
+
+  // A failed verb was answered with a full re-poll instead
+  if (!b.ok) actionConfirm.pending = false;
+}
+
+// The token a verb waited for is in (or not): send it again
+static void resumeAction() {
+  burst.waitToken = false;
+  if (accessToken[0]) sendNextAction();
+  else                actionAnswered(401);
+}
+
+static void runQueuedActions() {
+  size_t depth = buttonActions.size() + webActions.size();
+  if (!depth) return;
+  if (depth > actionDepthMax) actionDepthMax = depth;
+  // Let a burst of presses finish before folding it; until Spotify is
+  // set up the presses stay queued
+  if (millis() - actionLastPushAt < ACTION_COALESCE_MS || !spotifyReady) return;
+  notePollActivity();
+
+  // Events behind each intent, so a failed request accounts for its own
+  int  events = 0, steps = 0, seek = -1, volume = -1;
+  int  eSteps = 0, eSeek = 0, ePlay = 0, eVolume = 0, moot = 0;
+  int8_t play = -1;
+  unsigned long firstAt = 0;
+  ActionEvent e;
+  while (popOldestAction(e)) {
+    if (!events++) firstAt = e.at;
+    switch (e.action) {
+      case ACTION_SKIP:
+      case ACTION_PREV:
+        // A seek before a skip is moot
+        steps += e.action == ACTION_SKIP ? 1 : -1;
+        eSteps++;
+        moot += eSeek;
+        eSeek = 0;
+        seek  = -1;
+        break;
+      case ACTION_PLAY:   play = 1; ePlay++; break;
+      case ACTION_PAUSE:  play = 0; ePlay++; break;
+      case ACTION_SEEK:   seek = e.arg;   eSeek++;   break;
+      case ACTION_VOLUME: volume = e.arg; eVolume++; break;
+      default: break;
+    }
+  }
+  if (play >= 0 && (bool)play == now.playing) {   // toggled back
+    play  = -1;
+    moot += ePlay;
+    ePlay = 0;
+  }
+  actionMerged += moot;
+
+  ActionBurst& b = burst;
+  b = ActionBurst{};
+  b.live    = true;
+  b.ok      = true;
+  b.events  = events;
+  b.play    = play;
+  b.startAt = millis();
+  b.plan[0] = { steps > 0 ? ACTION_SKIP : ACTION_PREV, 0, abs(steps), eSteps };
+  b.plan[1] = { ACTION_SEEK,   seek,   seek >= 0,   eSeek };
+  b.plan[2] = { play > 0 ? ACTION_PLAY : ACTION_PAUSE, 0, play >= 0, ePlay };
+  b.plan[3] = { ACTION_VOLUME, volume, volume >= 0, eVolume };
+
+  b.confirm = { firstAt, "", now.progress, steps, play, seek, false };
+  strlcpy(b.confirm.fromTrack, now.trackId, sizeof(b.confirm.fromTrack));
+  if (now.active && now.playing) b.confirm.fromProgress += (int)(millis() - now.pollTime);
+
+  sendNextAction();
+}
+
+// ============================================================
+//  Warm-boot state
+//  Core 0 keeps a copy of what is on screen in RTC memory (and, now
+//  and then, flash); setup() puts it back before Wi-Fi is up.
+// ============================================================
+static unsigned long warmSavedAt  = 0;
+static bool          pollAnswered = false;
+
+static void saveWarmState() {
+  WarmState w;
+  w.playback = now;
+  if (now.active && now.playing) {
+    // Progress as of now, so a restore only has to add the time it was off
+    w.playback.progress = min(now.progress + (int)(millis() - now.pollTime), now.duration);
+  }
+  tickerPub.read(w.tickers);   // what is on screen
+  memcpy(w.token, accessToken, sizeof(w.token));
+  time_t t    = warmNow();
+  long   left = tokenExpiresAt ? (long)(tokenExpiresAt - millis()) / 1000 : 0;
+  w.tokenExpires = (t && left > 0) ? t + left : 0;
+  w.savedAt      = t;
+  warmSave(w);
+}
+
+// setup(), before the background task exists
+static void restoreWarmState() {
+  WarmState w;
+  if (warmLoad(w) == WARM_NONE) return;
+  time_t t     = warmNow();
+  long   age   = (w.savedAt && t) ? (long)(t - w.savedAt) : -1;
+  bool   shown = false;
+
+  // Prices for the symbols still on the list
+  for (int i = 0; i < numTickers; i++) {
+    for (int j = 0; j < w.tickers.count; j++) {
+      const TickerItem& old = w.tickers.items[j];
+      if (!old.valid || strcmp(old.symbol, tickerItems[i].symbol)) continue;
+      tickerItems[i].price  = old.price;
+      tickerItems[i].change = old.change;
+      tickerItems[i].valid  = true;
+      shown = true;
     }
   }
+
+  // Playback of unknown age is shown too: after a power cut the clock
+  // isn't set yet, and the stale mark says what it is
+  if (w.playback.active && age <= WARM_PLAYBACK_MAX_S) {
+    now = w.playback;
+    if (now.playing && age > 0) now.progress = min(now.progress + (int)age * 1000, now.duration);
+    now.pollTime = millis();
+    playbackPub.publish(now);
+    shown = true;
+  }
+
+  // The token only if the clock vouches for it (RTC copies carry one)
+  if (w.token[0] && t && w.tokenExpires - t > 60) {
+    memcpy(accessToken, w.token, sizeof(accessToken));
+    tokenExpiresAt = millis() + (unsigned long)(w.tokenExpires - t) * 1000UL;
+    tokenWarm = true;
+  }
+  viewStale = shown;
+}
+
+// First answer from the API: whatever the screen shows is current now
+static void noteFirstAnswer() {
+  if (pollAnswered || !pollLastDoneAt) return;
+  pollAnswered = true;
+  redrawFlags |= RFLAG_FRESH;
+}
+
+// ============================================================
+//  Background jobs (core 0)
+//  Each is a due()/run() pair for the scheduler (sched.cpp): due()
+//  says how long until there is work, run() does it.
+// ============================================================
+static bool          artPrewarm     = false;   // link came back mid-track
+static char          artPrewarmedId[sizeof(Playback::trackId)] = "";
+static char          coverUrl[sizeof(Playback::imgUrl)] = "";   // in flight or last tried
+static unsigned long coverTriedAt   = 0;
+static bool          coverBusy      = false;
+static unsigned long dnsCheckedAt   = 0;
+
+// Queued presses, once a burst has settled and the one before is done
+static long actionDue() {
+  if (!wifiUp() || !spotifyReady) return SCHED_NEVER;
+  if (burst.live) return burst.waitToken && !tokenBusy ? 0 : SCHED_NEVER;
+  if (buttonActions.size() + webActions.size() == 0) return SCHED_NEVER;
+  return (long)ACTION_COALESCE_MS - (long)(millis() - actionLastPushAt);
+}
+
+static bool actionRun() {
+  if (burst.live) resumeAction();
+  else            runQueuedActions();
+  return true;
+}
+
+// Not while the last poll, a token or a press is still out
+static long pollDue() {
+  if (!wifiUp() || !screenOn || pollBusy || tokenBusy || burst.live) return SCHED_NEVER;
+  pollIntervalMs = nextPollInterval(bgLastPoll);
+  return (long)pollIntervalMs - (long)(millis() - bgLastPoll);
+}
+
+static bool pollRun() {
+  // A press goes first; its confirmation poll covers this one
+  if (schedPreempted()) return false;
+  bgLastPoll = millis();
+  pollSpotifyData();
+  noteFirstAnswer();
+  return true;
+}
+
+// Art CDN session: opened before the track ends, so the next cover
+// skips the handshake, and right after the link comes back
+static long artDue() {
+  if (!now.active) artPrewarm = false;   // the first cover opens it anyway
+  if (!wifiUp() || !screenOn || !now.active || !now.imgUrl[0]) return SCHED_NEVER;
+  if (artPrewarm) return 0;
+  if (!now.playing || strcmp(artPrewarmedId, now.trackId) == 0) return SCHED_NEVER;
+  int left = now.duration - (now.progress + (int)(millis() - now.pollTime));
+  return (long)left - (long)ART_PREWARM_LEAD_MS;
+}
+
+static bool artRun() {
+  if (schedPreempted()) return false;
+  artPrewarm = false;
+  strlcpy(artPrewarmedId, now.trackId, sizeof(artPrewarmedId));
+  char artHost[TLS_HOST_MAX];
+  urlHost(now.imgUrl, artHost, sizeof(artHost));
+  fetchPrewarm(artHost, PRIO_ART);
+  return true;
+}
+
+// Cover of the current track, downloaded through the reactor: the job
+// only starts the transfer, the body arrives between later passes
+static void onCover(int code, uint8_t* jpg, size_t len, void*) {
+  coverBusy = false;
+  if (code == 200 && jpg) artDeliver(coverUrl, jpg, len);
+  else                    free(jpg);   // an error page is no cover
+}
+
+static long coverDue() {
+  if (!wifiUp() || !now.active || !now.imgUrl[0] || coverBusy) return SCHED_NEVER;
+  if (artHave(now.imgUrl)) return SCHED_NEVER;
+  if (strcmp(coverUrl, now.imgUrl) != 0) return 0;
+  return (long)ART_RETRY_MS - (long)(millis() - coverTriedAt);   // this one failed
+}
+
+static bool coverRun() {
+  strlcpy(coverUrl, now.imgUrl, sizeof(coverUrl));
+  coverTriedAt = millis();
+  coverBusy    = fetchStart(coverUrl, PRIO_ART, EP_ART, &netArt, ART_FETCH_MS, onCover);
+  return true;
+}
+
+// Price refresh: right away when the list changed or playback stopped,
+// otherwise with the next poll's radio window. The job only starts
+// the transfers; each provider publishes when its answers have landed,
+// and a refresh still running defers the next one.
+static long tickersDue() {
+  if (tickerListChanged) return 0;
+  if (!wifiUp() || now.active || numTickers == 0 || tickerBusy()) return SCHED_NEVER;
+  long overdue = (long)(millis() - bgLastTickerFetch) - TICKER_FETCH_MS;
+  if (bgTickerFetchNeeded || batchRun(JOB_TICKERS, overdue, TICKER_SLACK_MS)) return 0;
+  return overdue < 0 ? -overdue : SCHED_IDLE_MS;
+}
+
+static bool tickersRun() {
+  // Ticker list changed via web UI or serial — reload on the owning core
+  if (tickerListChanged) {
+    tickerListChanged = false;
+    loadTickers();
+    publishTickers();
+    bgTickerFetchNeeded = true;
+  }
+  if (!wifiUp() || now.active || numTickers == 0 || tickerBusy()) return true;
+  bgTickerFetchNeeded = false;
+  bgLastTickerFetch = millis();
+  LOGLN("[BG] Refreshing prices...");
+  bootBegin(BOOT_PRICES);
+  tickerRefresh();
+  return true;
+}
+
+// Re-resolve a host before its DNS entry runs out (one lookup at
+// most), only while the radio is up anyway: an entry that lapses is
+// resolved on its next connect
+static long dnsDue() {
+  if (!wifiUp() || !radioAwake()) return SCHED_NEVER;
+  return (long)DNS_CHECK_MS - (long)(millis() - dnsCheckedAt);
+}
+
+static bool dnsRun() {
+  dnsCheckedAt = millis();
+  dnsRefresh();
+  return true;
+}
+
+// Clock resync, also in a window (lwIP sends it from its own timer)
+static long ntpDue() {
+  unsigned long synced = ntpSyncedAt;
+  if (!wifiUp() || !synced) return SCHED_NEVER;
+  long overdue = (long)(millis() - synced) - NTP_RESYNC_MS;
+  if (batchRun(JOB_NTP, overdue, NTP_SLACK_MS)) return 0;
+  return overdue < 0 ? -overdue : SCHED_IDLE_MS;
+}
+
+static bool ntpRun() {
+  ntpSyncedAt = millis();   // until the answer lands
+  sntp_restart();
+  radioTouch();
+  return true;
+}
+
+// Keep what a reboot should come back to
+static long warmDue() {
+  return (long)WARM_SAVE_MS - (long)(millis() - warmSavedAt);
+}
+
+static bool warmRun() {
+  warmSavedAt = millis();
+  saveWarmState();
+  return true;
+}
+
+// TLS allocator benchmark (serial TLSBENCH): full and resumed
+// handshakes to the API under each placement policy. The figures land
+// in the per-policy stats the TUI shows. A press aborts it; it starts
+// over on the next pass.
+static long tlsBenchDue() {
+  return tlsBenchRequested && wifiUp() ? 0 : SCHED_NEVER;
+}
+
+static bool tlsBenchRun() {
+  if (!tlsAllocInstalled()) {
+    tlsBenchRequested = false;
+    LOGLN("[TLS] Benchmark needs the policy allocator");
+    return true;
+  }
+  PoolLease conn(SPOTIFY_API_HOST, PRIO_SPOTIFY);
+  if (!conn) return true;
+  conn.closeOnRelease();
+  TlsAllocPolicy was = tlsAllocPolicy();
+  tlsAllocResetStats();
+  bool done = true;
+  for (int p = 0; p < TLS_ALLOC_POLICIES && done; p++) {
+    if (p != TLS_ALLOC_INTERNAL && !ESP.getPsramSize()) continue;
+    tlsAllocSetPolicy((TlsAllocPolicy)p);
+    for (int r = 0; r < TLS_BENCH_ROUNDS; r++) {
+      if (schedPreempted()) { done = false; break; }
+      conn->client.stop();
+      tlsForgetSession(SPOTIFY_API_HOST);
+      conn->client.connect(SPOTIFY_API_HOST, 443);   // full
+      conn->client.stop();
+      conn->client.connect(SPOTIFY_API_HOST, 443);   // resumed
+    }
+  }
+  conn->client.stop();
+  tlsAllocSetPolicy(was);
+  if (!done) return false;
+  tlsBenchRequested = false;
+
+  static TlsAllocStats st;   // ~100 bytes — keep it off the task stack
+  tlsAllocStats(st);
+  for (int p = 0; p < TLS_ALLOC_POLICIES; p++) {
+    const TlsPolicyStats& ps = st.policies[p];
+    if (!ps.full) continue;
+    LOG("[TLS] %-8s full %lums, resumed %lums, peak %uK internal, holds %uK + %uK PSRAM\n",
+        tlsAllocName((TlsAllocPolicy)p), (unsigned long)(ps.fullMsSum / ps.full),
+        (unsigned long)(ps.resumed ? ps.resumedMsSum / ps.resumed : 0),
+        (unsigned)(ps.peakInternal / 1024), (unsigned)(ps.residentInternal / 1024),
+        (unsigned)(ps.residentPsram / 1024));
+  }
+  return true;
 }
 
 // ============================================================
 //  Background task — core 0
-//  Handles all blocking network operations so core 1 is free
-//  to render smooth animations without interruption.
+//  Runs every network job so core 1 is free to render smooth
+//  animations without interruption. Jobs start reactor transfers;
+//  between passes the task waits in the reactor's select().
 // ============================================================
 static void backgroundTask(void* param) {
-  // Unsubscribe IDLE0 from task watchdog — Spotify API calls can block
-  // Core 0 for several seconds during TLS handshakes, starving IDLE0.
+  // Unsubscribe IDLE0 from task watchdog — the TLS benchmark and the
+  // handshake's key exchange can keep core 0 busy long enough to
+  // starve IDLE0.
   esp_task_wdt_delete(xTaskGetIdleTaskHandleForCPU(0));
   LOGLN("[BG] Background task started on core 0");
 
+  // Resolved ahead of their first connect; kept warm while in use
+  const char* HOSTS[] = { SPOTIFY_API_HOST, SPOTIFY_ACCOUNTS_HOST, SPOTIFY_ART_HOST,
+                          COINGECKO_HOST, FINNHUB_HOST };
+  for (const char* h : HOSTS) dnsPin(h);
+  // HTTP/2 to the API: one session, HPACK-compressed heads
+  if (SPOTIFY_API_H2 && ESP.getPsramSize()) tlsOfferH2(SPOTIFY_API_HOST, true);
+
+  // Boot: token and first poll go out right away, while core 1 is
+  // still building sprites, painting and starting the config server.
+  // Without a warm token the poll starts the refresh and follows it.
+  bootBegin(BOOT_TOKEN);
+  bootBegin(BOOT_POLL);
+  if (tokenWarm) {
+    LOGLN("[Token] Reusing the access token from before the reset");
+    bootEnd(BOOT_TOKEN);
+  }
+  pollSpotifyData();
+  bgLastPoll = millis();
+
+  // Cover cache; formatting a fresh partition can take a while
+  warmMountArt();
+
+  schedBegin();
+  schedAdd(JC_ACTION,    "action",  actionDue,   actionRun);
+  schedAdd(JC_POLL,      "poll",    pollDue,     pollRun);
+  schedAdd(JC_ART,       "cover",   coverDue,    coverRun);
+  schedAdd(JC_ART,       "prewarm", artDue,      artRun);
+  schedAdd(JC_TICKERS,   "tickers", tickersDue,  tickersRun);
+  schedAdd(JC_HOUSEKEEP, "token",   tokenDue,    tokenRun);
+  schedAdd(JC_HOUSEKEEP, "dns",     dnsDue,      dnsRun);
+  schedAdd(JC_HOUSEKEEP, "ntp",     ntpDue,      ntpRun);
+  schedAdd(JC_HOUSEKEEP, "warm",    warmDue,     warmRun);
+  schedAdd(JC_HOUSEKEEP, "tlsbench", tlsBenchDue, tlsBenchRun);
+
   while (true) {
     unsigned long loopStart = micros();
-    unsigned long ms = millis();
-
-    // Process queued button actions (Spotify API calls)
-    PendingAction action = pendingAction;
-    if (action != ACTION_NONE) {
-      pendingAction = ACTION_NONE;
-      if (sp && spotifyReady) {
-        unsigned long tAct = millis();
-        switch (action) {
-          case ACTION_SKIP:  sp->skip();                    break;
-          case ACTION_PREV:  sp->previous();                break;
-          case ACTION_PLAY:  sp->start_resume_playback();   break;
-          case ACTION_PAUSE: sp->pause_playback();          break;
-          default: break;
-        }
-        LOG("[BG] Spotify action %d: %lums\n", action, millis() - tAct);
-        // Poll immediately after action to get new state
-        delay(400);
-        unsigned long tPoll = millis();
-        pollSpotifyData();
-        LOG("[BG] Post-action poll: %lums\n", millis() - tPoll);
-        bgLastPoll = millis();
-      }
-    }
 
-    // Periodic Spotify poll
-    bool isActive;
-    xSemaphoreTake(dataMutex, portMAX_DELAY);
-    isActive = now.active;
-    xSemaphoreGive(dataMutex);
-
-    unsigned long pollInterval = isActive ? POLL_MS : POLL_IDLE_MS;
-    if (screenOn && ms - bgLastPoll >= pollInterval) {
-      bgLastPoll = ms;
-      pollSpotifyData();
-      // Re-read active state (poll may have changed it)
-      xSemaphoreTake(dataMutex, portMAX_DELAY);
-      isActive = now.active;
-      xSemaphoreGive(dataMutex);
+    // Link events, and non-blocking reconnects while it is down. While
+    // offline no network job is due: actions stay queued, and no
+    // doomed request trips an endpoint breaker.
+    if (wifiService()) {
+      bgLastPoll  = 0;      // re-sync right away
+      artPrewarm  = true;   // and have the art CDN session ready
     }
 
-    // Ticker price fetching
-    if (!isActive && numTickers > 0 &&
-        (ms - bgLastTickerFetch >= TICKER_FETCH_MS || bgTickerFetchNeeded)) {
-      bgTickerFetchNeeded = false;
-      bgLastTickerFetch = ms;
-      LOGLN("[BG] Fetching prices...");
-      fetchCryptoPrices();
-      fetchStockPrices();
-      redrawFlags |= RFLAG_TICKER_READY;
-      LOGLN("[BG] Price fetch done");
-    }
-
-    // WiFi reconnect
-    if (ms - bgLastWifi >= WIFI_MS) {
-      bgLastWifi = ms;
-      ensureWiFi();
-    }
+    unsigned long next = schedPass();
+    if (bootStartAt[BOOT_PRICES] && !tickerBusy()) bootEnd(BOOT_PRICES);
 
     core0BusyUs += micros() - loopStart;
-    vTaskDelay(pdMS_TO_TICKS(50));
+    // With a transfer in flight the wait is a select() on its socket
+    next = min(next, (unsigned long)(powerLow() ? PWR_BG_MS : SCHED_IDLE_MS));
+    if (fetchBusy()) reactorRun(next);
+    else             schedWait(next);
   }
 }
 
 // ============================================================
 //  Button callbacks (run on core 1 — queue API calls for core 0)
 // ============================================================
+bool queueAction(PendingAction action, int arg, ActionSource src) {
+  notePollActivity();
+  ActionEvent e = { action, arg, millis() };
+  auto& ring = (src == SRC_WEB) ? webActions : buttonActions;
+  if (!ring.push(e)) {
+    actionDrops++;
+    return false;
+  }
+  actionLastPushAt = e.at;
+  schedWake();
+  return true;
+}
+
 static void onSkip() {
-  if (!sp || !spotifyReady) return;
+  if (!spotifyReady) return;
   LOGLN("[Button] Skip");
-  pendingAction = ACTION_SKIP;
+  queueAction(ACTION_SKIP);
 }
 
 static void onPrev() {
-  if (!sp || !spotifyReady) return;
+  if (!spotifyReady) return;
   LOGLN("[Button] Previous");
-  pendingAction = ACTION_PREV;
+  queueAction(ACTION_PREV);
 }
 
 static void onPlayPause() {
-  if (!sp || !spotifyReady) return;
-  xSemaphoreTake(dataMutex, portMAX_DELAY);
-  bool active = now.active;
-  if (active) now.playing = !now.playing;
-  bool isPlaying = now.playing;
-  xSemaphoreGive(dataMutex);
-
-  if (!active) return;
+  if (!spotifyReady) return;
+  if (!view.active) return;
+  // Optimistic flip on the local view; core 0 applies it when it runs the action
+  view.playing = !view.playing;
+  bool isPlaying = view.playing;
   LOG("[Button] %s\n", isPlaying ? "Play" : "Pause");
   drawIcon(isPlaying);
-  pendingAction = isPlaying ? ACTION_PLAY : ACTION_PAUSE;
+  queueAction(isPlaying ? ACTION_PLAY : ACTION_PAUSE);
 }
 
 static void onTopMulti();   // fwd
@@ -529,11 +1255,9 @@ static void onScreenToggle() {
   screenOn = !screenOn;
   LOG("[Button] Screen %s\n", screenOn ? "ON" : "OFF");
   if (screenOn) {
-    xSemaphoreTake(dataMutex, portMAX_DELAY);
-    bool active = now.active;
-    xSemaphoreGive(dataMutex);
-    setBrightness(active ? brightPlay : brightIdle, "screen-on");
+    setBrightness(view.active ? brightPlay : brightIdle, "screen-on");
     lastTimeStr = "";
+    notePollActivity();
     bgLastPoll = 0;  // trigger immediate poll on core 0
   } else {
     setBrightness(0, "screen-off");
@@ -547,12 +1271,7 @@ static void onFlipScreen() {
   tft.fillScreen(TFT_BLACK);
   LOG("[Button] Rotation flipped to %d\n", screenRotation);
 
-  xSemaphoreTake(dataMutex, portMAX_DELAY);
-  bool active = now.active;
-  String imgUrl = now.imgUrl;
-  xSemaphoreGive(dataMutex);
-
-  if (active) showAlbumArt(imgUrl);
+  if (view.active) showAlbumArt(view.imgUrl);
   drawInfo();
 }
 
@@ -566,6 +1285,8 @@ static void onTopMulti() {
 // ============================================================
 void setup() {
   Serial.begin(115200);
+  // Before anything allocates through mbedTLS
+  tlsAllocInstall(TLS_ALLOC_DEFAULT);
   LOG("\n[Boot] Reset reason: %d | Free heap: %u | Min heap: %u | PSRAM: %u/%u\n",
                 esp_reset_reason(), ESP.getFreeHeap(), ESP.getMinFreeHeap(),
                 (unsigned)ESP.getFreePsram(), (unsigned)ESP.getPsramSize());
@@ -600,7 +1321,46 @@ void setup() {
 
   cpuTempC = temperatureRead();
 
+  brightPlay = prefs.getUChar("br_play", 16);
+  brightIdle = prefs.getUChar("br_idle", 8);
+  // Migrate old 0-255 range values to 0-16 range
+  if (brightPlay > BL_STEPS) { brightPlay = BL_STEPS; prefs.putUChar("br_play", brightPlay); }
+  if (brightIdle > BL_STEPS) { brightIdle = BL_STEPS / 2; prefs.putUChar("br_idle", brightIdle); }
+  LOG("[Boot] Loaded brightness: play=%d idle=%d\n", brightPlay, brightIdle);
+
+  // ── Sprites ────────────────────────────────────────────
+  bootBegin(BOOT_SPRITES);
+  titleSpr.createSprite(TXT_W + SCROLL_OVERFLOW, TITLE_H);
+  titleSpr.setSwapBytes(true);
+
+  tickerSpr.createSprite(SCR_W + SCROLL_OVERFLOW, TICKER_H);
+  tickerSpr.setSwapBytes(true);
+  bootEnd(BOOT_SPRITES);
+
+  // ── Tickers (owned by core 0 from here on) ────────────
+  loadTickers();
+
+  // ── Warm boot ──────────────────────────────────────────
+  // Last session's track (or prices) on screen before Wi-Fi, marked
+  // stale until the first poll answers
+  if (!resetHeld) restoreWarmState();
+  publishTickers();
+  if (viewStale) {
+    playbackPub.readIfNewer(view, viewGen);
+    tickerPub.readIfNewer(tickerView, tickerViewGen);
+    recalcTickerWidth();
+    bootBegin(BOOT_PAINT);
+    tft.fillScreen(TFT_BLACK);
+    setBrightness(view.active ? brightPlay : brightIdle, "warm");
+    drawInfo();
+    if (view.active) showCachedArt(view.imgUrl);
+    else             drawTicker();
+    bootEnd(BOOT_PAINT);
+    warmOnScreen = true;
+  }
+
   // ── WiFi ───────────────────────────────────────────────
+  bootBegin(BOOT_WIFI);
   WiFi.mode(WIFI_STA);
   wm.setDebugOutput(true);
 
@@ -608,14 +1368,17 @@ void setup() {
     showStatus("Resetting all...");
     wm.resetSettings();
     prefs.remove("rtoken");
+    prefs.remove("wflease");
+    prefs.remove("warm");
     LOGLN("[Reset] WiFi + Spotify token cleared");
     delay(800);
   }
 
-  showStatus("Connecting WiFi...", "Hold BOT at boot to reset");
+  if (!warmOnScreen) showStatus("Connecting WiFi...", "Hold BOT at boot to reset");
 
   wm.setConfigPortalTimeout(300);
   wm.setAPCallback([](WiFiManager* mgr) {
+    warmOnScreen = false;
     tft.fillScreen(TFT_BLACK);
     tft.setTextFont(2);
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
@@ -628,26 +1391,30 @@ void setup() {
     LOGLN("[WiFi] Config portal started");
   });
 
-  if (!wm.autoConnect("SpotifyDisplay")) {
+  // Straight to the last AP with the last lease; scan + DHCP only if that fails
+  bool fastWifi = !resetHeld && wifiFastConnect();
+  if (!fastWifi && !wm.autoConnect("SpotifyDisplay")) {
     showStatus("WiFi failed", "Restarting...");
     delay(3000);
     ESP.restart();
   }
+  wifiSaveLease();
 
-  showStatus("WiFi connected", WiFi.localIP().toString().c_str());
-  delay(1500);
+  if (!warmOnScreen) showStatus("WiFi connected", WiFi.localIP().toString().c_str());
+  wifiBegin();
+  bootEnd(BOOT_WIFI);
+  LOG("[Boot] IP at %lums (%s)\n", millis(), fastWifi ? "cached AP + lease" : "scan + DHCP");
+  if (!fastWifi && !warmOnScreen) delay(1500);   // first setup: leave the address readable
 
   // ── NTP time sync ──────────────────────────────────────
+  // Runs in the background; the clock appears once the first sync lands
   long gmtOff = prefs.getLong("gmtoff", 3600);
   long dstOff = prefs.getLong("dstoff", 0);
+  bootBegin(BOOT_NTP);
+  sntp_set_time_sync_notification_cb(onTimeSync);
   configTime(gmtOff, dstOff, "pool.ntp.org", "time.nist.gov");
-  LOGLN("[NTP] Syncing time...");
-  struct tm t;
-  if (getLocalTime(&t, 5000)) {
-    LOG("[NTP] Time: %02d:%02d:%02d\n", t.tm_hour, t.tm_min, t.tm_sec);
-  } else {
-    LOGLN("[NTP] Sync failed — will retry in background");
-  }
+  // Resyncs are batched by the background loop; lwIP's timer is a backstop
+  sntp_set_sync_interval(NTP_BACKSTOP_MS);
 
   // ── Spotify auth ───────────────────────────────────────
   String refreshToken = prefs.getString("rtoken", "");
@@ -665,35 +1432,7 @@ void setup() {
     }
   }
 
-  sp = new Spotify(SPOTIFY_CLIENT_ID, SPOTIFY_CLIENT_SECRET, refreshToken.c_str());
-  sp->begin();
-
-  // Get initial access token for direct API polling
-  if (!refreshAccessToken()) {
-    showStatus("Token failed!", "Retrying...");
-    delay(2000);
-    refreshAccessToken();  // One retry
-  }
-
-  spotifyReady = true;
-  showStatus("Spotify ready!");
-  LOGLN("[Spotify] Ready");
-  delay(500);
-
-  // ── Sprites ────────────────────────────────────────────
-  titleSpr.createSprite(TXT_W + SCROLL_OVERFLOW, TITLE_H);
-  titleSpr.setSwapBytes(true);
-
-  tickerSpr.createSprite(SCR_W + SCROLL_OVERFLOW, TICKER_H);
-  tickerSpr.setSwapBytes(true);
-  loadTickers();
-  stockApiKey = prefs.getString("stockkey", "d6m0k71r01qu3p05ktsgd6m0k71r01qu3p05ktt0");
-  brightPlay = prefs.getUChar("br_play", 16);
-  brightIdle = prefs.getUChar("br_idle", 8);
-  // Migrate old 0-255 range values to 0-16 range
-  if (brightPlay > BL_STEPS) { brightPlay = BL_STEPS; prefs.putUChar("br_play", brightPlay); }
-  if (brightIdle > BL_STEPS) { brightIdle = BL_STEPS / 2; prefs.putUChar("br_idle", brightIdle); }
-  LOG("[Boot] Loaded brightness: play=%d idle=%d\n", brightPlay, brightIdle);
+  // ── Stock API key (loaded with the tickers) ───────────
   if (stockApiKey.length() == 0) {
     LOGLN("[Ticker] No stock API key. Get free key at https://finnhub.io/register");
     LOGLN("[Ticker] Then send: STOCKKEY:your_key_here");
@@ -701,6 +1440,29 @@ void setup() {
     LOGLN("[Ticker] Stock API key loaded");
   }
 
+  // ── Power management ───────────────────────────────────
+  // Full power until the screen goes off or nothing plays for a while
+  powerBegin();
+
+  // ── Start background task on core 0 ────────────────────
+  // The access token and first poll happen there, overlapping the rest
+  // of setup; loop() draws the track when its flags arrive.
+  spotifyReady = true;
+  LOGLN("[Spotify] Ready");
+  xTaskCreatePinnedToCore(backgroundTask, "bg", 16384, NULL, 1, NULL, 0);
+
+  // ── First paint ────────────────────────────────────────
+  // The idle screen now, unless the warm-boot screen is still up; if
+  // the first poll has already landed, its flags are handled by the
+  // first pass of loop()
+  if (!warmOnScreen) {
+    bootBegin(BOOT_PAINT);
+    tft.fillScreen(TFT_BLACK);
+    setBrightness(view.active ? brightPlay : brightIdle, "boot");
+    drawInfo();
+    bootEnd(BOOT_PAINT);
+  }
+
   // ── Buttons ────────────────────────────────────────────
   // Top: 1-click=play/pause, 2-click=skip, 3-click=prev, long=flip
   topBtn.attachClick(onPlayPause);
@@ -711,30 +1473,9 @@ void setup() {
   botBtn.attachClick(onScreenToggle);
 
   // ── Config web server ──────────────────────────────────
+  bootBegin(BOOT_SERVER);
   startConfigServer();
-
-  // ── Data mutex ─────────────────────────────────────────
-  dataMutex = xSemaphoreCreateMutex();
-
-  // ── First poll + draw (before background task starts) ──
-  tft.fillScreen(TFT_BLACK);
-  pollSpotifyData();
-  bgLastPoll = millis();
-  // Process initial flags immediately
-  uint32_t initFlags = redrawFlags;
-  redrawFlags = 0;
-  if (initFlags & RFLAG_TRACK_CHANGED) {
-    setBrightness(brightPlay, "boot-play");
-    drawInfo();
-    showAlbumArt(now.imgUrl);
-  } else {
-    setBrightness(brightIdle, "boot-idle");
-    drawInfo();  // idle screen
-  }
-
-  // ── Start background task on core 0 ────────────────────
-  // Must be after first poll so both cores don't call Spotify API simultaneously
-  xTaskCreatePinnedToCore(backgroundTask, "bg", 16384, NULL, 1, NULL, 0);
+  bootEnd(BOOT_SERVER);
 }
 
 // ============================================================
@@ -791,15 +1532,16 @@ static void drawTui() {
   unsigned long upS = millis() / 1000;
   unsigned int uh = upS / 3600, um = (upS / 60) % 60, us = upS % 60;
 
-  String track, artist, album, device;
-  int prog, dur;
-  bool playing, active;
-  xSemaphoreTake(dataMutex, portMAX_DELAY);
-  track   = now.track;   artist = now.artist;  album = now.album;
-  device  = now.device;  prog   = now.progress; dur  = now.duration;
-  playing = now.playing; active = now.active;
-  if (active && playing) prog += (int)(millis() - now.pollTime);
-  xSemaphoreGive(dataMutex);
+  // `view` is core 1's own snapshot — no locking needed
+  const char* track  = view.track;
+  const char* artist = view.artist;
+  const char* album  = view.album;
+  const char* device = view.device;
+  int  prog    = view.progress;
+  int  dur     = view.duration;
+  bool playing = view.playing;
+  bool active  = view.active;
+  if (active && playing) prog += (int)(millis() - view.pollTime);
 
   // Health-based colors
   int rssi = (int)WiFi.RSSI();
@@ -839,26 +1581,162 @@ static void drawTui() {
     lastCore0Pct, lastCore1Pct, rssiC, rssi);
   Serial.print(line);
 
-  // ── IP ──
+  // ── Power ──
+  // Light sleep needs both cores idle, so their idle overlap is at
+  // least 100 - core0 - core1; the chip can only sleep inside it
+  PowerStats pw;
+  powerStats(pw);
+  const char* sleepStr = pw.support != PWR_LIGHT_SLEEP ? "n/a" : !pw.low ? "off"
+                       : pw.usbAwake ? "usb" : "auto";
+  int idleMin = constrain((int)(100 - lastCore0Pct - lastCore1Pct), 0, 100);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Power: " "%s%-4s" CVAL "  %3u MHz" CLBL "  Sleep: " "%s%-4s"
+    CLBL "  Idle>=" CVAL "%3d%%" CLBL "  Low: " CVAL "%3lu%%" CRST TUI_R,
+    pw.low ? CGOOD : CVAL, pw.low ? "low" : "full", (unsigned)pw.cpuMhz,
+    strcmp(sleepStr, "auto") == 0 ? CGOOD : CVAL, sleepStr, idleMin,
+    millis() ? pw.lowMs * 100 / millis() : 0);
+  Serial.print(line);
+
+  // ── Radio duty cycle (rolling hour) ──
+  RadioStats rs;
+  radioStats(rs);
+  unsigned long hourMs = min(millis(), 3600000UL);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Radio: " CVAL "%5.1fs/h %4.1f%%" CLBL "  Wakes/h: " CVAL "%4u"
+    CLBL "  Batched: " CGOOD "%4u" CVAL "/" "%s%u" CRST TUI_R,
+    rs.activeMsHour / 1000.0f, hourMs ? 100.0f * rs.activeMsHour / hourMs : 0.0f,
+    (unsigned)rs.wakesHour, (unsigned)rs.batched, rs.alone ? CWARN : CVAL, (unsigned)rs.alone);
+  Serial.print(line);
+
+  // ── IP + link ──
+  WifiStats ws;
+  wifiStats(ws);
+  static const char* LINK_NAMES[] = { "up", "down", "conn" };
   snprintf(line, sizeof(line),
-    TUI_L CLBL "IP   : " CINFO "%s" CRST TUI_R,
-    WiFi.localIP().toString().c_str());
+    TUI_L CLBL "IP   : " CINFO "%-15s" CRST "  "
+    CLBL "Link: " "%s%-4s" CLBL "  Drops: " "%s%3u" CLBL "  Down: " CVAL "%5lus" CRST TUI_R,
+    WiFi.localIP().toString().c_str(),
+    ws.state == WIFI_UP ? CGOOD : CBAD, LINK_NAMES[ws.state],
+    ws.drops ? CWARN : CVAL, (unsigned)ws.drops, ws.downMs / 1000);
+  Serial.print(line);
+
+  // ── Boot ──
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Boot : " CVAL "IP at " "%s%lu ms" CLBL " (%s)" CRST TUI_R,
+    ws.bootFast ? CGOOD : CVAL, ws.bootIpMs, ws.bootFast ? "cached AP + lease" : "scan + DHCP");
+  Serial.print(line);
+
+  // ── Warm boot ──
+  WarmStats warm;
+  warmStats(warm);
+  static const char* WARM_NAMES[] = { "none", "RTC", "flash" };
+  char ageStr[12];
+  if (warm.ageS >= 0) snprintf(ageStr, sizeof(ageStr), "%lds", warm.ageS);
+  else               strlcpy(ageStr, "-", sizeof(ageStr));
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Warm : " "%s%-5s" CLBL "  Age: " CVAL "%6s" CLBL "  Token: " "%s%-3s"
+    CLBL "  Art: " "%s%-3s" CLBL " Wr: " CVAL "%u/%u" CRST TUI_R,
+    warm.source == WARM_NONE ? CVAL : CGOOD, WARM_NAMES[warm.source], ageStr,
+    tokenWarm ? CGOOD : CVAL, tokenWarm ? "yes" : "no",
+    warm.art ? CGOOD : CVAL, warm.art ? "yes" : "no",
+    (unsigned)warm.flashSaves, (unsigned)warm.artSaves);
+  Serial.print(line);
+
+  // ── Price providers ──
+  TickerStats cg, fh;
+  tickerStats(TP_COINGECKO, cg);
+  tickerStats(TP_FINNHUB, fh);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Price: CG " CVAL "%5lu/%5lums " "%s%u/%u"
+    CLBL "  FH " CVAL "%5lu/%5lums " "%s%u/%u" CRST TUI_R,
+    (unsigned long)cg.lastMs, (unsigned long)cg.avgMs,
+    cg.got < cg.asked ? CWARN : CGOOD, (unsigned)cg.got, (unsigned)cg.asked,
+    (unsigned long)fh.lastMs, (unsigned long)fh.avgMs,
+    fh.got < fh.asked ? CWARN : CGOOD, (unsigned)fh.got, (unsigned)fh.asked);
+  Serial.print(line);
+
+  // ── Adaptive polling ──
+  unsigned long lagAvg = trackLagCount ? trackLagSumMs / trackLagCount : 0;
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Poll : " CVAL "%4.1fs" "   "
+    CLBL "Req/h: " CVAL "%5u" "   "
+    CLBL "Track lag: " CVAL "%lu/%lu ms" CRST TUI_R,
+    pollIntervalMs / 1000.0f, (unsigned)pollRequestsLastHour(), trackLagLastMs, lagAvg);
+  Serial.print(line);
+
+  // ── Access token ──
+  long tokLeft = tokenExpiresAt ? (long)(tokenExpiresAt - millis()) / 1000 : -1;
+  const char* tokC = (tokLeft < 0) ? CBAD : (tokLeft < (long)(TOKEN_REFRESH_LEAD_MS / 1000)) ? CWARN : CGOOD;
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Token: " "%s%3ldm%02lds" CRST "   "
+    CLBL "Refreshed: " CVAL "%4u" "   "
+    CLBL "Deferred: " CVAL "%4u" CRST TUI_R,
+    tokC, max(tokLeft, 0L) / 60, max(tokLeft, 0L) % 60,
+    (unsigned)tokenRefreshes, (unsigned)tokenDeferred);
+  Serial.print(line);
+
+  // ── Playback actions ──
+  unsigned long actAvg = actionLatCount ? actionLatSumMs / actionLatCount : 0;
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Act  : " CVAL "rtt %4lums" "   "
+    CLBL "Confirm: " CVAL "%lu/%lu ms" "   "
+    CLBL "Lost: " CVAL "%u" CRST TUI_R,
+    actionRttLastMs, actionLatLastMs, actAvg, (unsigned)actionUnconfirmed);
+  Serial.print(line);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Queue: " CVAL "%2u/%u" "  "
+    CLBL "Max: " CVAL "%2u" "  "
+    CLBL "Merged: " CVAL "%4u" "  "
+    CLBL "Failed: " CVAL "%3u" "  "
+    CLBL "Dropped: " CVAL "%u" CRST TUI_R,
+    (unsigned)(buttonActions.size() + webActions.size()), (unsigned)(2 * ACTION_QUEUE_LEN),
+    (unsigned)actionDepthMax, (unsigned)actionMerged, (unsigned)actionFailed,
+    (unsigned)actionDrops.load());
+  Serial.print(line);
+
+  // ── Core 0 jobs section ──
+  Serial.print(CBRD "+-- " CSEC "Core 0 jobs (wait, ms)" CBRD " --------------------------------------+" CRST "\r\n");
+
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "%-10s%7s%7s%7s%7s%6s%6s%6s" CRST TUI_R,
+    "Class", "Runs", "Last", "Avg", "Max", "Late", "Over", "Yield");
+  Serial.print(line);
+  for (int c = 0; c < JC_COUNT; c++) {
+    JobStats js;
+    schedStats((JobClass)c, js);
+    snprintf(line, sizeof(line),
+      TUI_L CINFO "%-10s" CVAL "%7lu%7lu%7lu%7lu" "%s%6lu" "%s%6lu" CVAL "%6lu" CRST TUI_R,
+      schedClassName((JobClass)c), (unsigned long)js.runs, (unsigned long)js.lastWaitMs,
+      (unsigned long)js.avgWaitMs, (unsigned long)js.maxWaitMs,
+      js.late ? CWARN : CVAL, (unsigned long)js.late,
+      js.over ? CWARN : CVAL, (unsigned long)js.over, (unsigned long)js.yielded);
+    Serial.print(line);
+  }
+  ReactorStats fs;
+  reactorStats(fs);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Fetch: " CVAL "%u live" CLBL " Done " CVAL "%5lu"
+    CLBL " Fail " "%s%3lu" CLBL " Late " "%s%3lu" CLBL " Retry " CVAL "%3lu %5lums" CRST TUI_R,
+    (unsigned)fs.live, (unsigned long)fs.done,
+    fs.failed ? CWARN : CVAL, (unsigned long)fs.failed,
+    fs.late ? CWARN : CVAL, (unsigned long)fs.late,
+    (unsigned long)fs.retries, (unsigned long)fs.lastMs);
   Serial.print(line);
 
   // ── Now playing section header ──
   Serial.print(CBRD "+-- " CSEC "Now playing" CBRD " -------------------------------------------------+" CRST "\r\n");
 
   if (active) {
-    truncPad(fld, sizeof(fld), track.c_str(), 53);
+    truncPad(fld, sizeof(fld), track, 53);
     snprintf(line, sizeof(line), TUI_L CLBL "Track  : " CVAL "%s" CRST TUI_R, fld);
     Serial.print(line);
-    truncPad(fld, sizeof(fld), artist.c_str(), 53);
+    truncPad(fld, sizeof(fld), artist, 53);
     snprintf(line, sizeof(line), TUI_L CLBL "Artist : " CVAL "%s" CRST TUI_R, fld);
     Serial.print(line);
-    truncPad(fld, sizeof(fld), album.c_str(), 53);
+    truncPad(fld, sizeof(fld), album, 53);
     snprintf(line, sizeof(line), TUI_L CLBL "Album  : " CVAL "%s" CRST TUI_R, fld);
     Serial.print(line);
-    truncPad(fld, sizeof(fld), device.c_str(), 53);
+    truncPad(fld, sizeof(fld), device, 53);
     snprintf(line, sizeof(line), TUI_L CLBL "Device : " CINFO "%s" CRST TUI_R, fld);
     Serial.print(line);
 
@@ -879,48 +1757,229 @@ static void drawTui() {
   // ── Data usage section header ──
   Serial.print(CBRD "+-- " CSEC "Data usage (session)" CBRD " ----------------------------------------+" CRST "\r\n");
 
+  // RX is wire bytes; Decoded is what the parsers saw after gunzip
   snprintf(line, sizeof(line),
-    TUI_L "             " CLBL "      TX            RX" CRST TUI_R);
+    TUI_L "             " CLBL "      TX            RX       Decoded" CRST TUI_R);
   Serial.print(line);
 
-  char tx[16], rx[16];
-  fmtBytes(tx, sizeof(tx), netSpotify.txBytes);
-  fmtBytes(rx, sizeof(rx), netSpotify.rxBytes);
+  char tx[16], rx[16], dec[16];
+  const NetStats* cats[]  = { &netSpotify, &netArt, &netTicker };
+  const char*     names[] = { "Spotify", "Album art", "Ticker" };
+  NetStats tot;
+  for (int i = 0; i < 3; i++) {
+    fmtBytes(tx,  sizeof(tx),  cats[i]->txBytes);
+    fmtBytes(rx,  sizeof(rx),  cats[i]->rxBytes);
+    fmtBytes(dec, sizeof(dec), cats[i]->rxDecoded);
+    snprintf(line, sizeof(line),
+      TUI_L CLBL "%-12s" CWARN "%10s" CRST "    " CINFO "%10s" CRST "    " CVAL "%10s" CRST TUI_R,
+      names[i], tx, rx, dec);
+    Serial.print(line);
+    tot.txBytes   += cats[i]->txBytes;
+    tot.rxBytes   += cats[i]->rxBytes;
+    tot.rxDecoded += cats[i]->rxDecoded;
+  }
+
+  // Separator inside section
   snprintf(line, sizeof(line),
-    TUI_L CLBL "%-12s" CWARN "%10s" CRST "    " CINFO "%10s" CRST TUI_R,
-    "Spotify", tx, rx);
+    TUI_L CBRD "--------------------------------------------------" CRST TUI_R);
   Serial.print(line);
 
-  fmtBytes(tx, sizeof(tx), netArt.txBytes);
-  fmtBytes(rx, sizeof(rx), netArt.rxBytes);
+  fmtBytes(tx,  sizeof(tx),  tot.txBytes);
+  fmtBytes(rx,  sizeof(rx),  tot.rxBytes);
+  fmtBytes(dec, sizeof(dec), tot.rxDecoded);
   snprintf(line, sizeof(line),
-    TUI_L CLBL "%-12s" CWARN "%10s" CRST "    " CINFO "%10s" CRST TUI_R,
-    "Album art", tx, rx);
+    TUI_L CLBL "%-12s" CWARN "%10s" CRST "    " CINFO "%10s" CRST "    " CVAL "%10s" CRST TUI_R,
+    "Total", tx, rx, dec);
   Serial.print(line);
 
-  fmtBytes(tx, sizeof(tx), netTicker.txBytes);
-  fmtBytes(rx, sizeof(rx), netTicker.rxBytes);
+  uint32_t savedB = tot.rxDecoded > tot.rxBytes ? tot.rxDecoded - tot.rxBytes : 0;
+  char saved[16]; fmtBytes(saved, sizeof(saved), savedB);
   snprintf(line, sizeof(line),
-    TUI_L CLBL "%-12s" CWARN "%10s" CRST "    " CINFO "%10s" CRST TUI_R,
-    "Ticker", tx, rx);
+    TUI_L CLBL "%-12s" CGOOD "%10s" CRST CLBL " saved by gzip (%u%% of decoded)" CRST TUI_R,
+    "", saved, tot.rxDecoded ? (unsigned)((uint64_t)savedB * 100 / tot.rxDecoded) : 0u);
   Serial.print(line);
 
-  // Separator inside section
+  // Bodies the HTTP cache made unnecessary (fresh skips + 304s)
+  HttpCacheStats hc;
+  httpCacheStats(hc);
+  fmtBytes(saved, sizeof(saved), hc.avoidedBytes);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "%-12s" CGOOD "%10s" CRST CLBL " by cache: %u fresh, %u 304 (%u/%d)" CRST TUI_R,
+    "", saved, (unsigned)hc.fresh, (unsigned)hc.notModified, (unsigned)hc.entries,
+    HTTP_CACHE_SLOTS);
+  Serial.print(line);
+
+  // ── Connection pool section ──
+  Serial.print(CBRD "+-- " CSEC "Connection pool" CBRD " ---------------------------------------------+" CRST "\r\n");
+
+  static PoolStats pool;   // ~300 bytes — keep it off the loop() stack
+  poolStats(pool);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Open: " CVAL "%d/%d" CLBL "  Evict: " "%s%4u" CLBL "  Dead: " CVAL "%4u"
+    CLBL "  Defer: " CVAL "%4u" CLBL "  Int: " CVAL "%3uK" CRST TUI_R,
+    pool.open, (int)min<uint32_t>(POOL_SLOTS, POOL_HEAP_BUDGET / tlsSessionCost(POOL_TLS_CTX_BYTES)),
+    pool.evictions ? CWARN : CVAL, (unsigned)pool.evictions,
+    (unsigned)pool.deadProbes, (unsigned)pool.deferred,
+    (unsigned)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024));
+  Serial.print(line);
+
+  static const char* PRIO_NAMES[] = { "ticker", "art", "spotify" };
+  for (int i = 0; i < pool.count; i++) {
+    const PoolSlotInfo& s = pool.slots[i];
+    const char* state = s.leased > 1 ? "shared" : s.leased ? "leased" : s.open ? "open" : "closed";
+    const char* stC   = s.leased ? CINFO : s.open ? CGOOD : CLBL;
+    snprintf(line, sizeof(line),
+      TUI_L CINFO "%-24.24s " CVAL "%-8s" "%s%-7s" CVAL "%6lus" CLBL "  leases " CVAL "%5u" CRST TUI_R,
+      s.host, PRIO_NAMES[s.prio], stC, state, s.idleMs / 1000, (unsigned)s.leases);
+    Serial.print(line);
+  }
+
+  // ── TLS handshakes section ──
+  Serial.print(CBRD "+-- " CSEC "TLS handshakes" CBRD " ----------------------------------------------+" CRST "\r\n");
+
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "%-15s%5s%5s%5s%7s%4s%4s%4s%4s%4s%4s" CRST TUI_R,
+    "Host", "Full", "Res", "Fail", "Last ", "100", "250", "500", "1k", "2k", ">2k");
+  Serial.print(line);
+
+  TlsHostStats tls[TLS_HOST_SLOTS];
+  int nTls = tlsHostStats(tls, TLS_HOST_SLOTS);
+  for (int i = 0; i < nTls; i++) {
+    const TlsHostStats& h = tls[i];
+    const char* lastC = h.lastResumed ? CGOOD : (h.lastMs > 1000) ? CWARN : CVAL;
+    snprintf(line, sizeof(line),
+      TUI_L CINFO "%-15.15s" CVAL "%5u%5u" "%s%5u" "%s%6u%c" CVAL "%4u%4u%4u%4u%4u%4u" CRST TUI_R,
+      h.host, h.full, h.resumed, h.failed ? CBAD : CVAL, h.failed,
+      lastC, h.lastMs, h.lastResumed ? 'r' : ' ',
+      h.hist[0], h.hist[1], h.hist[2], h.hist[3], h.hist[4], h.hist[5]);
+    Serial.print(line);
+  }
+
+  // HTTP/2 sessions; heads as HPACK bytes against the same heads as HTTP/1.1 text
+  H2Stats h2;
+  h2Stats(h2);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "H2  sess " CVAL "%3lu" CLBL "  streams " CVAL "%5lu" CLBL "  open " CVAL "%u"
+    CLBL "  head " CGOOD "%3u%%" CLBL " of 1.1         " CRST TUI_R,
+    (unsigned long)h2.sessions, (unsigned long)h2.streams, (unsigned)h2.maxOpen,
+    h2.headRaw ? (unsigned)((uint64_t)h2.headWire * 100 / h2.headRaw) : 0);
+  Serial.print(line);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "    cancel " CVAL "%4lu" CLBL "  rst " "%s%4lu" CLBL "  goaway " CVAL "%3lu"
+    CLBL "  err " "%s%3lu" "                " CRST TUI_R,
+    (unsigned long)h2.cancelled, h2.resets ? CWARN : CVAL, (unsigned long)h2.resets,
+    (unsigned long)h2.goaways, h2.errors ? CBAD : CVAL, (unsigned long)h2.errors);
+  Serial.print(line);
+
+  // ── TLS memory section ──
+  Serial.print(CBRD "+-- " CSEC "TLS memory" CBRD " --------------------------------------------------+" CRST "\r\n");
+
+  // Per placement policy: average handshake, internal heap at its
+  // peak and what the session holds once connected (serial TLSBENCH)
+  static TlsAllocStats ta;   // ~100 bytes — keep it off the loop() stack
+  tlsAllocStats(ta);
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "%-10s%7s%7s%7s%7s%7s%5s            " CRST TUI_R,
+    "Policy", "Full", "Res", "Peak", "Held", "PSRAM", "n");
+  Serial.print(line);
+  for (int p = 0; p < TLS_ALLOC_POLICIES; p++) {
+    const TlsPolicyStats& ps = ta.policies[p];
+    snprintf(line, sizeof(line),
+      TUI_L "%s%c%-9s" CVAL "%5lums%5lums%6uK%6uK%6uK%5u            " CRST TUI_R,
+      p == ta.policy ? CGOOD : CINFO, p == ta.policy ? '*' : ' ',
+      tlsAllocName((TlsAllocPolicy)p),
+      (unsigned long)(ps.full ? ps.fullMsSum / ps.full : 0),
+      (unsigned long)(ps.resumed ? ps.resumedMsSum / ps.resumed : 0),
+      (unsigned)(ps.peakInternal / 1024), (unsigned)(ps.residentInternal / 1024),
+      (unsigned)(ps.residentPsram / 1024), (unsigned)ps.full);
+    Serial.print(line);
+  }
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "Now  int " CVAL "%4uK" CLBL "  psram " CVAL "%4uK" CLBL "  fallback " "%s%4lu"
+    CLBL "  fail " "%s%3lu" "  " "%s%-8s" CRST TUI_R,
+    (unsigned)(ta.internal / 1024), (unsigned)(ta.psram / 1024),
+    ta.fallbacks ? CWARN : CVAL, (unsigned long)ta.fallbacks,
+    ta.failed ? CBAD : CVAL, (unsigned long)ta.failed,
+    ta.installed ? CVAL : CWARN, ta.installed ? "tracked" : "fixed");
+  Serial.print(line);
+
+  // ── Boot timeline section ──
+  Serial.print(CBRD "+-- " CSEC "Boot timeline (ms)" CBRD " ------------------------------------------+" CRST "\r\n");
+
+  // Bars share one scale: the latest stage end
+  unsigned long bootSpan = 1;
+  for (int i = 0; i < BOOT_STAGES; i++) bootSpan = max(bootSpan, bootEndAt[i]);
+  for (int i = 0; i < BOOT_STAGES; i++) {
+    char bar[32];
+    const int W = 26;
+    int from = bootStartAt[i] * W / bootSpan;
+    int to   = bootEndAt[i] ? max((int)(bootEndAt[i] * W / bootSpan), from + 1) : from;
+    for (int x = 0; x < W; x++) bar[x] = (x >= from && x < to) ? '#' : '.';
+    bar[W] = 0;
+    if (bootEndAt[i]) {
+      snprintf(line, sizeof(line),
+        TUI_L CLBL "%-8s" CVAL "%7lu%7lu%7lu  " CINFO "%s" CRST TUI_R,
+        BOOT_NAMES[i], bootStartAt[i], bootEndAt[i], bootEndAt[i] - bootStartAt[i], bar);
+    } else {
+      snprintf(line, sizeof(line),
+        TUI_L CLBL "%-8s" CBRD "%7s%7s%7s  %s" CRST TUI_R,
+        BOOT_NAMES[i], bootStartAt[i] ? "..." : "-", "-", "-", bar);
+    }
+    Serial.print(line);
+  }
+
+  // ── Connect timing section ──
+  Serial.print(CBRD "+-- " CSEC "Connect timing (last, ms)" CBRD " -----------------------------------+" CRST "\r\n");
+
+  snprintf(line, sizeof(line),
+    TUI_L CLBL "%-22s%6s%6s%6s%6s%8s" CRST TUI_R, "Host", "DNS", "TCP", "TLS", "TTFB", "DNS TTL");
+  Serial.print(line);
+
+  for (int i = 0; i < nTls; i++) {
+    const TlsHostStats& h = tls[i];
+    long ttl = dnsTtlLeft(h.host);
+    char ttlS[12] = "-";
+    if (ttl >= 0) snprintf(ttlS, sizeof(ttlS), "%lds", ttl);
+    snprintf(line, sizeof(line),
+      TUI_L CINFO "%-22.22s" "%s%6u" CVAL "%6u%6u%6u" "%s%8s" CRST TUI_R,
+      h.host, h.dnsMs ? CWARN : CGOOD, h.dnsMs, h.tcpMs, h.lastMs, h.ttfbMs,
+      ttl > 0 ? CVAL : CLBL, ttlS);
+    Serial.print(line);
+  }
+
+  DnsStats dns;
+  dnsStats(dns);
   snprintf(line, sizeof(line),
-    TUI_L CBRD "--------------------------------------------" CRST TUI_R);
+    TUI_L CLBL "DNS  hit " CGOOD "%5u" CLBL "  miss " CVAL "%4u" CLBL "  pre " CVAL "%4u"
+    CLBL "  fail " "%s%3u" CLBL "  stale " CVAL "%3u" CLBL "  %u/%d" CRST TUI_R,
+    (unsigned)dns.hits, (unsigned)dns.misses, (unsigned)dns.prefetched,
+    dns.failed ? CWARN : CVAL, (unsigned)dns.failed, (unsigned)dns.stale,
+    (unsigned)dns.entries, DNS_CACHE_SLOTS);
   Serial.print(line);
 
-  uint32_t totTx = netSpotify.txBytes + netArt.txBytes + netTicker.txBytes;
-  uint32_t totRx = netSpotify.rxBytes + netArt.rxBytes + netTicker.rxBytes;
-  fmtBytes(tx, sizeof(tx), totTx);
-  fmtBytes(rx, sizeof(rx), totRx);
-  char tot[16]; fmtBytes(tot, sizeof(tot), totTx + totRx);
+  // ── Endpoint health section ──
+  Serial.print(CBRD "+-- " CSEC "Endpoint health" CBRD " ---------------------------------------------+" CRST "\r\n");
+
   snprintf(line, sizeof(line),
-    TUI_L CLBL "%-12s" CWARN "%10s" CRST "    " CINFO "%10s" CRST
-    "   " CVAL "(total " CLBL "%s" CVAL ")" CRST TUI_R,
-    "Total", tx, rx, tot);
+    TUI_L CLBL "%-14s%-10s%6s%6s%5s%8s%7s" CRST TUI_R,
+    "Endpoint", "State", "Fails", "Trips", "429", "Refused", "Retry");
   Serial.print(line);
 
+  static const char* BRK_NAMES[] = { "closed", "OPEN", "half-open" };
+  static const char* BRK_COLORS[] = { CGOOD, CBAD, CWARN };
+  for (int i = 0; i < EP_COUNT; i++) {
+    BreakerInfo b;
+    breakerInfo((Endpoint)i, b);
+    char retry[12] = "-";
+    if (b.state == BREAKER_OPEN) snprintf(retry, sizeof(retry), "%lus", (b.retryInMs + 999) / 1000);
+    snprintf(line, sizeof(line),
+      TUI_L CINFO "%-14s" "%s%-10s" CVAL "%6u%6u" "%s%5u" CVAL "%8u%7s" CRST TUI_R,
+      endpointName((Endpoint)i), BRK_COLORS[b.state], BRK_NAMES[b.state],
+      (unsigned)b.failures, (unsigned)b.trips, b.throttled ? CWARN : CVAL,
+      (unsigned)b.throttled, (unsigned)b.refused, retry);
+    Serial.print(line);
+  }
+
   // ── Bottom border ──
   Serial.print(CBRD "+================================================================+" CRST "\r\n");
 }
@@ -938,17 +1997,19 @@ void loop() {
   unsigned long ms = millis();
 
   // ── Process redraw flags from core 0 ──────────────────
-  uint32_t flags = redrawFlags;
+  // Flags are raised after the matching publish, so fetching them first
+  // guarantees the snapshot read below is at least as new.
+  uint32_t flags = redrawFlags.exchange(0);
+  playbackPub.readIfNewer(view, viewGen);
+  // The first answer takes the stale mark off the warm-boot screen
+  bool wasStale = viewStale;
+  if (flags & RFLAG_FRESH) viewStale = false;
   if (flags) {
-    redrawFlags = 0;
-
     if (flags & RFLAG_GONE_IDLE) {
       // Don't override brightness if user just changed settings (3s cooldown)
       if (ms - brightSettingsAt > 3000) setBrightness(brightIdle, "idle");
       tft.fillScreen(TFT_BLACK);
-      xSemaphoreTake(dataMutex, portMAX_DELAY);
       drawInfo();
-      xSemaphoreGive(dataMutex);
     }
 
     if (flags & RFLAG_TRACK_CHANGED) {
@@ -956,45 +2017,49 @@ void loop() {
         lastTimeStr = "";
       }
 
-      String imgUrl;
-      xSemaphoreTake(dataMutex, portMAX_DELAY);
-      imgUrl = now.imgUrl;
-      xSemaphoreGive(dataMutex);
-
       tft.fillScreen(TFT_BLACK);
       if (ms - brightSettingsAt > 3000) setBrightness(brightPlay, "track");
-
-      xSemaphoreTake(dataMutex, portMAX_DELAY);
       drawInfo();
-      xSemaphoreGive(dataMutex);
-
-      showAlbumArt(imgUrl);
+      showAlbumArt(view.imgUrl);   // same album, or already delivered
+      bootEnd(BOOT_TRACK);
     } else if (flags & RFLAG_DEVICE_CHANGED) {
-      xSemaphoreTake(dataMutex, portMAX_DELAY);
       drawInfo();
-      xSemaphoreGive(dataMutex);
     } else if (flags & RFLAG_PLAY_CHANGED) {
-      xSemaphoreTake(dataMutex, portMAX_DELAY);
-      drawIcon(now.playing);
-      drawBar(now.progress, now.duration);
-      xSemaphoreGive(dataMutex);
+      drawIcon(view.playing);
+      drawBar(view.progress, view.duration);
     }
 
-    if (flags & RFLAG_TICKER_READY) {
-      recalcTickerWidth();
+    // Same track as before the reset: redraw without the mark (core 0
+    // fetches the cover if flash didn't have it)
+    if (wasStale && (flags & RFLAG_FRESH) &&
+        !(flags & (RFLAG_GONE_IDLE | RFLAG_TRACK_CHANGED))) {
+      drawInfo();
+    }
+
+    // Cover downloaded on core 0; drawn if it is still this track's
+    if ((flags & RFLAG_ART) && view.active) showAlbumArt(view.imgUrl);
+  }
+
+  // ── New ticker snapshot from core 0 ───────────────────
+  if (tickerPub.readIfNewer(tickerView, tickerViewGen)) {
+    recalcTickerWidth();
+    if (!tickerReady) {
+      // List was reloaded (no prices yet) — restart the strip
+      tickerScrollX = 0;
+      if (!view.active) tft.fillRect(0, TICKER_Y, SCR_W, TICKER_H, TFT_BLACK);
     }
   }
 
   // ── Progress bar (interpolated) ───────────────────────
-  if (screenOn && now.active && now.playing && ms - lastBar >= BAR_MS) {
+  if (screenOn && view.active && view.playing && ms - lastBar >= BAR_MS) {
     lastBar = ms;
-    int elapsed = ms - now.pollTime;
-    int cur = min(now.progress + (int)elapsed, now.duration);
-    drawBar(cur, now.duration);
+    int elapsed = ms - view.pollTime;
+    int cur = min(view.progress + (int)elapsed, view.duration);
+    drawBar(cur, view.duration);
   }
 
   // ── Title scrolling ───────────────────────────────────
-  if (screenOn && now.active && titlePixelW > TXT_W) {
+  if (screenOn && view.active && titlePixelW > TXT_W) {
     if (scrollPaused) {
       if (ms >= scrollPauseAt) {
         scrollPaused = false;
@@ -1008,33 +2073,20 @@ void loop() {
         scrollPaused = true;
         scrollPauseAt = ms + SCROLL_PAUSE_MS;
       }
-      xSemaphoreTake(dataMutex, portMAX_DELAY);
       drawTitle();
-      xSemaphoreGive(dataMutex);
     }
   }
 
   // ── Clock ─────────────────────────────────────────────
   if (screenOn && ms - lastClock >= CLOCK_MS) {
     lastClock = ms;
-    if (now.active) {
+    if (view.active) {
       drawClock();
     } else {
       drawIdleClock();
     }
   }
 
-  // ── Ticker list changed via web UI or serial ──────────
-  if (tickerListChanged) {
-    tickerListChanged = false;
-    loadTickers();
-    stockApiKey = prefs.getString("stockkey", "d6m0k71r01qu3p05ktsgd6m0k71r01qu3p05ktt0");
-    tickerReady = false;
-    tickerScrollX = 0;
-    bgTickerFetchNeeded = true;
-    if (!now.active) tft.fillRect(0, TICKER_Y, SCR_W, TICKER_H, TFT_BLACK);
-  }
-
   // ── Settings changed (brightness/timezone) via web UI ──
   if (settingsChanged) {
     settingsChanged = false;
@@ -1046,16 +2098,14 @@ void loop() {
     configTime(gmt, dst, "pool.ntp.org", "time.nist.gov");
     lastTimeStr = "";
 
-    xSemaphoreTake(dataMutex, portMAX_DELAY);
-    bool active = now.active;
-    xSemaphoreGive(dataMutex);
+    bool active = view.active;
     brightSettingsAt = millis();  // Prevent polls from overriding for 3s
     uint8_t target = active ? brightPlay : brightIdle;
     setBrightness(target, active ? "settings-play" : "settings-idle");
   }
 
   // ── Ticker scrolling (never interrupted by network) ───
-  if (screenOn && !now.active && tickerReady &&
+  if (screenOn && !view.active && tickerReady &&
       ms - lastTickerScroll >= TICKER_SCROLL_MS) {
     lastTickerScroll = ms;
     tickerScrollX++;
@@ -1067,6 +2117,9 @@ void loop() {
   // ── Serial input ──────────────────────────────────────
   checkSerialInput();
 
+  // ── Boot timeline (once) ──────────────────────────────
+  if (!bootLogged) logBootTimeline(ms);
+
 #if TUI_ENABLED
   // ── Telemetry TUI repaint ────────────────────────────
   if (ms - lastTuiDraw >= TUI_REFRESH_MS) {
@@ -1089,7 +2142,7 @@ void loop() {
     LOG("[CPU] Core 0: %.1f%%  Core 1: %.1f%%  Heap: %u  Temp: %.1fC\n",
                   c0, c1, ESP.getFreeHeap(), cpuTempC);
     if (screenOn) {
-      if (now.active) {
+      if (view.active) {
         drawCpuTemp(CPU_TEMP_PLAY_X, CPU_TEMP_PLAY_Y, cpuTempC, COLOR_DIM_GREY);
       } else {
         drawCpuTemp(CPU_TEMP_IDLE_X, CPU_TEMP_IDLE_Y, cpuTempC, COLOR_DIM_GREY);
@@ -1100,6 +2153,13 @@ void loop() {
     cpuLastReport = ms;
   }
 
+  // ── Power mode ────────────────────────────────────────
+  powerUpdate(screenOn, view.active && view.playing);
+
   // ── Yield to RTOS (prevents 100% busy loop) ───────────
-  delay(1);
+  // Longer in low power, so the idle task gets long enough stretches
+  // to light-sleep in
+  if (!powerLow())    delay(1);
+  else if (screenOn)  delay(PWR_LOOP_IDLE_MS);
+  else                delay(PWR_LOOP_OFF_MS);
 }
@@ -4,6 +4,7 @@
 
 #include "config.h"
 #include <esp_https_server.h>
+#include <esp_wifi.h>
 #include "certs.h"
 
 // ── OAuth state ─────────────────────────────────────────
@@ -223,53 +224,77 @@ static esp_err_t now_page_handler(httpd_req_t* req) {
   return ESP_OK;
 }
 
+// ── Playback control endpoint ───────────────────────────
+// POST /api/control?cmd=play|pause|next|prev|seek|volume[&v=<ms|%>]
+static esp_err_t api_control_handler(httpd_req_t* req) {
+  char query[64] = {0}, cmd[12] = {0}, val[12] = {0};
+  if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+    httpd_query_key_value(query, "cmd", cmd, sizeof(cmd));
+    httpd_query_key_value(query, "v",   val, sizeof(val));
+  }
+  PendingAction a = ACTION_NONE;
+  if      (!strcmp(cmd, "play"))   a = ACTION_PLAY;
+  else if (!strcmp(cmd, "pause"))  a = ACTION_PAUSE;
+  else if (!strcmp(cmd, "next"))   a = ACTION_SKIP;
+  else if (!strcmp(cmd, "prev"))   a = ACTION_PREV;
+  else if (!strcmp(cmd, "seek"))   a = ACTION_SEEK;
+  else if (!strcmp(cmd, "volume")) a = ACTION_VOLUME;
+  if (a == ACTION_NONE || !spotifyReady) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown command");
+    return ESP_FAIL;
+  }
+  LOG("[Web] Control: %s %s\n", cmd, val);
+  if (!queueAction(a, atoi(val), SRC_WEB)) {
+    const char* busy = "{\"ok\":false,\"error\":\"queue full\"}";
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, busy, strlen(busy));
+    return ESP_OK;
+  }
+  const char* resp = "{\"ok\":true}";
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_send(req, resp, strlen(resp));
+  return ESP_OK;
+}
+
 // ── Playback state JSON endpoint ────────────────────────
 static esp_err_t api_state_handler(httpd_req_t* req) {
-  // Copy playback state under mutex
-  bool active, playing;
-  String track, artist, album, device, imgUrl;
-  int progress, duration;
-  unsigned long pollTime;
-
-  xSemaphoreTake(dataMutex, portMAX_DELAY);
-  active   = now.active;
-  playing  = now.playing;
-  track    = now.track;
-  artist   = now.artist;
-  album    = now.album;
-  device   = now.device;
-  imgUrl   = now.imgUrl;
-  progress = now.progress;
-  duration = now.duration;
-  pollTime = now.pollTime;
-  xSemaphoreGive(dataMutex);
+  // Someone is watching the web UI — keep its view fresh
+  notePollActivity();
+
+  // Consistent lock-free copies of the published snapshots
+  Playback   pb;
+  TickerList tl;
+  playbackPub.read(pb);
+  tickerPub.read(tl);
 
   // Interpolate progress to current time
-  if (active && playing && pollTime > 0) {
-    int interp = progress + (int)(millis() - pollTime);
-    progress = (interp < duration) ? interp : duration;
+  int progress = pb.progress;
+  if (pb.active && pb.playing && pb.pollTime > 0) {
+    int interp = progress + (int)(millis() - pb.pollTime);
+    progress = (interp < pb.duration) ? interp : pb.duration;
   }
 
   JsonDocument doc;
-  doc["active"]  = active;
-  doc["playing"] = playing;
-  if (active) {
-    doc["track"]    = track;
-    doc["artist"]   = artist;
-    doc["album"]    = album;
-    doc["device"]   = device;
-    doc["img"]      = imgUrl;
+  doc["active"]  = pb.active;
+  doc["playing"] = pb.playing;
+  if (pb.active) {
+    doc["track"]    = (const char*)pb.track;
+    doc["artist"]   = (const char*)pb.artist;
+    doc["album"]    = (const char*)pb.album;
+    doc["device"]   = (const char*)pb.device;
+    doc["img"]      = (const char*)pb.imgUrl;
     doc["progress"] = progress;
-    doc["duration"] = duration;
+    doc["duration"] = pb.duration;
   }
 
   JsonArray tArr = doc["tickers"].to<JsonArray>();
-  for (int i = 0; i < numTickers; i++) {
-    if (!tickerItems[i].valid) continue;
+  for (int i = 0; i < tl.count; i++) {
+    if (!tl.items[i].valid) continue;
     JsonObject t = tArr.add<JsonObject>();
-    t["s"] = (const char*)tickerItems[i].symbol;
-    t["p"] = tickerItems[i].price;
-    t["c"] = tickerItems[i].change;
+    t["s"] = (const char*)tl.items[i].symbol;
+    t["p"] = tl.items[i].price;
+    t["c"] = tl.items[i].change;
   }
 
   String out;
@@ -291,11 +316,13 @@ void startConfigServer() {
     httpd_uri_t p3 = { .uri = "/api/tickers",  .method = HTTP_POST, .handler = api_post_tickers_handler };
     httpd_uri_t p4 = { .uri = "/now",          .method = HTTP_GET,  .handler = now_page_handler };
     httpd_uri_t p5 = { .uri = "/api/state",    .method = HTTP_GET,  .handler = api_state_handler };
+    httpd_uri_t p6 = { .uri = "/api/control",  .method = HTTP_POST, .handler = api_control_handler };
     httpd_register_uri_handler(configServer, &p1);
     httpd_register_uri_handler(configServer, &p2);
     httpd_register_uri_handler(configServer, &p3);
     httpd_register_uri_handler(configServer, &p4);
     httpd_register_uri_handler(configServer, &p5);
+    httpd_register_uri_handler(configServer, &p6);
     LOG("[Config] Web UI: http://%s\n", WiFi.localIP().toString().c_str());
   }
 }
@@ -340,28 +367,32 @@ static esp_err_t oauth_root_handler(httpd_req_t* req) {
 
 // ── Exchange auth code for refresh token ────────────────
 static String exchangeCodeForToken(const String& code) {
-  WiFiClientSecure client;
-  client.setInsecure();
-
-  HTTPClient http;
-  http.begin(client, "https://accounts.spotify.com/api/token");
-  http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-  http.addHeader("Authorization", buildSpotifyBasicAuth());
+  PoolLease conn(SPOTIFY_ACCOUNTS_HOST, PRIO_SPOTIFY);
+  if (!conn) return "";
+  conn.closeOnRelease();   // one-off; the hourly refresh reconnects anyway
 
+  char auth[128];
+  buildSpotifyBasicAuth(auth, sizeof(auth));
   String body = "grant_type=authorization_code&code=" + code +
                 "&redirect_uri=" + oauthRedirectUri + "/callback";
 
-  int httpCode = http.POST(body);
+  HttpClient& http = conn->http;
+  http.begin("POST", SPOTIFY_ACCOUNTS_HOST, "/api/token", &netSpotify);
+  http.header("Content-Type", "application/x-www-form-urlencoded");
+  http.header("Authorization", auth);
+  int httpCode = http.send(body.c_str());
+  // User-initiated, so never refused; the outcome still counts
+  breakerReport(EP_SPOTIFY_ACCOUNTS, httpCode, http.retryAfter());
   String refreshToken = "";
 
   if (httpCode == 200) {
-    JsonDocument doc;
-    deserializeJson(doc, http.getString());
-    refreshToken = doc["refresh_token"] | "";
+    char rt[REFRESH_TOKEN_MAX];
+    JsonField fields[] = { jsonStr("refresh_token", rt, sizeof(rt)) };
+    jsonExtract(http.body(), fields, 1);
+    refreshToken = rt;
     LOG("[OAuth] Got refresh token: %s\n", refreshToken.c_str());
   } else {
     LOG("[OAuth] Token exchange failed: %d\n", httpCode);
-    LOGLN(http.getString());
   }
 
   http.end();
@@ -473,21 +504,194 @@ String runOAuthFlow() {
   return refreshToken;
 }
 
-// ── WiFi auto-reconnect ─────────────────────────────────
-void ensureWiFi() {
-  if (WiFi.status() == WL_CONNECTED) return;
-  LOGLN("[WiFi] reconnecting...");
-  WiFi.reconnect();
-  unsigned long t = millis();
-  while (WiFi.status() != WL_CONNECTED && millis() - t < 10000) {
-    delay(500);
+// ── WiFi link state machine ─────────────────────────────
+// Driver events arrive on the Arduino event task and only set flags;
+// core 0 picks them up in wifiService() and does the work (pool,
+// reconnect attempts) without ever waiting on the radio.
+static std::atomic<bool>          linkUp{false};
+static std::atomic<bool>          evDropped{false};
+static std::atomic<bool>          evGotIp{false};
+static std::atomic<uint8_t>       lastReason{0};
+static std::atomic<unsigned long> downSince{0};
+
+static WifiState     wifiState     = WIFI_UP;
+static uint8_t       retryLevel    = 0;
+static unsigned long nextAttemptAt = 0;
+static uint32_t      wifiDrops     = 0;
+static uint32_t      wifiAttempts  = 0;
+static unsigned long downTotalMs   = 0;
+static unsigned long lastOutageMs  = 0;
+static unsigned long bootIpMs      = 0;
+static bool          bootFast      = false;
+static bool          staticLease   = false;   // running on the cached lease
+
+static void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      lastReason = info.wifi_sta_disconnected.reason;
+      // Repeated while the AP stays unreachable; count the first only
+      if (linkUp.exchange(false)) {
+        downSince = millis();
+        evDropped = true;
+      }
+      break;
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      if (linkUp.exchange(false)) {
+        downSince = millis();
+        evDropped = true;
+      }
+      break;
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      linkUp  = true;
+      evGotIp = true;
+      break;
+    default:
+      break;
   }
+}
+
+// ── Fast reconnect (cached BSSID, channel and lease) ────
+// The last good association and DHCP lease, so a warm boot skips the
+// scan and the DHCP exchange. The SSID and password stay where
+// WiFiManager put them (the driver's own NVS config).
+struct WifiLease {
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint32_t ip, gateway, mask, dns;
+};
+
+// Undo the BSSID/channel lock so later (re)connects scan normally
+static void unlockStation() {
+  wifi_config_t conf;
+  if (esp_wifi_get_config(WIFI_IF_STA, &conf) != ESP_OK || !conf.sta.bssid_set) return;
+  conf.sta.bssid_set = false;
+  conf.sta.channel   = 0;
+  esp_wifi_set_config(WIFI_IF_STA, &conf);
+}
+
+bool wifiFastConnect() {
+  WifiLease l;
+  if (prefs.getBytes("wflease", &l, sizeof(l)) != sizeof(l)) return false;
+  wifi_config_t conf;
+  if (esp_wifi_get_config(WIFI_IF_STA, &conf) != ESP_OK || !conf.sta.ssid[0]) return false;
+  char ssid[33], pass[65];
+  memcpy(ssid, conf.sta.ssid, 32);
+  ssid[32] = 0;
+  memcpy(pass, conf.sta.password, 64);
+  pass[64] = 0;
+
+  unsigned long t0 = millis();
+  WiFi.config(IPAddress(l.ip), IPAddress(l.gateway), IPAddress(l.mask), IPAddress(l.dns));
+  WiFi.begin(ssid, pass, l.channel, l.bssid);
+  while (WiFi.status() != WL_CONNECTED && millis() - t0 < WIFI_FAST_TIMEOUT_MS) delay(10);
+  unlockStation();
   if (WiFi.status() == WL_CONNECTED) {
-    LOGLN("[WiFi] OK");
+    staticLease = true;
+    LOG("[WiFi] Directed connect on ch %u in %lums\n", l.channel, millis() - t0);
+    return true;
   }
+
+  // AP moved or lease gone: forget it and let WiFiManager scan + DHCP
+  LOGLN("[WiFi] Directed connect failed — falling back to scan");
+  prefs.remove("wflease");
+  WiFi.disconnect();
+  WiFi.config(IPAddress(), IPAddress(), IPAddress());
+  return false;
+}
+
+void wifiSaveLease() {
+  if (staticLease || WiFi.status() != WL_CONNECTED) return;   // only fresh DHCP leases
+  const uint8_t* b = WiFi.BSSID();
+  if (!b) return;
+  WifiLease l;
+  memset(&l, 0, sizeof(l));   // padding too: compared bytewise below
+  memcpy(l.bssid, b, sizeof(l.bssid));
+  l.channel = (uint8_t)WiFi.channel();
+  l.ip      = WiFi.localIP();
+  l.gateway = WiFi.gatewayIP();
+  l.mask    = WiFi.subnetMask();
+  l.dns     = WiFi.dnsIP(0);
+  // Spare the flash when nothing changed
+  WifiLease old;
+  if (prefs.getBytes("wflease", &old, sizeof(old)) == sizeof(old) &&
+      memcmp(&old, &l, sizeof(l)) == 0) return;
+  prefs.putBytes("wflease", &l, sizeof(l));
+  LOG("[WiFi] Lease cached (ch %u)\n", l.channel);
+}
+
+void wifiBegin() {
+  bootIpMs = millis();
+  bootFast = staticLease;
+  // Reconnects are ours (with backoff), not the driver's immediate retry
+  WiFi.setAutoReconnect(false);
+  linkUp = WiFi.status() == WL_CONNECTED;
+  if (!linkUp) downSince = millis();
+  wifiState = linkUp ? WIFI_UP : WIFI_DOWN;
+  WiFi.onEvent(onWifiEvent);
+}
+
+bool wifiUp() {
+  return linkUp;
+}
+
+bool wifiService() {
+  unsigned long ms = millis();
+
+  if (evDropped.exchange(false)) {
+    wifiDrops++;
+    wifiState     = WIFI_DOWN;
+    retryLevel    = 0;
+    nextAttemptAt = ms + WIFI_RETRY_MIN_MS;
+    LOG("[WiFi] Link down (reason %u)\n", lastReason.load());
+    // Every pooled socket belonged to the old link
+    poolInvalidate();
+    // The cached lease got us through boot; reconnects ask DHCP again
+    if (staticLease) {
+      WiFi.config(IPAddress(), IPAddress(), IPAddress());
+      staticLease = false;
+    }
+  }
+
+  if (evGotIp.exchange(false)) {
+    bool wasDown = wifiState != WIFI_UP;
+    wifiState = WIFI_UP;
+    if (wasDown) {
+      lastOutageMs = ms - downSince;
+      downTotalMs += lastOutageMs;
+      LOG("[WiFi] Link up after %lums (%s)\n", lastOutageMs,
+          WiFi.localIP().toString().c_str());
+      wifiSaveLease();
+      return true;
+    }
+    return false;
+  }
+
+  if (wifiState == WIFI_UP || (long)(ms - nextAttemptAt) < 0) return false;
+
+  // Non-blocking: the outcome arrives as GOT_IP or another DISCONNECTED.
+  // Equal-jitter backoff so a flapping AP isn't hammered.
+  unsigned long step = min(WIFI_RETRY_MIN_MS << min<uint8_t>(retryLevel, 8), WIFI_RETRY_MAX_MS);
+  nextAttemptAt = ms + step / 2 + esp_random() % (step / 2 + 1);
+  if (retryLevel < 8) retryLevel++;
+  wifiAttempts++;
+  wifiState = WIFI_CONNECTING;
+  LOG("[WiFi] Reconnect attempt %u\n", (unsigned)wifiAttempts);
+  WiFi.reconnect();
+  return false;
+}
+
+void wifiStats(WifiStats& out) {
+  out.state        = wifiState;
+  out.drops        = wifiDrops;
+  out.attempts     = wifiAttempts;
+  out.lastReason   = lastReason;
+  out.lastOutageMs = lastOutageMs;
+  out.downMs       = downTotalMs + (linkUp ? 0 : millis() - downSince);
+  out.bootIpMs     = bootIpMs;
+  out.bootFast     = bootFast;
 }
 
-// ── Serial input for ticker/key changes ─────────────────
+// ── Serial input: ticker/key changes, diagnostics ──────
 void checkSerialInput() {
   if (!Serial.available()) return;
   String line = Serial.readStringUntil('\n');
@@ -506,5 +710,8 @@ void checkSerialInput() {
     prefs.putString("stockkey", key);
     LOG("[Ticker] Stock API key saved (%d chars)\n", key.length());
     tickerListChanged = true;
+  } else if (line == "TLSBENCH") {
+    LOGLN("[TLS] Benchmark queued");
+    tlsBenchRequested = true;
   }
 }
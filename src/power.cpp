@@ -0,0 +1,129 @@
+// ============================================================
+//  Power: frequency scaling, automatic light sleep and Wi-Fi
+//  modem sleep while the screen is off or nothing is playing
+// ============================================================
+//  esp_pm scales the CPU between full speed and PWR_CPU_MIN_MHZ,
+//  and with FreeRTOS tickless idle it light-sleeps whenever both
+//  cores are blocked. At full power two PM locks pin the clock and
+//  keep light sleep off, so rendering is exactly as before. In low
+//  power the locks are released, Wi-Fi moves to max modem sleep
+//  (the radio wakes for the AP's DTIM beacons only), both loops
+//  pause longer between passes and idle polling slows down. Either
+//  button wakes the chip through a GPIO wake source.
+//
+//  Light sleep suspends the USB console, so it stays off while a
+//  host has the port open. An sdkconfig without tickless idle still
+//  gets frequency scaling; one without CONFIG_PM_ENABLE gets modem
+//  sleep and the slower cadences only.
+// ============================================================
+
+#include "config.h"
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_wifi.h>
+#include <driver/gpio.h>
+#include <atomic>
+
+namespace {
+
+esp_pm_lock_handle_t       cpuLock    = nullptr;   // ESP_PM_CPU_FREQ_MAX
+esp_pm_lock_handle_t       awakeLock  = nullptr;   // ESP_PM_NO_LIGHT_SLEEP
+bool                       awakeHeld  = false;
+bool                       usbAwake   = false;     // light sleep held off for the console
+PowerSupport               support    = PWR_MODEM_ONLY;
+std::atomic<bool>          low{false};
+std::atomic<unsigned long> activityAt{0};
+unsigned long              lowSince   = 0;
+unsigned long              lowTotalMs = 0;
+uint32_t                   lowEntries = 0;
+
+void holdAwake(bool hold) {
+  if (!awakeLock || hold == awakeHeld) return;
+  if (hold) esp_pm_lock_acquire(awakeLock);
+  else      esp_pm_lock_release(awakeLock);
+  awakeHeld = hold;
+}
+
+void setLow(bool on) {
+  unsigned long ms = millis();
+  low = on;
+  if (on) {
+    lowSince = ms;
+    lowEntries++;
+    esp_wifi_set_ps(WIFI_PS_MAX_MODEM);
+    usbAwake = (bool)Serial;
+    holdAwake(usbAwake);
+    if (cpuLock) esp_pm_lock_release(cpuLock);
+  } else {
+    lowTotalMs += ms - lowSince;
+    if (cpuLock) esp_pm_lock_acquire(cpuLock);
+    holdAwake(true);
+    esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
+  }
+  LOG("[Power] %s\n", on ? "Low power" : "Full power");
+}
+
+}  // namespace
+
+void powerBegin() {
+  // Both locks are taken before PM is switched on, so nothing changes
+  // until low power is entered
+  if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "full", &cpuLock) != ESP_OK ||
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "awake", &awakeLock) != ESP_OK) {
+    cpuLock = awakeLock = nullptr;
+  } else {
+    esp_pm_lock_acquire(cpuLock);
+    esp_pm_lock_acquire(awakeLock);
+    awakeHeld = true;
+
+    esp_pm_config_esp32s3_t cfg = { (int)getCpuFrequencyMhz(), PWR_CPU_MIN_MHZ, true };
+    if (esp_pm_configure(&cfg) == ESP_OK) {
+      support = PWR_LIGHT_SLEEP;
+    } else {
+      cfg.light_sleep_enable = false;   // no tickless idle in this build
+      if (esp_pm_configure(&cfg) == ESP_OK) support = PWR_DFS;
+    }
+  }
+
+  // The panel's power rail and backlight keep their level through sleep
+  gpio_sleep_sel_dis((gpio_num_t)PWR_EN);
+  gpio_sleep_sel_dis((gpio_num_t)BL_PIN);
+  // Buttons are active low; either one wakes the chip
+  gpio_wakeup_enable((gpio_num_t)BTN_TOP, GPIO_INTR_LOW_LEVEL);
+  gpio_wakeup_enable((gpio_num_t)BTN_BOTTOM, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+
+  activityAt = millis();
+  static const char* NAMES[] = { "modem sleep only", "DFS", "DFS + light sleep" };
+  LOG("[Power] %s\n", NAMES[support]);
+}
+
+void powerUpdate(bool screenOn, bool playing) {
+  unsigned long ms = millis();
+  if (playing) activityAt = ms;
+  bool want = !screenOn || ms - activityAt >= PWR_IDLE_MS;
+  if (want != low) setLow(want);
+
+  // A console opened or closed while in low power
+  if (low && (bool)Serial != usbAwake) {
+    usbAwake = !usbAwake;
+    holdAwake(usbAwake);
+  }
+}
+
+void powerNoteActivity() {
+  activityAt = millis();
+}
+
+bool powerLow() {
+  return low;
+}
+
+void powerStats(PowerStats& out) {
+  out.support  = support;
+  out.low      = low;
+  out.usbAwake = low && usbAwake;
+  out.cpuMhz   = getCpuFrequencyMhz();
+  out.entries  = lowEntries;
+  out.lowMs    = lowTotalMs + (low ? millis() - lowSince : 0);
+}
@@ -0,0 +1,101 @@
+// ============================================================
+//  Radio duty cycle: traffic accounting and batching of
+//  deferrable network work
+// ============================================================
+//  Every TLS record sent or received, TCP connect and DNS query
+//  touches the radio clock. Touches closer than RADIO_TAIL_MS
+//  apart are one burst ("wake"); a burst counts as active until
+//  RADIO_TAIL_MS after its last packet. Bursts are binned by the
+//  minute they started, so the last hour is always a rolling sum.
+//
+//  Deferrable jobs (price refresh, token rotation, NTP, DNS
+//  pre-resolution) ask batchRun() instead of firing on their own
+//  timer. Once due, they run while the radio is awake from other
+//  traffic anyway (within BATCH_WINDOW_MS of it), normally a
+//  Spotify poll, and only start a wake of their own once they have
+//  waited out their slack.
+// ============================================================
+
+#include "config.h"
+
+namespace {
+
+const char* const JOB_NAMES[JOB_COUNT] = { "tickers", "token", "ntp", "dns" };
+
+unsigned long     burstStart = 0;
+unsigned long     lastTouch  = 0;
+bool              inBurst    = false;
+uint32_t          minuteMs[60];      // active time of bursts started in that minute
+uint16_t          minuteWakes[60];
+uint32_t          minuteId[60];
+uint32_t          batched    = 0;
+uint32_t          alone      = 0;
+StaticSemaphore_t radioLockBuf;
+SemaphoreHandle_t radioLock = xSemaphoreCreateMutexStatic(&radioLockBuf);
+
+struct RadioGuard {
+  RadioGuard()  { xSemaphoreTake(radioLock, portMAX_DELAY); }
+  ~RadioGuard() { xSemaphoreGive(radioLock); }
+};
+
+// Credit a finished burst to the minute it started in
+void closeBurst() {
+  uint32_t minute = burstStart / 60000;
+  int      slot   = minute % 60;
+  if (minuteId[slot] != minute) {
+    minuteId[slot]    = minute;
+    minuteMs[slot]    = 0;
+    minuteWakes[slot] = 0;
+  }
+  minuteMs[slot] += lastTouch + RADIO_TAIL_MS - burstStart;
+  minuteWakes[slot]++;
+  inBurst = false;
+}
+
+}  // namespace
+
+void radioTouch() {
+  RadioGuard g;
+  unsigned long ms = millis();
+  if (inBurst && ms - lastTouch > RADIO_TAIL_MS) closeBurst();
+  if (!inBurst) {
+    inBurst    = true;
+    burstStart = ms;
+  }
+  lastTouch = ms;
+}
+
+bool radioAwake() {
+  RadioGuard g;
+  return inBurst && millis() - lastTouch < BATCH_WINDOW_MS;
+}
+
+bool batchRun(BatchJob job, long overdueMs, unsigned long slackMs) {
+  if (overdueMs < 0) return false;
+  if (radioAwake()) {
+    batched++;
+    return true;
+  }
+  if (overdueMs < (long)slackMs) return false;
+  alone++;
+  LOG("[Radio] %s waited %lds for a window, waking the radio\n", JOB_NAMES[job],
+      overdueMs / 1000);
+  return true;
+}
+
+void radioStats(RadioStats& out) {
+  RadioGuard g;
+  unsigned long ms = millis();
+  if (inBurst && ms - lastTouch > RADIO_TAIL_MS) closeBurst();
+  uint32_t minute = ms / 60000;
+  out.activeMsHour = 0;
+  out.wakesHour    = 0;
+  for (int i = 0; i < 60; i++) {
+    if (minute - minuteId[i] >= 60) continue;
+    out.activeMsHour += minuteMs[i];
+    out.wakesHour    += minuteWakes[i];
+  }
+  if (inBurst) out.activeMsHour += ms - burstStart;   // the one still going
+  out.batched = batched;
+  out.alone   = alone;
+}
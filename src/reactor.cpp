@@ -0,0 +1,506 @@
+// ============================================================
+//  Transfer reactor (see reactor.h)
+// ============================================================
+
+#include "config.h"
+#include <lwip/sockets.h>
+
+namespace {
+
+// CONNECT: waiting for a connection, or for it to be ready to write.
+// WAIT: request written, head not in yet. BODY: reading the body.
+enum Phase : uint8_t { FREE, CONNECT, WAIT, BODY };
+
+struct Transfer {
+  Phase         phase;
+  FetchReq      req;
+  char          host[TLS_HOST_MAX];
+  PoolConn*     conn;
+  bool          lease;       // holds a pool lease on conn (else rides another transfer's)
+  int8_t        stream;      // HTTP/2 stream once written, -1 on HTTP/1.1
+  bool          reused;      // conn was already open when this transfer took it
+  bool          retried;
+  bool          zombie;      // reported late; dropped when its turn comes
+  uint32_t      seq;         // start order; send order once written
+  FetchDone     done;
+  void*         ctx;
+  unsigned long startAt;
+  unsigned long deadline;
+  int           code;
+  uint32_t      retryAfter;
+  uint8_t*      buf;
+  size_t        cap;
+  size_t        got;
+};
+
+// Transfers belong to the task that runs the reactor; only the
+// stats are read from elsewhere (the TUI on core 1)
+Transfer          xfers[REACTOR_SLOTS];
+uint32_t          seqNext = 0;
+bool              kick    = false;   // something to do before the next select()
+ReactorStats      stats;
+StaticSemaphore_t reactorLockBuf;
+SemaphoreHandle_t reactorLock = xSemaphoreCreateMutexStatic(&reactorLockBuf);
+
+struct ReactorGuard {
+  ReactorGuard()  { xSemaphoreTake(reactorLock, portMAX_DELAY); }
+  ~ReactorGuard() { xSemaphoreGive(reactorLock); }
+};
+
+bool live(const Transfer& t) { return t.phase != FREE; }
+bool sent(const Transfer& t) { return t.phase == WAIT || t.phase == BODY; }
+
+// Responses on an HTTP/1.1 connection are read in the order the
+// requests went out; on HTTP/2, whichever head is in, one body at a time
+bool myTurn(const Transfer& t) {
+  for (const Transfer& x : xfers) {
+    if (&x == &t || !sent(x) || x.conn != t.conn) continue;
+    if (t.stream >= 0 ? x.phase == BODY : x.seq < t.seq) return false;
+  }
+  return true;
+}
+
+// Live transfers, oldest first
+int bySeq(Transfer** out) {
+  int n = 0;
+  for (Transfer& t : xfers) {
+    if (!live(t)) continue;
+    int i = n++;
+    while (i > 0 && out[i - 1]->seq > t.seq) {
+      out[i] = out[i - 1];
+      i--;
+    }
+    out[i] = &t;
+  }
+  return n;
+}
+
+// Prefer PSRAM (8MB on T-Display S3) so a body doesn't fight the
+// internal heap for TJpgDec work buffers and TLS. Falls back to
+// internal heap if PSRAM is absent or exhausted.
+uint8_t* allocBody(uint8_t* old, size_t len) {
+  uint8_t* buf = (uint8_t*)ps_realloc(old, len);
+  if (buf) return buf;
+  unsigned heap = ESP.getFreeHeap();
+  if (len + REACTOR_HEAP_KEEP > heap) {
+    LOG("[Fetch] Skipping — need %u+%u, heap %u, psram %u\n", (unsigned)len,
+        (unsigned)REACTOR_HEAP_KEEP, heap, (unsigned)ESP.getFreePsram());
+    return nullptr;
+  }
+  return (uint8_t*)realloc(old, len);
+}
+
+// Room for `n` more bytes: a body of unknown length (or a decoded
+// gzip one) doubles its buffer as it grows
+bool grow(Transfer& t, size_t n) {
+  size_t want = max(max(t.cap * 2, t.got + n), (size_t)REACTOR_BODY_CHUNK);
+  if (want > REACTOR_BODY_MAX) want = REACTOR_BODY_MAX;
+  if (want <= t.got) return false;
+  uint8_t* buf = allocBody(t.buf, want);
+  if (!buf) return false;
+  t.buf = buf;
+  t.cap = want;
+  return true;
+}
+
+// Let go of t's connection. While another transfer holds a lease on
+// it (a shared HTTP/2 session) this one is simply returned; otherwise
+// it passes to a transfer riding on it, and the last one out hands it
+// back to the pool.
+void detach(Transfer& t) {
+  PoolConn* c = t.conn;
+  t.conn = nullptr;
+  if (!c || !t.lease) return;
+  t.lease = false;
+  Transfer* heir = nullptr;
+  for (Transfer& x : xfers) {
+    if (!live(x) || x.conn != c) continue;
+    if (x.lease) {
+      heir = nullptr;
+      break;
+    }
+    if (!heir) heir = &x;
+  }
+  if (heir) {
+    heir->lease = true;
+    return;
+  }
+  // A handshake nobody waits for any more is abandoned
+  poolRelease(c, !(t.req.flags & FETCH_CLOSE) && !c->client.connecting());
+}
+
+// Hand the outcome over. The slot may still be taken (a late transfer
+// waiting for its turn), so `done` is cleared rather than the phase.
+void report(Transfer& t, int code, uint8_t* body, size_t len) {
+  FetchDone done = t.done;
+  if (!done) {
+    free(body);
+    return;
+  }
+  t.done = nullptr;
+  breakerReport(t.req.ep, code, code > 0 ? t.retryAfter : 0);
+
+  uint32_t ms = millis() - t.startAt;
+  LOG("[Fetch] %s: %d, %u bytes in %lums\n", t.host, code, (unsigned)len, (unsigned long)ms);
+  {
+    ReactorGuard g;
+    if (code > 0) {
+      stats.done++;
+      stats.lastMs    = ms;
+      stats.lastBytes = len;
+    } else {
+      stats.failed++;
+    }
+  }
+  kick = true;
+  done(code, body, len, t.ctx);
+}
+
+void finish(Transfer& t, int code, bool withBody = false);
+
+// Send t once more, on a new connection
+void resend(Transfer& t) {
+  LOG("[Fetch] %s: connection lost before the answer, sending again\n", t.host);
+  detach(t);
+  t.phase   = CONNECT;
+  t.retried = true;
+  t.reused  = false;
+  t.stream  = -1;
+  kick      = true;
+  ReactorGuard g;
+  stats.retries++;
+}
+
+// A connection that went down takes the requests still queued on it.
+// None of them got its turn, so each goes again; one already reported
+// late ends here.
+void orphan(PoolConn* c) {
+  if (c->client.connected() || c->client.connecting()) return;
+  for (Transfer& x : xfers) {
+    if (!sent(x) || x.conn != c) continue;
+    if (x.zombie) finish(x, HTTP_ERR_READ);
+    else          resend(x);
+  }
+}
+
+void finish(Transfer& t, int code, bool withBody) {
+  uint8_t* body = withBody && t.got ? t.buf : nullptr;
+  size_t   len  = body ? t.got : 0;
+  if (!body) free(t.buf);
+  t.buf = nullptr;
+  PoolConn* c = t.conn;
+  detach(t);
+  t.phase = FREE;
+  if (c) orphan(c);
+  report(t, code, body, len);
+}
+
+// Another request may go out on `c`: room in its pipeline or for
+// another stream, and no HTTP/1.1 body being read (begin() would
+// finish it first)
+bool joinable(const PoolConn* c) {
+  int users = 0;
+  for (const Transfer& x : xfers) {
+    if (!live(x) || x.conn != c) continue;
+    if (x.phase == BODY && !c->client.h2()) return false;
+    users++;
+  }
+  return users < (c->client.h2() ? H2_STREAMS : HTTP_PIPELINE_MAX);
+}
+
+// A connection for t: the one of the latest transfer to the same host
+// (FETCH_PIPELINE), else a lease from the pool. False if it has none.
+bool attach(Transfer& t) {
+  Transfer* ride = nullptr;
+  if (t.req.flags & FETCH_PIPELINE) {
+    for (Transfer& x : xfers) {
+      if (&x == &t || !live(x) || !x.conn || strcmp(x.host, t.host)) continue;
+      if (joinable(x.conn) && (!ride || x.seq > ride->seq)) ride = &x;
+    }
+  }
+  if (ride) {
+    t.conn  = ride->conn;
+    t.lease = false;
+  } else {
+    t.conn  = poolAcquire(t.host, t.req.prio, !(t.req.flags & FETCH_NO_EVICT), true);
+    t.lease = t.conn != nullptr;
+  }
+  if (!t.conn) return false;
+  t.reused = t.conn->client.connected();
+  return true;
+}
+
+// Everything waiting for `c` to connect fails with it
+void connectFailed(PoolConn* c) {
+  for (Transfer& x : xfers) {
+    if (x.phase == CONNECT && x.conn == c) finish(x, HTTP_ERR_CONNECT);
+  }
+}
+
+void send(Transfer& t) {
+  HttpClient& http = t.conn->http;
+  http.begin(t.req.method ? t.req.method : "GET", t.host, t.req.path, t.req.stats);
+  if (t.req.headers) t.req.headers(http, t.ctx);
+  http.setTimeout(max((long)(t.deadline - millis()), 1L));
+  const char* body = t.req.body;
+  int code = http.write((const uint8_t*)body, body ? strlen(body) : 0);
+  if (code) {
+    finish(t, code);
+    return;
+  }
+  t.seq    = ++seqNext;
+  t.stream = http.stream();
+  t.phase  = WAIT;
+}
+
+// Connect as far as the socket allows, then write the request
+void stepConnect(Transfer& t) {
+  if (!t.conn && !attach(t)) {
+    finish(t, HTTP_ERR_CONNECT);
+    return;
+  }
+  PoolConn* c = t.conn;
+  if (!c->http.connected()) {
+    // Requests still out on the old socket go again on their own
+    if (!c->client.connecting()) orphan(c);
+    TlsStep step = TLS_STEP_FAILED;
+    if (c->client.connecting())                  step = c->client.connectStep();
+    else if (c->client.connectStart(t.host, 443)) step = TLS_STEP_PENDING;
+    if (step == TLS_STEP_FAILED) connectFailed(c);
+    if (step != TLS_STEP_DONE) return;
+  }
+  if (!t.req.path) {
+    finish(t, 0);   // a prewarm: the session is all it wanted
+    return;
+  }
+  send(t);
+}
+
+// A body that won't fit is not kept; the status still goes out
+void tooBig(Transfer& t) {
+  LOG("[Fetch] %s: body over %u bytes, dropped\n", t.host, (unsigned)t.cap);
+  t.conn->http.abort();
+  finish(t, t.code);
+}
+
+// Take whatever body bytes have arrived
+void stepBody(Transfer& t) {
+  HttpClient& http = t.conn->http;
+  Stream&     body = http.body();
+  bool        moved = false;
+  for (;;) {
+    int avail = body.available();
+    if (avail <= 0) break;
+    if (t.got == t.cap && !grow(t, avail)) {
+      tooBig(t);
+      return;
+    }
+    t.got += body.readBytes((char*)t.buf + t.got, min((size_t)avail, t.cap - t.got));
+    moved = true;
+  }
+  if (http.bodyDone()) {
+    http.end();
+    finish(t, t.code, true);
+  } else if (!moved && http.bodyCut()) {
+    http.abort();
+    finish(t, HTTP_ERR_READ);
+  }
+}
+
+// The head arrives a line at a time, over as many passes as it takes
+void stepHead(Transfer& t) {
+  HttpClient& http = t.conn->http;
+  // On HTTP/2 this response goes next, whatever was written before it
+  if (t.stream >= 0 && !http.next(t.stream)) return;
+  if (t.zombie) {
+    http.abort();
+    finish(t, HTTP_ERR_READ);
+    return;
+  }
+  int code = http.pollHead();
+  if (!code) return;
+  if (code < 0) {
+    // A keep-alive socket the server closed while idle fails before a
+    // single response byte; write the request once more on a new one
+    if (t.reused && !t.retried && !http.answered()) {
+      PoolConn* c = t.conn;
+      resend(t);
+      orphan(c);
+    } else {
+      finish(t, code);
+    }
+    return;
+  }
+
+  t.code       = code;
+  t.retryAfter = http.retryAfter();
+  t.phase      = BODY;
+  // The announced length up front; a gzip body grows past it decoded
+  long len = http.contentLength();
+  if (len > REACTOR_BODY_MAX) {
+    t.cap = len;
+    tooBig(t);
+    return;
+  }
+  if (len > 0) {
+    t.buf = allocBody(nullptr, len);
+    t.cap = t.buf ? len : 0;
+    if (!t.buf) {
+      tooBig(t);
+      return;
+    }
+  }
+  stepBody(t);
+}
+
+// Past the deadline. The response being read is given up; one still
+// queued behind it is reported now and dropped at its turn.
+void expire(Transfer& t) {
+  LOG("[Fetch] %s: deadline\n", t.host);
+  {
+    ReactorGuard g;
+    stats.late++;
+  }
+  if (t.phase == CONNECT) {
+    finish(t, HTTP_ERR_CONNECT);
+  } else if (myTurn(t) && (t.stream < 0 || t.phase == BODY || t.conn->http.next(t.stream))) {
+    t.conn->http.abort();
+    finish(t, HTTP_ERR_READ);
+  } else {
+    report(t, HTTP_ERR_READ, nullptr, 0);
+    t.zombie = true;
+  }
+}
+
+// A free slot; nullptr (logged) if all are taken
+Transfer* freeSlot(const char* host) {
+  for (Transfer& x : xfers) {
+    if (!live(x)) return &x;
+  }
+  LOG("[Fetch] No transfer slot for %s\n", host);
+  return nullptr;
+}
+
+bool launch(Transfer& t, const FetchReq& req, FetchDone done, void* ctx) {
+  t = Transfer{};
+  t.req = req;
+  strlcpy(t.host, req.host, sizeof(t.host));
+  t.done     = done;
+  t.ctx      = ctx;
+  t.startAt  = millis();
+  t.deadline = t.startAt + req.deadlineMs;
+  t.seq      = ++seqNext;
+  t.stream   = -1;
+  if (!attach(t)) {
+    LOG("[Fetch] No connection slot for %s\n", req.host);
+    return false;
+  }
+  // Connecting and writing happen in reactorRun(), right away
+  t.phase = CONNECT;
+  kick    = true;
+  return true;
+}
+
+}  // namespace
+
+bool fetchRequest(const FetchReq& req, FetchDone done, void* ctx) {
+  Transfer* t = freeSlot(req.host);
+  if (!t) return false;
+  if (!breakerAllow(req.ep)) {
+    LOG("[Fetch] %s backing off\n", req.host);
+    return false;
+  }
+  return launch(*t, req, done, ctx);
+}
+
+bool fetchPrewarm(const char* host, ConnPriority prio) {
+  Transfer* t = freeSlot(host);
+  if (!t) return false;
+  FetchReq req = { host, nullptr, nullptr, nullptr, prio, EP_COUNT, nullptr,
+                   TLS_CONNECT_TIMEOUT_MS, FETCH_NO_EVICT, nullptr };
+  return launch(*t, req, nullptr, nullptr);
+}
+
+bool fetchStart(const char* url, ConnPriority prio, Endpoint ep, NetStats* netStats,
+                uint32_t deadlineMs, FetchDone done, void* ctx) {
+  char host[TLS_HOST_MAX];
+  urlHost(url, host, sizeof(host));
+  FetchReq req = { host, urlPath(url), nullptr, nullptr, prio, ep, netStats, deadlineMs,
+                   0, nullptr };
+  return fetchRequest(req, done, ctx);
+}
+
+bool fetchBusy() {
+  for (const Transfer& t : xfers) {
+    if (live(t)) return true;
+  }
+  return false;
+}
+
+void reactorRun(uint32_t waitMs) {
+  // Bytes already decrypted don't show up in select(), and neither
+  // does a transfer with nothing to wait for
+  fd_set rd, wr;
+  FD_ZERO(&rd);
+  FD_ZERO(&wr);
+  int  maxFd = -1;
+  bool now   = kick;
+  kick = false;
+  for (Transfer& t : xfers) {
+    if (!live(t)) continue;
+    if (!t.conn) {
+      now = true;
+      continue;
+    }
+    TlsClient& c  = t.conn->client;
+    int        fd = c.fd();
+    if (fd < 0 || c.buffered() || (t.phase == CONNECT && !c.connecting())) now = true;
+    if (fd < 0) continue;
+    FD_SET(fd, c.connecting() && c.wantWrite() ? &wr : &rd);
+    maxFd = max(maxFd, fd);
+  }
+  if (maxFd < 0 && !now) return;
+
+  int woke = 0;
+  if (maxFd >= 0) {
+    uint32_t ms = now ? 0 : min(waitMs, (uint32_t)REACTOR_SLICE_MS);
+    struct timeval tv = { 0, (suseconds_t)(ms * 1000) };
+    woke = lwip_select(maxFd + 1, &rd, &wr, nullptr, &tv);
+  }
+  if (woke > 0 || now) {
+    ReactorGuard g;
+    stats.steps++;
+  }
+
+  // Every transfer is stepped; each step only takes what is there.
+  // Connections first, oldest request first, then responses in the
+  // order their requests went out.
+  Transfer* order[REACTOR_SLOTS];
+  int n = bySeq(order);
+  for (int i = 0; i < n; i++) {
+    if (order[i]->phase == CONNECT) stepConnect(*order[i]);
+  }
+  n = bySeq(order);
+  for (int i = 0; i < n; i++) {
+    Transfer& t = *order[i];
+    if (!sent(t) || !myTurn(t)) continue;
+    if (t.phase == WAIT) stepHead(t);
+    else                 stepBody(t);
+  }
+  n = bySeq(order);
+  unsigned long ms = millis();
+  for (int i = 0; i < n; i++) {
+    Transfer& t = *order[i];
+    if (live(t) && !t.zombie && (long)(ms - t.deadline) >= 0) expire(t);
+  }
+}
+
+void reactorStats(ReactorStats& out) {
+  uint8_t live = 0;
+  for (const Transfer& t : xfers) {
+    if (t.phase != FREE) live++;
+  }
+  ReactorGuard g;
+  out      = stats;
+  out.live = live;
+}
@@ -0,0 +1,197 @@
+// ============================================================
+//  Background scheduler: prioritised jobs with deadlines and
+//  time budgets on core 0
+// ============================================================
+//  The background task's work is a fixed set of jobs, each in a
+//  class: user action > poll > art prefetch > tickers >
+//  housekeeping. Every pass asks each job how long until it is due;
+//  once due it stays queued, with the time it became due, until it
+//  runs. The next job is the highest class queued, unless a queued
+//  job has waited past its class deadline: then the deadline that
+//  passed first goes. The queue is looked at again after every
+//  job, so a press that lands during a poll goes next.
+//
+//  Jobs run to completion on the one task; each class has a time
+//  budget instead. Network jobs only start reactor transfers and give
+//  them schedBudget() as their deadline, and a job can check
+//  schedPreempted() before its slow part and return false to stay
+//  queued behind a higher class.
+//  It only says so if that class would run next: a job that is
+//  itself the most overdue keeps its turn, so it can't yield forever.
+//  Between passes the task sleeps until the next known due time,
+//  and schedWake() (a queued press) cuts the sleep short.
+// ============================================================
+
+#include "config.h"
+#include <assert.h>
+
+namespace {
+
+struct Job {
+  const char*   name;
+  JobClass      cls;
+  JobDue        due;
+  JobRun        run;
+  bool          queued;
+  unsigned long readyAt;     // when it became due
+  unsigned long checkedAt;   // last time due() said "not yet"
+};
+
+struct ClassSpec {
+  const char* name;
+  uint32_t    deadlineMs;    // queueing delay before it counts as late
+  uint32_t    budgetMs;      // run time it may take
+};
+
+const ClassSpec SPECS[JC_COUNT] = {
+  { "action",  JOB_ACTION_DEADLINE_MS, JOB_ACTION_BUDGET_MS },
+  { "poll",    JOB_POLL_DEADLINE_MS,   JOB_POLL_BUDGET_MS },
+  { "art",     JOB_ART_DEADLINE_MS,    JOB_ART_BUDGET_MS },
+  { "tickers", JOB_TICKER_DEADLINE_MS, JOB_TICKER_BUDGET_MS },
+  { "house",   JOB_HOUSE_DEADLINE_MS,  JOB_HOUSE_BUDGET_MS },
+};
+
+Job               jobs[SCHED_MAX_JOBS];
+int               jobCount  = 0;
+Job*              running   = nullptr;
+unsigned long     runStart  = 0;
+TaskHandle_t      owner     = nullptr;
+JobStats          stats[JC_COUNT];
+StaticSemaphore_t schedLockBuf;
+SemaphoreHandle_t schedLock = xSemaphoreCreateMutexStatic(&schedLockBuf);
+
+// Only the stats are shared (the TUI reads them from core 1)
+struct SchedGuard {
+  SchedGuard()  { xSemaphoreTake(schedLock, portMAX_DELAY); }
+  ~SchedGuard() { xSemaphoreGive(schedLock); }
+};
+
+// Ask an idle job whether it is due; returns ms until it is (0 if queued)
+long check(Job& j, unsigned long ms) {
+  if (j.queued) return 0;
+  long in = j.due();
+  if (in > 0) {
+    j.checkedAt = ms;
+    return in;
+  }
+  // Overdue by -in, but it can't have been due before the last "not yet"
+  unsigned long at = ms + in;
+  j.readyAt = (long)(at - j.checkedAt) > 0 ? at : j.checkedAt;
+  j.queued  = true;
+  return 0;
+}
+
+unsigned long deadlineOf(const Job& j) {
+  return j.readyAt + SPECS[j.cls].deadlineMs;
+}
+
+// Highest class queued; a job past its deadline goes first, earliest
+// deadline among those
+Job* pick(unsigned long ms) {
+  Job* best = nullptr;
+  Job* late = nullptr;
+  for (int i = 0; i < jobCount; i++) {
+    Job& j = jobs[i];
+    if (!j.queued) continue;
+    if ((long)(ms - deadlineOf(j)) > 0 &&
+        (!late || (long)(deadlineOf(j) - deadlineOf(*late)) < 0)) late = &j;
+    if (!best || j.cls < best->cls ||
+        (j.cls == best->cls && (long)(j.readyAt - best->readyAt) < 0)) best = &j;
+  }
+  return late ? late : best;
+}
+
+void record(const Job& j, unsigned long startAt, bool done) {
+  uint32_t   waitMs = startAt - j.readyAt;
+  uint32_t   runMs  = millis() - startAt;
+  SchedGuard g;
+  JobStats&  s = stats[j.cls];
+  if (!done) {
+    s.yielded++;
+    return;
+  }
+  s.lastWaitMs = waitMs;
+  s.avgWaitMs  = s.runs ? (s.avgWaitMs * 7 + waitMs) / 8 : waitMs;   // EWMA, 1/8
+  s.maxWaitMs  = max(s.maxWaitMs, waitMs);
+  if (waitMs > SPECS[j.cls].deadlineMs) s.late++;
+  if (runMs > SPECS[j.cls].budgetMs) {
+    s.over++;
+    LOG("[Sched] %s ran %lums (budget %lums)\n", j.name, (unsigned long)runMs,
+        (unsigned long)SPECS[j.cls].budgetMs);
+  }
+  s.runs++;
+}
+
+}  // namespace
+
+void schedBegin() {
+  owner = xTaskGetCurrentTaskHandle();
+}
+
+void schedAdd(JobClass cls, const char* name, JobDue due, JobRun run) {
+  // A job left out would simply never run; stop at boot instead
+  if (jobCount >= SCHED_MAX_JOBS) {
+    LOG("[Sched] No room for job \"%s\" - raise SCHED_MAX_JOBS\n", name);
+    assert(jobCount < SCHED_MAX_JOBS);
+    return;
+  }
+  jobs[jobCount++] = { name, cls, due, run, false, 0, millis() };
+}
+
+unsigned long schedPass() {
+  unsigned long ms = millis();
+  // A job that keeps yielding can't spin the pass
+  for (int n = 0; n < 2 * jobCount; n++) {
+    for (int i = 0; i < jobCount; i++) check(jobs[i], ms);
+    Job* j = pick(ms);
+    if (!j) break;
+    running  = j;
+    runStart = millis();
+    bool done = j->run();
+    running  = nullptr;
+    if (done) j->queued = false;
+    record(*j, runStart, done);
+    ms = millis();
+  }
+
+  // Sleep until the earliest known due time
+  unsigned long next = ULONG_MAX;
+  for (int i = 0; i < jobCount; i++) {
+    long in = check(jobs[i], ms);
+    next = min(next, (unsigned long)max(in, 0L));
+  }
+  return next;
+}
+
+void schedWait(unsigned long ms) {
+  if (ms) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+}
+
+void schedWake() {
+  if (owner) xTaskNotifyGive(owner);
+}
+
+uint32_t schedBudget() {
+  if (!running) return HTTP_TIMEOUT_MS;
+  long left = (long)SPECS[running->cls].budgetMs - (long)(millis() - runStart);
+  return (uint32_t)constrain(left, (long)JOB_BUDGET_MIN_MS, (long)HTTP_TIMEOUT_MS);
+}
+
+// The running job is still queued: would the next pick be a higher
+// class instead of it?
+bool schedPreempted() {
+  if (!running) return false;
+  unsigned long ms = millis();
+  for (int i = 0; i < jobCount; i++) check(jobs[i], ms);
+  Job* next = pick(ms);
+  return next && next != running && next->cls < running->cls;
+}
+
+const char* schedClassName(JobClass c) {
+  return SPECS[c].name;
+}
+
+void schedStats(JobClass c, JobStats& out) {
+  SchedGuard g;
+  out = stats[c];
+}
@@ -1,17 +1,96 @@
 // ============================================================
 //  Ticker: price fetching (core 0) and rendering (core 1)
 // ============================================================
+//  Prices come through the transfer reactor on the background task.
+//  tickerRefresh() starts both providers' requests and returns:
+//  CoinGecko is one batch request, Finnhub one request per quote,
+//  pipelined on a shared keep-alive connection. A slow Finnhub batch
+//  holds up neither CoinGecko nor the next Spotify poll. Each
+//  provider's prices are applied and published when its last answer
+//  lands — unless the list was reloaded in the meantime.
+// ============================================================
 
 #include "config.h"
 
-// ── Persistent TLS clients (keep-alive across fetches) ──
-static WiFiClientSecure cgClient;
-static HTTPClient       cgHttp;
-static bool             cgInit = false;
+namespace {
+
+const char* const PROVIDER_NAMES[TP_COUNT] = { "coingecko", "finnhub" };
+
+uint32_t          listGen = 0;           // bumped by loadTickers()
+TickerStats       stats[TP_COUNT] = {};
+StaticSemaphore_t tickerLockBuf;
+SemaphoreHandle_t tickerLock = xSemaphoreCreateMutexStatic(&tickerLockBuf);
+
+// Guards tickerItems, numTickers, stockApiKey, the stats the TUI
+// reads and publishing
+struct TickerGuard {
+  TickerGuard()  { xSemaphoreTake(tickerLock, portMAX_DELAY); }
+  ~TickerGuard() { xSemaphoreGive(tickerLock); }
+};
+
+// Caller holds the lock, which is also what keeps tickerPub single-writer
+void publishLocked() {
+  TickerList snap;
+  memcpy(snap.items, tickerItems, sizeof(snap.items));
+  snap.count = numTickers;
+  tickerPub.publish(snap);
+}
+
+// Prices for list positions idx[0..n), where got[k] says which arrived
+void applyPrices(uint32_t gen, const int* idx, const float* price, const float* chg,
+                 const bool* got, int n) {
+  TickerGuard g;
+  if (gen != listGen) return;   // the list changed under us
+  for (int k = 0; k < n; k++) {
+    if (!got[k]) continue;
+    TickerItem& t = tickerItems[idx[k]];
+    t.price  = price[k];
+    t.change = chg[k];
+    t.valid  = true;
+    LOG("[Ticker] %s = $%.2f (%.1f%%)\n", t.symbol, price[k], chg[k]);
+  }
+  publishLocked();
+}
+
+
+// ── Refresh rounds ──────────────────────────────────────
+// One per provider while its transfers are out. A round copies what it
+// needs off the list under the ticker lock when it starts; its prices
+// go back in when the last answer lands, unless the list was reloaded
+// in the meantime.
+struct Round {
+  uint32_t      gen;
+  unsigned long startAt;
+  int           asked;
+  int           n;                    // quotes in the round
+  int           pending;              // transfers still out
+  int           idx[MAX_TICKERS];     // list positions
+  float         price[MAX_TICKERS];
+  float         chg[MAX_TICKERS];
+  bool          got[MAX_TICKERS];
+  bool          stood[MAX_TICKERS];   // still fresh, or confirmed by a 304
+};
+Round rounds[TP_COUNT];
 
-static WiFiClientSecure fhClient;
-static HTTPClient       fhHttp;
-static bool             fhInit = false;
+// A round's prices are in: apply them and count the refresh
+void endRound(TickerProvider p) {
+  Round& r = rounds[p];
+  applyPrices(r.gen, r.idx, r.price, r.chg, r.got, r.n);
+  int kept = 0;
+  for (int k = 0; k < r.n; k++) kept += r.got[k] || r.stood[k];
+  uint32_t    ms = millis() - r.startAt;
+  TickerGuard g;
+  TickerStats& s = stats[p];
+  s.lastMs = ms;
+  s.avgMs  = s.runs ? (s.avgMs * 7 + ms) / 8 : ms;   // EWMA, 1/8
+  s.maxMs  = max(s.maxMs, ms);
+  s.got    = kept;
+  s.asked  = r.asked;
+  s.runs++;
+  LOG("[Ticker] %s: %d/%d in %lums\n", PROVIDER_NAMES[p], kept, r.asked, (unsigned long)ms);
+}
+
+}  // namespace
 
 // ── Format "<SYM> $<price> " with tier-appropriate precision
 static void formatPrice(char* buf, size_t n, const char* sym, float price) {
@@ -36,10 +115,13 @@ const char* getCommodityFinnhubSymbol(const char* sym) {
   return nullptr;
 }
 
-// ── Load ticker list from NVS ───────────────────────────
+// ── Load ticker list and stock key from NVS ─────────────
 void loadTickers() {
   String list = prefs.getString("tickers", DEFAULT_TICKERS);
   LOG("[Ticker] List: %s\n", list.c_str());
+  TickerGuard g;
+  listGen++;
+  stockApiKey = prefs.getString("stockkey", "d6m0k71r01qu3p05ktsgd6m0k71r01qu3p05ktt0");
   numTickers = 0;
   int start = 0;
   while (start < (int)list.length() && numTickers < MAX_TICKERS) {
@@ -61,125 +143,192 @@ void loadTickers() {
     start = comma + 1;
   }
   LOG("[Ticker] Loaded %d tickers\n", numTickers);
+  // Prices were just zeroed; a 304 must not vouch for them
+  httpCacheClear();
 }
 
-// ── Fetch crypto prices from CoinGecko (batch) ─────────
-void fetchCryptoPrices() {
-  // Resolve CoinGecko ids once and cache alongside ticker index
-  const char* idCache[MAX_TICKERS] = {0};
-  String ids = "";
-  for (int i = 0; i < numTickers; i++) {
-    if (!tickerItems[i].isCrypto) continue;
-    const char* cgId = getCoinGeckoId(tickerItems[i].symbol);
-    if (!cgId) continue;
-    idCache[i] = cgId;
-    if (ids.length() > 0) ids += ",";
-    ids += cgId;
-  }
-  if (ids.length() == 0) return;
+// ── Publish the working list to readers ─────────────────
+void publishTickers() {
+  TickerGuard g;
+  publishLocked();
+}
 
-  if (!cgInit) {
-    cgClient.setInsecure();
-    cgHttp.setReuse(true);
-    cgHttp.setTimeout(10000);
-    cgInit = true;
-  }
-  String url = "https://api.coingecko.com/api/v3/simple/price?ids=" + ids +
-               "&vs_currencies=usd&include_24hr_change=true";
-  cgHttp.begin(cgClient, url);
-  cgHttp.addHeader("Accept", "application/json");
-  cgHttp.addHeader("User-Agent", "ESP32");
-  netTicker.txBytes += url.length() + REQ_HDR_EST;
-  int code = cgHttp.GET();
-  int cgSz = cgHttp.getSize();
-  netTicker.rxBytes += (cgSz > 0 ? (uint32_t)cgSz : 0) + RESP_HDR_EST;
+// ── Crypto prices from CoinGecko (batch) ───────────────
+// One request for every coin on the list
+static char cgPath[256];
+static const char* cgIds[MAX_TICKERS];
+
+static void cgHeaders(HttpClient& http, void*) {
+  http.header("Accept", "application/json");
+  http.acceptGzip();   // the body grows with the id list
+  http.useCache();
+}
+
+static void onCoinGecko(int code, uint8_t* body, size_t len, void*) {
+  Round& r = rounds[TP_COINGECKO];
   LOG("[Ticker] CoinGecko HTTP %d\n", code);
   if (code == 200) {
-    // Stream-parse straight from the TLS socket — skips a ~2-20 KB String
-    // allocation on internal heap that otherwise fragments during long idle.
-    JsonDocument doc;
-    deserializeJson(doc, cgHttp.getStream());
+    // Pull "<id>.usd" / "<id>.usd_24h_change" — no DOM, no String
+    char      paths[MAX_TICKERS][2][40];
+    JsonField fields[MAX_TICKERS * 2];
+    for (int k = 0; k < r.n; k++) {
+      snprintf(paths[k][0], sizeof(paths[k][0]), "%s.usd", cgIds[k]);
+      snprintf(paths[k][1], sizeof(paths[k][1]), "%s.usd_24h_change", cgIds[k]);
+      fields[2 * k]     = jsonFloat(paths[k][0], &r.price[k]);
+      fields[2 * k + 1] = jsonFloat(paths[k][1], &r.chg[k]);
+    }
+    if (!jsonExtract(body, len, fields, 2 * r.n)) {
+      LOGLN("[Ticker] CoinGecko JSON error");
+      httpCacheForget(COINGECKO_HOST, cgPath);
+    }
+    for (int k = 0; k < r.n; k++) r.got[k] = r.price[k] > 0;
+  } else if (code == 304) {
+    for (int k = 0; k < r.n; k++) r.stood[k] = true;
+  }
+  free(body);
+  r.pending = 0;
+  endRound(TP_COINGECKO);
+}
+
+// False if no request went out
+static bool startCrypto() {
+  Round& r = rounds[TP_COINGECKO];
+  r = Round{};
+  {
+    TickerGuard g;
+    r.gen = listGen;
     for (int i = 0; i < numTickers; i++) {
-      const char* cgId = idCache[i];
+      if (!tickerItems[i].isCrypto) continue;
+      const char* cgId = getCoinGeckoId(tickerItems[i].symbol);
       if (!cgId) continue;
-      float p = doc[cgId]["usd"] | 0.0f;
-      float c = doc[cgId]["usd_24h_change"] | 0.0f;
-      if (p > 0) {
-        tickerItems[i].price = p;
-        tickerItems[i].change = c;
-        tickerItems[i].valid = true;
-        LOG("[Ticker] %s = $%.2f (%.1f%%)\n", tickerItems[i].symbol, p, c);
-      }
+      cgIds[r.n]   = cgId;
+      r.idx[r.n++] = i;
     }
-    doc.clear();
-  } else {
-    LOG("[Ticker] CoinGecko error: %s\n", cgHttp.getString().c_str());
   }
-  cgHttp.end();
+  r.asked = r.n;
+  if (r.n == 0) return false;
+
+  size_t pl = strlcpy(cgPath, "/api/v3/simple/price?ids=", sizeof(cgPath));
+  for (int k = 0; k < r.n; k++) {
+    pl += snprintf(cgPath + pl, sizeof(cgPath) - pl, "%s%s", k ? "," : "", cgIds[k]);
+  }
+  strlcat(cgPath, "&vs_currencies=usd&include_24hr_change=true", sizeof(cgPath));
+  if (httpCacheFresh(httpCacheKey(COINGECKO_HOST, cgPath))) return false;
+
+  // Lowest pool priority: never costs Spotify or the art CDN their session
+  r.startAt = millis();
+  FetchReq req = { COINGECKO_HOST, cgPath, nullptr, nullptr, PRIO_TICKER, EP_COINGECKO,
+                   &netTicker, schedBudget(), 0, cgHeaders };
+  if (!fetchRequest(req, onCoinGecko)) return false;
+  r.pending = 1;
+  return true;
 }
 
-// ── Fetch stock/commodity prices from Finnhub ───────────
-void fetchStockPrices() {
-  if (stockApiKey.length() == 0) return;
+// ── Pipelined Finnhub quotes ────────────────────────────
+// Finnhub has no batch endpoint, so every quote is its own request.
+// They go out back to back on one keep-alive session (FETCH_PIPELINE)
+// and the answers are read off in order. If the server closes
+// mid-batch (request limit, idle timeout), the reactor sends the
+// unanswered tail again on a fresh (resumed) session; an open breaker
+// (e.g. a 429 for the free tier's 60 calls/min) stops the rest.
+// Quotes still fresh in the HTTP cache are not requested at all; the
+// rest carry their validators, and a 304 keeps the price we have.
+static char fhPath[MAX_TICKERS][128];
 
-  if (!fhInit) {
-    fhClient.setInsecure();
-    fhHttp.setReuse(true);
-    fhHttp.setTimeout(10000);
-    fhInit = true;
+static void onQuote(int code, uint8_t* body, size_t len, void* ctx) {
+  Round& r = rounds[TP_FINNHUB];
+  int    k = (int)(intptr_t)ctx;
+  LOG("[Ticker] Finnhub #%d HTTP %d\n", k, code);
+  if (code == 200) {
+    JsonField fields[] = { jsonFloat("c", &r.price[k]), jsonFloat("dp", &r.chg[k]) };
+    if (!jsonExtract(body, len, fields, 2)) httpCacheForget(FINNHUB_HOST, fhPath[k]);
+    r.got[k] = r.price[k] > 0;
+  } else if (code == 304) {
+    r.stood[k] = true;
   }
+  free(body);
+  if (--r.pending == 0) endRound(TP_FINNHUB);
+}
 
-  for (int i = 0; i < numTickers; i++) {
-    if (tickerItems[i].isCrypto) continue;
-
-    // Use mapped Finnhub symbol for commodities, raw symbol for stocks
-    String symbol;
-    if (tickerItems[i].isCommodity) {
-      const char* mapped = getCommodityFinnhubSymbol(tickerItems[i].symbol);
-      if (!mapped) continue;
-      symbol = mapped;
-    } else {
-      symbol = tickerItems[i].symbol;
-    }
+static void fhHeaders(HttpClient& http, void*) {
+  http.useCache();
+}
 
-    String url = "https://finnhub.io/api/v1/quote?symbol=";
-    url += symbol;
-    url += "&token=";
-    url += stockApiKey;
-    fhHttp.begin(fhClient, url);
-    netTicker.txBytes += url.length() + REQ_HDR_EST;
-    int code = fhHttp.GET();
-    int fhSz = fhHttp.getSize();
-    netTicker.rxBytes += (fhSz > 0 ? (uint32_t)fhSz : 0) + RESP_HDR_EST;
-    LOG("[Ticker] Finnhub %s HTTP %d\n", tickerItems[i].symbol, code);
-    if (code == 200) {
-      JsonDocument doc;
-      deserializeJson(doc, fhHttp.getStream());
-      float price = doc["c"] | 0.0f;
-      float pct   = doc["dp"] | 0.0f;
-      if (price > 0) {
-        tickerItems[i].price = price;
-        tickerItems[i].change = pct;
-        tickerItems[i].valid = true;
-        LOG("[Ticker] %s = $%.2f (%.1f%%)\n", tickerItems[i].symbol, price, pct);
+// False if no request went out
+static bool startStocks() {
+  Round& r = rounds[TP_FINNHUB];
+  r = Round{};
+  char        key[64];
+  char        symBuf[MAX_TICKERS][8];
+  const char* syms[MAX_TICKERS];
+  {
+    TickerGuard g;
+    r.gen = listGen;
+    strlcpy(key, stockApiKey.c_str(), sizeof(key));
+    for (int i = 0; i < numTickers; i++) {
+      if (tickerItems[i].isCrypto) continue;
+
+      // Use mapped Finnhub symbol for commodities, raw symbol for stocks
+      if (tickerItems[i].isCommodity) {
+        const char* mapped = getCommodityFinnhubSymbol(tickerItems[i].symbol);
+        if (!mapped) continue;
+        syms[r.n] = mapped;
+      } else {
+        strlcpy(symBuf[r.n], tickerItems[i].symbol, sizeof(symBuf[r.n]));
+        syms[r.n] = symBuf[r.n];
       }
-      doc.clear();
+      r.idx[r.n++] = i;
+    }
+  }
+  r.asked = key[0] ? r.n : 0;
+  if (r.asked == 0) return false;
+
+  r.startAt = millis();
+  r.pending = 1;   // held until every quote is out, so none ends the round early
+  for (int k = 0; k < r.n; k++) {
+    snprintf(fhPath[k], sizeof(fhPath[k]), "/api/v1/quote?symbol=%s&token=%s", syms[k], key);
+    if (httpCacheFresh(httpCacheKey(FINNHUB_HOST, fhPath[k]))) {
+      r.stood[k] = true;
+      continue;
     }
-    fhHttp.end();
+    FetchReq req = { FINNHUB_HOST, fhPath[k], nullptr, nullptr, PRIO_TICKER, EP_FINNHUB,
+                     &netTicker, schedBudget(), FETCH_PIPELINE, fhHeaders };
+    if (fetchRequest(req, onQuote, (void*)(intptr_t)k)) r.pending++;
   }
+  if (--r.pending) return true;
+  // Nothing went out: still a refresh if the cache vouched for quotes
+  bool fresh = false;
+  for (int k = 0; k < r.n; k++) fresh |= r.stood[k];
+  if (fresh) endRound(TP_FINNHUB);
+  return false;
+}
+
+void tickerRefresh() {
+  if (tickerBusy()) return;
+  startCrypto();
+  startStocks();
+}
+
+bool tickerBusy() {
+  return rounds[TP_COINGECKO].pending || rounds[TP_FINNHUB].pending;
+}
+
+void tickerStats(TickerProvider p, TickerStats& out) {
+  TickerGuard g;
+  out = stats[p];
 }
 
 // ── Recalculate total scroll width (core 1 only) ────────
 void recalcTickerWidth() {
   tickerTextW = 0;
   tft.setTextFont(2);
-  for (int i = 0; i < numTickers; i++) {
-    if (!tickerItems[i].valid) continue;
+  for (int i = 0; i < tickerView.count; i++) {
+    if (!tickerView.items[i].valid) continue;
     char buf[32];
-    formatPrice(buf, sizeof(buf), tickerItems[i].symbol, tickerItems[i].price);
+    formatPrice(buf, sizeof(buf), tickerView.items[i].symbol, tickerView.items[i].price);
     tickerTextW += tft.textWidth(buf);
     char chg[16];
-    snprintf(chg, sizeof(chg), "%s%.1f%%", tickerItems[i].change >= 0 ? "+" : "", tickerItems[i].change);
+    snprintf(chg, sizeof(chg), "%s%.1f%%", tickerView.items[i].change >= 0 ? "+" : "", tickerView.items[i].change);
     tickerTextW += tft.textWidth(chg) + TICKER_GAP;
   }
   tickerReady = (tickerTextW > 0);
@@ -189,17 +338,17 @@ void recalcTickerWidth() {
 // ── Draw ticker items at x offset ───────────────────────
 int drawTickerItemsAt(int startX) {
   int x = startX;
-  for (int i = 0; i < numTickers; i++) {
-    if (!tickerItems[i].valid) continue;
+  for (int i = 0; i < tickerView.count; i++) {
+    if (!tickerView.items[i].valid) continue;
     char buf[32];
-    formatPrice(buf, sizeof(buf), tickerItems[i].symbol, tickerItems[i].price);
+    formatPrice(buf, sizeof(buf), tickerView.items[i].symbol, tickerView.items[i].price);
     tickerSpr.setTextColor(COLOR_TICKER_SYM, TFT_BLACK);
     tickerSpr.setCursor(x, 0);
     tickerSpr.print(buf);
     x += tickerSpr.textWidth(buf);
     char chg[16];
-    snprintf(chg, sizeof(chg), "%s%.1f%%", tickerItems[i].change >= 0 ? "+" : "", tickerItems[i].change);
-    tickerSpr.setTextColor(tickerItems[i].change >= 0 ? COLOR_GAIN : COLOR_LOSS, TFT_BLACK);
+    snprintf(chg, sizeof(chg), "%s%.1f%%", tickerView.items[i].change >= 0 ? "+" : "", tickerView.items[i].change);
+    tickerSpr.setTextColor(tickerView.items[i].change >= 0 ? COLOR_GAIN : COLOR_LOSS, TFT_BLACK);
     tickerSpr.setCursor(x, 0);
     tickerSpr.print(chg);
     x += tickerSpr.textWidth(chg) + TICKER_GAP;
@@ -209,7 +358,7 @@ int drawTickerItemsAt(int startX) {
 
 // ── Draw one frame of scrolling ticker ──────────────────
 void drawTicker() {
-  if (!tickerReady || numTickers == 0) return;
+  if (!tickerReady || tickerView.count == 0) return;
   tickerSpr.fillSprite(TFT_BLACK);
   tickerSpr.setTextFont(2);
   if (tickerTextW <= SCR_W) {
@@ -0,0 +1,646 @@
+// ============================================================
+//  TLS client with per-host session resumption (see tlsclient.h)
+// ============================================================
+
+#include "config.h"
+#include <mbedtls/ssl.h>
+#include <mbedtls/platform.h>
+#include <mbedtls/platform_util.h>
+#include <esp_heap_caps.h>
+#include <lwip/sockets.h>
+#include <esp_system.h>
+
+const uint16_t TLS_HIST_EDGES_MS[TLS_HIST_BUCKETS - 1] = { 100, 250, 500, 1000, 2000 };
+
+namespace {
+
+// ── Handshake profile ───────────────────────────────────
+// ECDSA certificates make the server's signature cheap to check and the
+// key exchange small; GCM runs on the AES/SHA peripherals. The tail keeps
+// hosts with older configurations reachable.
+const int CIPHERS[] = {
+  MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+  MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+  MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384,
+  MBEDTLS_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384,
+  MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256,
+  MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA,
+  MBEDTLS_TLS_RSA_WITH_AES_128_GCM_SHA256,
+  0
+};
+
+// Preference order; the server picks
+const char* ALPN_H2[] = { "h2", "http/1.1", nullptr };
+
+const mbedtls_ecp_group_id CURVES[] = {
+#if defined(MBEDTLS_ECP_DP_CURVE25519_ENABLED)
+  MBEDTLS_ECP_DP_CURVE25519,
+#endif
+  MBEDTLS_ECP_DP_SECP256R1,
+  MBEDTLS_ECP_DP_SECP384R1,
+  MBEDTLS_ECP_DP_NONE
+};
+
+int tlsRandom(void*, unsigned char* out, size_t len) {
+  esp_fill_random(out, len);
+  return 0;
+}
+
+// Socket I/O for mbedTLS; every record moved counts as radio traffic
+int netSend(void* ctx, const unsigned char* buf, size_t len) {
+  int ret = mbedtls_net_send(ctx, buf, len);
+  if (ret > 0) radioTouch();
+  return ret;
+}
+
+int netRecv(void* ctx, unsigned char* buf, size_t len) {
+  int ret = mbedtls_net_recv(ctx, buf, len);
+  if (ret > 0) radioTouch();
+  return ret;
+}
+
+// ── Per-host session cache + stats ──────────────────────
+// Shared by clients on both cores, so every access holds `cacheLock`.
+struct HostEntry {
+  TlsHostStats        stats;
+  mbedtls_ssl_session session;
+  bool                hasSession;
+  bool                offerH2;
+  unsigned long       lastUsed;
+};
+
+HostEntry         hosts[TLS_HOST_SLOTS];
+int               hostCount = 0;
+StaticSemaphore_t cacheLockBuf;
+SemaphoreHandle_t cacheLock = xSemaphoreCreateMutexStatic(&cacheLockBuf);
+
+struct CacheGuard {
+  CacheGuard()  { xSemaphoreTake(cacheLock, portMAX_DELAY); }
+  ~CacheGuard() { xSemaphoreGive(cacheLock); }
+};
+
+HostEntry* findHost(const char* host) {
+  for (int i = 0; i < hostCount; i++) {
+    if (strcmp(hosts[i].stats.host, host) == 0) return &hosts[i];
+  }
+  return nullptr;
+}
+
+// Find or claim a slot, recycling the least recently used host
+HostEntry* hostFor(const char* host) {
+  HostEntry* e = findHost(host);
+  if (e) return e;
+  if (hostCount < TLS_HOST_SLOTS) {
+    e = &hosts[hostCount++];
+  } else {
+    e = &hosts[0];
+    for (int i = 1; i < hostCount; i++) {
+      if ((long)(hosts[i].lastUsed - e->lastUsed) < 0) e = &hosts[i];
+    }
+    mbedtls_ssl_session_free(&e->session);
+  }
+  memset(&e->stats, 0, sizeof(e->stats));
+  strlcpy(e->stats.host, host, sizeof(e->stats.host));
+  mbedtls_ssl_session_init(&e->session);
+  e->hasSession = false;
+  e->offerH2    = false;
+  e->lastUsed   = millis();
+  return e;
+}
+
+int histBucket(unsigned long ms) {
+  int b = 0;
+  while (b < TLS_HIST_BUCKETS - 1 && ms >= TLS_HIST_EDGES_MS[b]) b++;
+  return b;
+}
+
+// ── mbedTLS allocator ───────────────────────────────────
+// Every block carries a header with its size, the region it landed
+// in and the client it is charged to, so free() needs no lookup and
+// a policy change never strands a live block. Blocks are charged to
+// the client whose handshake allocated them; a TLS 1.2 connection
+// allocates nothing after that.
+#define BLOCK_PSRAM  0x80000000u
+
+struct BlockHead {
+  uint32_t         size;    // payload bytes | BLOCK_PSRAM
+  TlsClient::Mem*  owner;   // nullptr: not a client's (session cache, other users)
+};
+
+const uint32_t CAPS_INTERNAL = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+const uint32_t CAPS_PSRAM    = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+
+bool                  allocOn = false;
+std::atomic<uint8_t>  allocPolicy{TLS_ALLOC_INTERNAL};
+std::atomic<uint32_t> liveInternal{0};
+std::atomic<uint32_t> livePsram{0};
+std::atomic<uint32_t> allocFallbacks{0};
+std::atomic<uint32_t> allocFailed{0};
+uint32_t              peakInternal = 0;             // racy max; telemetry only
+TlsPolicyStats        policyStats[TLS_ALLOC_POLICIES];   // under cacheLock
+
+// mbedTLS calls in from whichever task runs the connection
+thread_local TlsClient::Mem* allocOwner = nullptr;
+
+struct OwnerScope {
+  explicit OwnerScope(TlsClient::Mem* m) : prev_(allocOwner) { allocOwner = m; }
+  ~OwnerScope() { allocOwner = prev_; }
+  TlsClient::Mem* prev_;
+};
+
+void* tlsCalloc(size_t n, size_t size) {
+  if (size && n > (BLOCK_PSRAM - 1 - sizeof(BlockHead)) / size) return nullptr;
+  uint32_t len = n * size;
+  uint8_t  pol = allocPolicy.load(std::memory_order_relaxed);
+  bool psram = pol == TLS_ALLOC_PSRAM || (pol == TLS_ALLOC_SPLIT && len >= TLS_ALLOC_SPLIT_MIN);
+  BlockHead* h = (BlockHead*)heap_caps_calloc(1, sizeof(BlockHead) + len,
+                                              psram ? CAPS_PSRAM : CAPS_INTERNAL);
+  if (!h) {
+    // The other region beats failing a handshake
+    psram = !psram;
+    h = (BlockHead*)heap_caps_calloc(1, sizeof(BlockHead) + len,
+                                     psram ? CAPS_PSRAM : CAPS_INTERNAL);
+    if (!h) {
+      allocFailed++;
+      return nullptr;
+    }
+    allocFallbacks++;
+  }
+  h->size  = len | (psram ? BLOCK_PSRAM : 0);
+  h->owner = allocOwner;
+  if (psram) {
+    livePsram += len;
+    if (h->owner) h->owner->psram += len;
+  } else {
+    uint32_t all = liveInternal += len;
+    if (all > peakInternal) peakInternal = all;
+    if (h->owner) {
+      uint32_t mine = h->owner->internal += len;
+      if (mine > h->owner->peak) h->owner->peak = mine;
+    }
+  }
+  return h + 1;
+}
+
+void tlsFree(void* p) {
+  if (!p) return;
+  BlockHead* h   = (BlockHead*)p - 1;
+  uint32_t   len = h->size & ~BLOCK_PSRAM;
+  if (h->size & BLOCK_PSRAM) {
+    livePsram -= len;
+    if (h->owner) h->owner->psram -= len;
+  } else {
+    liveInternal -= len;
+    if (h->owner) h->owner->internal -= len;
+  }
+  heap_caps_free(h);
+}
+
+}  // namespace
+
+void tlsOfferH2(const char* host, bool on) {
+  CacheGuard g;
+  hostFor(host)->offerH2 = on;
+}
+
+void tlsForgetSession(const char* host) {
+  CacheGuard g;
+  HostEntry* e = findHost(host);
+  if (!e || !e->hasSession) return;
+  mbedtls_ssl_session_free(&e->session);
+  mbedtls_ssl_session_init(&e->session);
+  e->hasSession = false;
+}
+
+void tlsNoteFirstByte(const char* host, unsigned long ms) {
+  CacheGuard g;
+  if (HostEntry* e = findHost(host)) e->stats.ttfbMs = (uint16_t)min(ms, 65535UL);
+}
+
+int tlsHostStats(TlsHostStats* out, int max) {
+  CacheGuard g;
+  int n = min(max, hostCount);
+  for (int i = 0; i < n; i++) out[i] = hosts[i].stats;
+  return n;
+}
+
+bool tlsAllocInstall(TlsAllocPolicy policy) {
+#if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO)
+  allocOn = mbedtls_platform_set_calloc_free(tlsCalloc, tlsFree) == 0;
+#endif
+  if (!allocOn) {
+    LOGLN("[TLS] mbedTLS allocator is fixed by the build; TLS memory stays untracked");
+    return false;
+  }
+  tlsAllocSetPolicy(policy);
+  return true;
+}
+
+bool tlsAllocInstalled() {
+  return allocOn;
+}
+
+void tlsAllocSetPolicy(TlsAllocPolicy policy) {
+  if (policy != TLS_ALLOC_INTERNAL && !ESP.getPsramSize()) policy = TLS_ALLOC_INTERNAL;
+  allocPolicy = policy;
+  LOG("[TLS] mbedTLS allocations: %s\n", tlsAllocName(policy));
+}
+
+TlsAllocPolicy tlsAllocPolicy() {
+  return (TlsAllocPolicy)allocPolicy.load();
+}
+
+const char* tlsAllocName(TlsAllocPolicy policy) {
+  static const char* NAMES[] = { "internal", "split", "psram" };
+  return policy < TLS_ALLOC_POLICIES ? NAMES[policy] : "?";
+}
+
+uint32_t tlsSessionCost(uint32_t fallback) {
+  if (!allocOn) return fallback;
+  CacheGuard g;
+  uint32_t peak = policyStats[allocPolicy.load()].peakInternal;
+  return peak ? peak : fallback;
+}
+
+void tlsAllocStats(TlsAllocStats& out) {
+  out.installed    = allocOn;
+  out.policy       = tlsAllocPolicy();
+  out.internal     = liveInternal;
+  out.psram        = livePsram;
+  out.peakInternal = peakInternal;
+  out.fallbacks    = allocFallbacks;
+  out.failed       = allocFailed;
+  CacheGuard g;
+  memcpy(out.policies, policyStats, sizeof(policyStats));
+}
+
+void tlsAllocResetStats() {
+  CacheGuard g;
+  memset(policyStats, 0, sizeof(policyStats));
+}
+
+// ============================================================
+//  TlsClient
+// ============================================================
+TlsClient::TlsClient() {
+  mbedtls_net_init(&net_);
+}
+
+TlsClient::~TlsClient() {
+  stop();
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+  return connect(ip, port, TLS_CONNECT_TIMEOUT_MS);
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+  dnsMs_ = 0;
+  return open(ip, port, ip.toString().c_str(), timeout);
+}
+
+int TlsClient::connect(const char* host, uint16_t port) {
+  return connect(host, port, TLS_CONNECT_TIMEOUT_MS);
+}
+
+int TlsClient::connect(const char* host, uint16_t port, int32_t timeout) {
+  IPAddress ip;
+  if (!dnsResolve(host, ip, &dnsMs_)) {
+    LOG("[TLS] DNS failed: %s\n", host);
+    return 0;
+  }
+  return open(ip, port, host, timeout);
+}
+
+int TlsClient::open(IPAddress ip, uint16_t port, const char* host, int32_t timeoutMs) {
+  if (!tcpStart(ip, port, host)) return 0;
+  int32_t tcpLimit = timeoutMs > 0 ? timeoutMs : TLS_CONNECT_TIMEOUT_MS;
+  for (;;) {
+    TlsStep step = connectStep();
+    if (step != TLS_STEP_PENDING) return step == TLS_STEP_DONE;
+    bool    tcp  = phase_ == CONN_TCP;
+    int32_t left = (tcp ? tcpLimit : TLS_HANDSHAKE_TIMEOUT_MS) - (int32_t)(millis() - phaseAt_);
+    if (waitIo(wantWrite(), left)) continue;
+    if (tcp) {
+      tcpFailed();
+    } else {
+      phase_ = CONN_IDLE;
+      handshakeDone(MBEDTLS_ERR_SSL_TIMEOUT);
+      stop();
+    }
+    return 0;
+  }
+}
+
+bool TlsClient::connectStart(const char* host, uint16_t port) {
+  IPAddress ip;
+  if (!dnsResolve(host, ip, &dnsMs_)) {
+    LOG("[TLS] DNS failed: %s\n", host);
+    return false;
+  }
+  return tcpStart(ip, port, host);
+}
+
+bool TlsClient::tcpStart(IPAddress ip, uint16_t port, const char* host) {
+  stop();
+  strlcpy(host_, host, sizeof(host_));
+  phaseAt_ = millis();
+  int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd < 0) {
+    tcpFailed();
+    return false;
+  }
+  radioTouch();   // SYN
+  net_.fd = fd;
+  lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+  struct sockaddr_in sa = {};
+  sa.sin_family      = AF_INET;
+  sa.sin_port        = htons(port);
+  sa.sin_addr.s_addr = (uint32_t)ip;
+  if (lwip_connect(fd, (struct sockaddr*)&sa, sizeof(sa)) < 0 && errno != EINPROGRESS) {
+    tcpFailed();
+    return false;
+  }
+  // Connected or not, the socket turns writable once it is settled
+  phase_ = CONN_TCP;
+  return true;
+}
+
+void TlsClient::tcpFailed() {
+  LOG("[TLS] TCP connect failed: %s\n", host_);
+  stop();
+  dnsForget(host_);   // the address may have moved
+}
+
+TlsStep TlsClient::connectStep() {
+  if (phase_ == CONN_TCP) {
+    if (!waitIo(true, 0)) return TLS_STEP_PENDING;
+    int err = 0;
+    socklen_t len = sizeof(err);
+    lwip_getsockopt(net_.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err) {
+      tcpFailed();
+      return TLS_STEP_FAILED;
+    }
+    // Requests are a single small write; don't let Nagle hold them back
+    int one = 1;
+    lwip_setsockopt(net_.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    tcpMs_   = (uint16_t)min(millis() - phaseAt_, 65535UL);
+    phase_   = CONN_TLS;
+    phaseAt_ = millis();
+    if (!handshakeSetup()) {
+      stop();
+      return TLS_STEP_FAILED;
+    }
+  }
+  if (phase_ != CONN_TLS) return connected_ ? TLS_STEP_DONE : TLS_STEP_FAILED;
+
+  int ret;
+  {
+    OwnerScope owner(&mem_);
+    ret = mbedtls_ssl_handshake(&ssl_);
+  }
+  if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+    wantWrite_ = ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+    return TLS_STEP_PENDING;
+  }
+  phase_ = CONN_IDLE;
+  if (!handshakeDone(ret)) {
+    stop();
+    return TLS_STEP_FAILED;
+  }
+  connected_ = true;
+  epoch_++;
+  return TLS_STEP_DONE;
+}
+
+// 0 polls; a spent (negative) timeout fails without looking
+bool TlsClient::waitIo(bool forWrite, int32_t timeoutMs) {
+  if (net_.fd < 0 || timeoutMs < 0) return false;
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(net_.fd, &fds);
+  struct timeval tv = { (time_t)(timeoutMs / 1000), (suseconds_t)((timeoutMs % 1000) * 1000) };
+  return lwip_select(net_.fd + 1, forWrite ? nullptr : &fds, forWrite ? &fds : nullptr,
+                     nullptr, &tv) > 0;
+}
+
+// Everything up to the first handshake message
+bool TlsClient::handshakeSetup() {
+  OwnerScope owner(&mem_);
+  policy_   = tlsAllocPolicy();
+  mem_.peak = mem_.internal;
+  mbedtls_ssl_init(&ssl_);
+  mbedtls_ssl_config_init(&conf_);
+  ready_     = true;
+  h2_        = false;
+  resumed_   = false;
+  wantWrite_ = false;
+  bool offerH2;
+  {
+    CacheGuard g;
+    offerH2 = hostFor(host_)->offerH2;
+  }
+
+  if (mbedtls_ssl_config_defaults(&conf_, MBEDTLS_SSL_IS_CLIENT,
+                                  MBEDTLS_SSL_TRANSPORT_STREAM,
+                                  MBEDTLS_SSL_PRESET_DEFAULT) != 0) return false;
+  mbedtls_ssl_conf_authmode(&conf_, MBEDTLS_SSL_VERIFY_NONE);
+  mbedtls_ssl_conf_rng(&conf_, tlsRandom, nullptr);
+  mbedtls_ssl_conf_ciphersuites(&conf_, CIPHERS);
+  mbedtls_ssl_conf_curves(&conf_, CURVES);
+  mbedtls_ssl_conf_min_version(&conf_, MBEDTLS_SSL_MAJOR_VERSION_3, MBEDTLS_SSL_MINOR_VERSION_3);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+  mbedtls_ssl_conf_session_tickets(&conf_, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+#if defined(MBEDTLS_SSL_ALPN)
+  if (offerH2) mbedtls_ssl_conf_alpn_protocols(&conf_, ALPN_H2);
+#endif
+  if (mbedtls_ssl_setup(&ssl_, &conf_) != 0) return false;
+  mbedtls_ssl_set_hostname(&ssl_, host_);
+  mbedtls_ssl_set_bio(&ssl_, &net_, netSend, netRecv, nullptr);
+
+  // Offer the cached session (ticket and/or session ID) if we have one.
+  // Remember its master secret: a resumed handshake keeps it, a full one
+  // derives a new one. The session ID can't tell — mbedTLS sends a fresh
+  // random ID alongside a ticket.
+  CacheGuard g;
+  HostEntry* e = hostFor(host_);
+  offered_ = e->hasSession && mbedtls_ssl_set_session(&ssl_, &e->session) == 0;
+  if (offered_) memcpy(master_, e->session.master, sizeof(master_));
+  return true;
+}
+
+// The handshake ended with `ret`: time it, keep the session for next
+// time, and count it per host and per allocator policy
+bool TlsClient::handshakeDone(int ret) {
+  unsigned long ms = millis() - phaseAt_;
+  bool ok = (ret == 0);
+#if defined(MBEDTLS_SSL_ALPN)
+  if (ok) {
+    const char* proto = mbedtls_ssl_get_alpn_protocol(&ssl_);
+    h2_ = proto && strcmp(proto, "h2") == 0;
+  }
+#endif
+
+  {
+    CacheGuard g;
+    HostEntry* e = hostFor(host_);
+    TlsHostStats& s = e->stats;
+    e->lastUsed = millis();
+    s.lastMs = (uint16_t)min(ms, 65535UL);
+    s.dnsMs  = dnsMs_;
+    s.tcpMs  = tcpMs_;
+    s.ttfbMs = 0;
+    if (!ok) {
+      s.failed++;
+      // A stale session must not keep a host unreachable
+      if (offered_) {
+        mbedtls_ssl_session_free(&e->session);
+        mbedtls_ssl_session_init(&e->session);
+        e->hasSession = false;
+      }
+    } else {
+      // Keep the latest session — the server may have issued a new ticket.
+      // The copy outlives this connection, so it isn't charged to it.
+      {
+        OwnerScope cache(nullptr);
+        mbedtls_ssl_session_free(&e->session);
+        mbedtls_ssl_session_init(&e->session);
+        e->hasSession = (mbedtls_ssl_get_session(&ssl_, &e->session) == 0);
+      }
+      resumed_ = offered_ && e->hasSession &&
+                 memcmp(e->session.master, master_, sizeof(master_)) == 0;
+
+      s.lastResumed = resumed_;
+      s.h2          = h2_;
+      if (resumed_) { s.resumed++; s.resumedMsSum += ms; }
+      else          { s.full++;    s.fullMsSum    += ms; }
+      s.hist[histBucket(ms)]++;
+
+      TlsPolicyStats& p = policyStats[policy_];
+      if (resumed_) { p.resumed++; p.resumedMsSum += ms; }
+      else          { p.full++;    p.fullMsSum    += ms;
+                      p.peakInternal = max(p.peakInternal, mem_.peak); }
+      p.residentInternal = mem_.internal;
+      p.residentPsram    = mem_.psram;
+    }
+  }
+
+  mbedtls_platform_zeroize(master_, sizeof(master_));
+
+  if (ok) {
+    LOG("[TLS] %s: %s handshake %lums (%s%s)\n", host_, resumed_ ? "resumed" : "full",
+        ms, mbedtls_ssl_get_ciphersuite(&ssl_), h2_ ? ", h2" : "");
+  } else {
+    LOG("[TLS] %s: handshake failed -0x%04x after %lums\n", host_, (unsigned)-ret, ms);
+  }
+  return ok;
+}
+
+size_t TlsClient::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t TlsClient::write(const uint8_t* buf, size_t size) {
+  if (!connected_ || closed_) return 0;
+  size_t done = 0;
+  unsigned long t0 = millis();
+  while (done < size) {
+    int ret = mbedtls_ssl_write(&ssl_, buf + done, size - done);
+    if (ret > 0) { done += ret; continue; }
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      closed_ = true;
+      break;
+    }
+    if (!waitIo(ret == MBEDTLS_ERR_SSL_WANT_WRITE, (int32_t)(_timeout - (millis() - t0)))) break;
+  }
+  return done;
+}
+
+int TlsClient::available() {
+  if (!connected_) return 0;
+  int n = (int)mbedtls_ssl_get_bytes_avail(&ssl_);
+  if (n == 0 && !closed_) {
+    // Pull in a record if one has arrived (non-blocking socket)
+    int ret = mbedtls_ssl_read(&ssl_, nullptr, 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      closed_ = true;
+    }
+    n = (int)mbedtls_ssl_get_bytes_avail(&ssl_);
+  }
+  return n + (peek_ >= 0 ? 1 : 0);
+}
+
+int TlsClient::read(uint8_t* buf, size_t size) {
+  if (!buf || !size || available() <= 0) return -1;
+  size_t n = 0;
+  if (peek_ >= 0) {
+    buf[n++] = (uint8_t)peek_;
+    peek_ = -1;
+  }
+  if (n < size && mbedtls_ssl_get_bytes_avail(&ssl_) > 0) {
+    int ret = mbedtls_ssl_read(&ssl_, buf + n, size - n);
+    if (ret > 0) n += ret;
+    else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) closed_ = true;
+  }
+  return n ? (int)n : -1;
+}
+
+int TlsClient::read() {
+  uint8_t b;
+  return (read(&b, 1) == 1) ? b : -1;
+}
+
+int TlsClient::peek() {
+  if (peek_ < 0) {
+    uint8_t b;
+    if (read(&b, 1) == 1) peek_ = b;
+  }
+  return peek_;
+}
+
+// Same as WiFiClient: discard whatever is still buffered
+void TlsClient::flush() {
+  uint8_t tmp[64];
+  while (available() > 0 && read(tmp, sizeof(tmp)) > 0) {}
+}
+
+bool TlsClient::alive() {
+  if (!connected_ || closed_ || net_.fd < 0) return false;
+  if (peek_ >= 0 || mbedtls_ssl_get_bytes_avail(&ssl_) > 0) return false;
+  uint8_t b;
+  int r = lwip_recv(net_.fd, &b, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (r == 0) return false;                                   // FIN
+  if (r < 0)  return errno == EWOULDBLOCK || errno == EAGAIN;  // quiet: alive
+  // A record arrived while idle — let mbedtls look (usually close_notify)
+  available();
+  return !closed_ && mbedtls_ssl_get_bytes_avail(&ssl_) == 0;
+}
+
+uint8_t TlsClient::connected() {
+  if (!connected_) return 0;
+  if (!closed_) available();   // notices close_notify / FIN
+  return !closed_ || mbedtls_ssl_get_bytes_avail(&ssl_) > 0 || peek_ >= 0;
+}
+
+void TlsClient::stop() {
+  if (ready_) {
+    // A clean close keeps the session resumable on strict servers
+    if (connected_ && !closed_) mbedtls_ssl_close_notify(&ssl_);
+    mbedtls_ssl_free(&ssl_);
+    mbedtls_ssl_config_free(&conf_);
+    ready_ = false;
+  }
+  if (net_.fd >= 0) {
+    lwip_close(net_.fd);
+    net_.fd = -1;
+  }
+  connected_ = false;
+  closed_    = false;
+  h2_        = false;
+  peek_      = -1;
+  phase_     = CONN_IDLE;
+  wantWrite_ = false;
+}
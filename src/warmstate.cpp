@@ -0,0 +1,205 @@
+// ============================================================
+//  Warm-boot state: what the last session knew, back on screen
+//  before Wi-Fi is up
+// ============================================================
+//  RTC slow memory survives every reset except power-on (crash,
+//  watchdog, brownout, ESP.restart()), so it takes a full copy
+//  every WARM_SAVE_MS: playback, prices, the access token and the
+//  HTTP validators. Flash outlives a power cut but wears, so it
+//  only gets playback and prices, only when they changed, and at
+//  most once per WARM_FLASH_MS; the last cover goes to a LittleFS
+//  file on the same terms. The access token never goes to flash:
+//  the refresh token already there is enough to get a new one.
+// ============================================================
+
+#include "config.h"
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include <LittleFS.h>
+#include <atomic>
+
+namespace {
+
+#define WARM_MAGIC      0x5741524Du   // "WARM"
+#define WARM_EPOCH_MIN  1700000000L   // earlier than this: clock not set yet
+#define ART_FILE        "/art.jpg"
+#define ART_TMP         "/art.tmp"
+#define ART_MAX         300000        // same bound as a download
+
+// The state is kept as raw bytes: Playback has member initialisers,
+// and a member with a constructor would be reset on every boot,
+// RTC_NOINIT or not.
+struct RtcImage {
+  uint32_t       magic;
+  uint32_t       crc;             // over everything below
+  uint8_t        state[sizeof(WarmState)];
+  uint8_t        cacheCount;
+  HttpCacheEntry cache[HTTP_CACHE_SLOTS];
+};
+
+// Flash copy (NVS blob): no token, no validators
+struct FlashImage {
+  uint32_t   magic;               // WARM_MAGIC ^ size: a new layout reads as empty
+  time_t     savedAt;
+  Playback   playback;
+  TickerList tickers;
+};
+
+struct ArtHeader {
+  uint32_t magic;
+  uint32_t len;
+  char     url[sizeof(Playback::imgUrl)];
+};
+
+RTC_NOINIT_ATTR RtcImage rtc;
+
+FlashImage        flashed;                 // what flash holds (core 0)
+bool              flashedOnce = false;
+unsigned long     flashAt     = 0;
+std::atomic<bool> artFs{false};            // LittleFS mounted
+char              artUrl[sizeof(Playback::imgUrl)] = "";   // what the art file holds (core 1)
+bool              artOnce     = false;
+unsigned long     artAt       = 0;
+WarmStats         stats       = { WARM_NONE, -1, false, 0, 0, 0 };
+
+uint32_t imageCrc() {
+  return esp_rom_crc32_le(0, rtc.state, sizeof(rtc) - offsetof(RtcImage, state));
+}
+
+// Flash writes are due after the first minute (a crash loop never
+// writes), then once per WARM_FLASH_MS
+bool flashDue(bool once, unsigned long at) {
+  unsigned long ms = millis();
+  return once ? ms - at >= WARM_FLASH_MS : ms >= WARM_FLASH_FIRST_MS;
+}
+
+// Only what is drawn counts; progress moves on its own
+bool flashDiffers(const WarmState& s) {
+  const Playback& a = s.playback;
+  const Playback& b = flashed.playback;
+  if (a.active != b.active || a.playing != b.playing ||
+      strcmp(a.trackId, b.trackId) || strcmp(a.device, b.device)) return true;
+  if (s.tickers.count != flashed.tickers.count) return true;
+  for (int i = 0; i < s.tickers.count; i++) {
+    const TickerItem& x = s.tickers.items[i];
+    const TickerItem& y = flashed.tickers.items[i];
+    if (x.valid != y.valid || x.price != y.price || strcmp(x.symbol, y.symbol)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+time_t warmNow() {
+  time_t t = time(nullptr);
+  return t > WARM_EPOCH_MIN ? t : 0;
+}
+
+WarmSource warmLoad(WarmState& out) {
+  // After power-on RTC memory is noise; the CRC would catch it anyway
+  esp_reset_reason_t why = esp_reset_reason();
+  if (why != ESP_RST_POWERON && why != ESP_RST_UNKNOWN &&
+      rtc.magic == (WARM_MAGIC ^ sizeof(RtcImage)) && rtc.crc == imageCrc()) {
+    memcpy(&out, rtc.state, sizeof(out));
+    httpCacheImport(rtc.cache, min<int>(rtc.cacheCount, HTTP_CACHE_SLOTS));
+    stats.source = WARM_RTC;
+  } else {
+    FlashImage img;
+    if (prefs.getBytes("warm", &img, sizeof(img)) != sizeof(img) ||
+        img.magic != (WARM_MAGIC ^ sizeof(FlashImage))) {
+      return WARM_NONE;
+    }
+    out.playback     = img.playback;
+    out.tickers      = img.tickers;
+    out.token[0]     = 0;
+    out.tokenExpires = 0;
+    out.savedAt      = img.savedAt;
+    flashed          = img;   // already there; no need to write it again
+    stats.source     = WARM_FLASH;
+  }
+  time_t t = warmNow();
+  stats.ageS = (out.savedAt && t) ? (long)(t - out.savedAt) : -1;
+  LOG("[Warm] Restored from %s (%lds old)\n", stats.source == WARM_RTC ? "RTC" : "flash",
+      stats.ageS);
+  return stats.source;
+}
+
+void warmSave(const WarmState& s) {
+  // Invalid while it is being rewritten, so a reset halfway reads as empty
+  rtc.magic = 0;
+  memcpy(rtc.state, &s, sizeof(s));
+  rtc.cacheCount = httpCacheExport(rtc.cache, HTTP_CACHE_SLOTS);
+  rtc.crc   = imageCrc();
+  rtc.magic = WARM_MAGIC ^ sizeof(RtcImage);
+  stats.rtcSaves++;
+
+  if (!flashDue(flashedOnce, flashAt) || !flashDiffers(s)) return;
+  flashed.magic    = WARM_MAGIC ^ sizeof(FlashImage);
+  flashed.savedAt  = s.savedAt;
+  flashed.playback = s.playback;
+  flashed.tickers  = s.tickers;
+  prefs.putBytes("warm", &flashed, sizeof(flashed));
+  flashedOnce = true;
+  flashAt     = millis();
+  stats.flashSaves++;
+  LOG("[Warm] Saved to flash (%s)\n", s.playback.active ? s.playback.track : "idle");
+}
+
+void warmMountArt() {
+  if (artFs) return;
+  // The first mount formats the partition, which takes seconds
+  artFs = LittleFS.begin(true);
+  if (!artFs) LOGLN("[Warm] No art partition — covers won't survive a reboot");
+}
+
+bool warmSaveArt(const char* url, const uint8_t* jpg, size_t len) {
+  if (!artFs || !url[0] || len > ART_MAX || strcmp(url, artUrl) == 0) return false;
+  if (!flashDue(artOnce, artAt)) return false;
+  artOnce = true;
+  artAt   = millis();
+
+  // Written aside and renamed, so a reset mid-write keeps the old cover
+  ArtHeader h = { WARM_MAGIC, (uint32_t)len, "" };
+  strlcpy(h.url, url, sizeof(h.url));
+  File f = LittleFS.open(ART_TMP, "w");
+  if (!f) return false;
+  bool ok = f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) && f.write(jpg, len) == len;
+  f.close();
+  if (!ok || !LittleFS.rename(ART_TMP, ART_FILE)) {
+    LittleFS.remove(ART_TMP);
+    return false;
+  }
+  strlcpy(artUrl, url, sizeof(artUrl));
+  stats.artSaves++;
+  LOG("[Warm] Cover saved (%u bytes, %lums)\n", (unsigned)len, millis() - artAt);
+  return true;
+}
+
+uint8_t* warmLoadArt(const char* url, size_t& len) {
+  // Mount without formatting: the boot path must not spend seconds here
+  if (!artFs) artFs = LittleFS.begin(false);
+  if (!artFs || !url[0]) return nullptr;
+  File f = LittleFS.open(ART_FILE, "r");
+  if (!f) return nullptr;
+
+  ArtHeader h;
+  uint8_t*  buf = nullptr;
+  if (f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) && h.magic == WARM_MAGIC && h.len <= ART_MAX) {
+    h.url[sizeof(h.url) - 1] = 0;
+    strlcpy(artUrl, h.url, sizeof(artUrl));
+    if (strcmp(h.url, url) == 0 && (buf = (uint8_t*)ps_malloc(h.len)) &&
+        f.read(buf, h.len) != h.len) {
+      free(buf);
+      buf = nullptr;
+    }
+  }
+  f.close();
+  if (!buf) return nullptr;
+  len       = h.len;
+  stats.art = true;
+  return buf;
+}
+
+void warmStats(WarmStats& out) {
+  out = stats;
+}
@@ -0,0 +1,82 @@
+#pragma once
+// ============================================================
+//  Host build of the HTTP/2 session: stands in for config.h
+// ============================================================
+//  Only what h2conn.cpp and hpack.cpp reach for. TlsClient is a
+//  plain non-blocking TCP socket, so the session runs as h2c against
+//  a local server (server.js).
+// ============================================================
+
+#include "Arduino.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+#define LOG(...)           printf(__VA_ARGS__)
+#define HTTP_REQ_MAX       1024
+#define HTTP_HOST_MAX      40
+#define HTTP_ERR_SEND      -2
+#define HTTP_ERR_TOO_LONG  -4
+
+typedef int  StaticSemaphore_t;
+typedef int* SemaphoreHandle_t;
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(int* b) { return b; }
+inline void xSemaphoreTake(SemaphoreHandle_t, int) {}
+inline void xSemaphoreGive(SemaphoreHandle_t) {}
+#define portMAX_DELAY 0
+
+class TlsClient {
+ public:
+  bool open(int port) {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in a{};
+    a.sin_family      = AF_INET;
+    a.sin_port        = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd_, (sockaddr*)&a, sizeof(a))) return false;
+    fcntl(fd_, F_SETFL, O_NONBLOCK);
+    epoch_++;
+    return true;
+  }
+  uint32_t epoch() const { return epoch_; }
+
+  size_t write(const uint8_t* p, size_t n) {
+    size_t done = 0;
+    while (done < n) {
+      ssize_t r = ::send(fd_, p + done, n - done, 0);
+      if (r > 0)                done += r;
+      else if (errno == EAGAIN) delay(1);
+      else { closed_ = true; break; }
+    }
+    return done;
+  }
+  int available() {
+    if (pos_ == len_ && !closed_) {
+      ssize_t r = recv(fd_, buf_, sizeof(buf_), MSG_DONTWAIT);
+      if (r > 0) { len_ = r; pos_ = 0; }
+      else if (r == 0 || errno != EAGAIN) closed_ = true;
+    }
+    return len_ - pos_;
+  }
+  int read(uint8_t* p, size_t n) {
+    int a = available();
+    if (a <= 0) return -1;
+    int k = min((int)n, a);
+    memcpy(p, buf_ + pos_, k);
+    pos_ += k;
+    return k;
+  }
+  uint8_t connected() { available(); return !closed_ || len_ > pos_; }
+
+ private:
+  int      fd_     = -1;
+  bool     closed_ = false;
+  uint32_t epoch_  = 0;
+  uint8_t  buf_[4096];
+  int      pos_ = 0, len_ = 0;
+};
+
+#include "h2conn.h"
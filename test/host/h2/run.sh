@@ -0,0 +1,21 @@
+#!/bin/sh
+# HTTP/2 session host test: builds src/h2conn.cpp + src/hpack.cpp for
+# the host and runs them against a local Node h2c server.
+# Needs g++ and Node.js (any version with the http2 module).
+#   test/host/h2/run.sh
+set -e
+cd "$(dirname "$0")"
+ROOT=../../..
+PORT=18443
+OUT=$(mktemp -d)
+trap 'kill $SRV 2>/dev/null; rm -rf "$OUT"' EXIT
+
+g++ -std=gnu++17 -O1 -Wall -I. -I../shim -I$ROOT/include \
+    h2_test.cpp $ROOT/src/h2conn.cpp $ROOT/src/hpack.cpp -o "$OUT/h2_test"
+node server.js $PORT > "$OUT/server.log" 2>&1 &
+SRV=$!
+for i in 1 2 3 4 5 6 7 8 9 10; do
+  grep -q listening "$OUT/server.log" && break
+  sleep 0.2
+done
+"$OUT/h2_test" $PORT
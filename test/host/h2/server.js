@@ -0,0 +1,47 @@
+// Local h2c server for the HTTP/2 host test (see run.sh).
+// A small initial window makes request bodies wait for WINDOW_UPDATE.
+const http2 = require('http2');
+const port  = +(process.argv[2] || 18443);
+const srv   = http2.createServer({ settings: { headerTableSize: 4096, initialWindowSize: 1024 } });
+let n = 0;
+
+srv.on('stream', (s, h) => {
+  const p = h[':path'];
+  n++;
+  if (p === '/small') {
+    const b = JSON.stringify({ n, auth: h['authorization'] });
+    s.respond({ ':status': 200, 'content-type': 'application/json',
+                'content-length': b.length, 'etag': '"e' + n + '"' });
+    s.end(b);
+  } else if (p === '/big') {
+    // 40 KB, five times the stream window
+    s.respond({ ':status': 200 });
+    const chunk = Buffer.alloc(1000, 'x');
+    let i = 0;
+    const more = () => {
+      while (i < 40) {
+        i++;
+        if (!s.write(chunk)) { s.once('drain', more); return; }
+      }
+      s.end();
+    };
+    more();
+  } else if (p === '/slow') {
+    setTimeout(() => { s.respond({ ':status': 204 }); s.end(); }, 300);
+  } else if (p === '/echo') {
+    let b = '';
+    s.on('data', d => b += d);
+    s.on('end', () => { s.respond({ ':status': 201, 'x-len': String(b.length) }); s.end(b); });
+  } else if (p === '/hold') {
+    // Never reads the body, so its window never reopens
+    s.pause();
+  } else if (p === '/bye') {
+    s.respond({ ':status': 200 });
+    s.end('bye');
+    s.session.goaway(0);
+  } else {
+    s.respond({ ':status': 404 });
+    s.end();
+  }
+});
+srv.listen(port, '127.0.0.1', () => console.log('listening on ' + port));
@@ -0,0 +1,302 @@
+// ============================================================
+//  jsonExtract() against ArduinoJson on the API payloads (run.sh)
+// ============================================================
+//  Each payload is parsed the way the firmware parses it now (the
+//  declared paths through jsonExtract) and the way it did before
+//  (ArduinoJson: the poll through its filter, the others into a full
+//  document). Both read the same stream, which hands a body out in
+//  TCP-sized pieces as a socket would; ArduinoJson takes it as a
+//  custom reader (read() / readBytes()).
+//  Reports the time per parse and the heap ArduinoJson took, and
+//  checks that both parsers found the same values. Before timing, a
+//  few bodies cut off mid-value must fail within one stall timeout.
+//
+//  Without -DHAVE_ARDUINOJSON only the jsonExtract side runs.
+//
+//  The payloads follow the documented response shapes, with made-up
+//  values (the player one keeps the two available_markets lists that
+//  are most of a real poll body). To time live captures instead,
+//  overwrite them, e.g. (one command)
+//    curl -H "Authorization: Bearer $TOKEN" https://api.spotify.com/v1/me/player > payloads/player.json
+// ============================================================
+
+#include "Arduino.h"
+#include "jsonpull.h"
+#include <cmath>
+#include <string>
+#include <vector>
+#ifdef HAVE_ARDUINOJSON
+#include <ArduinoJson.h>
+#endif
+
+#define CHECK(x) do { if (!(x)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #x); exit(1); } } while (0)
+
+namespace {
+
+const size_t SEGMENT = 1436;   // TLS record payload over one MSS
+
+// A body that hands out at most SEGMENT bytes per available()
+class BodyStream : public Stream {
+ public:
+  BodyStream(const std::string& s) : s_(s) {}
+  int available() override {
+    size_t left = s_.size() - pos_;
+    return left < SEGMENT ? left : SEGMENT;
+  }
+  int read() override { return pos_ < s_.size() ? (uint8_t)s_[pos_++] : -1; }
+  size_t readBytes(char* buf, size_t n) override {
+    n = min(n, (size_t)available());
+    memcpy(buf, s_.data() + pos_, n);
+    pos_ += n;
+    return n;
+  }
+  int peek() override { return pos_ < s_.size() ? (uint8_t)s_[pos_] : -1; }
+
+ private:
+  const std::string& s_;
+  size_t             pos_ = 0;
+};
+
+std::string load(const char* dir, const char* name) {
+  std::string path = std::string(dir) + "/" + name;
+  FILE* f = fopen(path.c_str(), "rb");
+  CHECK(f);
+  std::string s;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, n);
+  fclose(f);
+  return s;
+}
+
+template <typename F>
+double usPerRun(int runs, F f) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++) f();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / runs;
+}
+
+#ifdef HAVE_ARDUINOJSON
+// The two parsers round decimal text to float their own way
+bool near(float a, float b) {
+  return fabsf(a - b) <= 1e-5f * max(fabsf(a), fabsf(b));
+}
+
+// Heap ArduinoJson asks for during one parse (peak)
+struct CountingAllocator : ArduinoJson::Allocator {
+  size_t live = 0, peak = 0;
+  void* allocate(size_t n) override {
+    size_t* p = (size_t*)malloc(n + sizeof(size_t));
+    *p = n;
+    live += n;
+    peak = max(peak, live);
+    return p + 1;
+  }
+  void deallocate(void* p) override {
+    if (!p) return;
+    size_t* h = (size_t*)p - 1;
+    live -= *h;
+    free(h);
+  }
+  void* reallocate(void* p, size_t n) override {
+    if (!p) return allocate(n);
+    size_t* h = (size_t*)p - 1;
+    live -= *h;
+    h = (size_t*)realloc(h, n + sizeof(size_t));
+    *h = n;
+    live += n;
+    peak = max(peak, live);
+    return h + 1;
+  }
+};
+#endif
+
+void report(const char* name, size_t bytes, double pullUs, double ajUs, size_t ajHeap) {
+  if (ajUs > 0) {
+    printf("%-10s %6zu B   jsonExtract %7.2f us   ArduinoJson %7.2f us (%4.1fx)  heap %5zu B\n",
+           name, bytes, pullUs, ajUs, ajUs / pullUs, ajHeap);
+  } else {
+    printf("%-10s %6zu B   jsonExtract %7.2f us\n", name, bytes, pullUs);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* dir  = argc > 1 ? argv[1] : "payloads";
+  const int   RUNS = argc > 2 ? atoi(argv[2]) : 20000;
+
+  // ── A body cut off mid-value fails after one stall timeout ──
+  {
+    const char* CUT[] = { "{\"item\":{\"artists\":[", "{\"item\":{", "[[[", "{\"a\":[1,",
+                          "{\"item\":{\"name\":\"So" };
+    char name[32];
+    JsonField fields[] = { jsonStr("item.artists[0].name", name, sizeof(name)),
+                           jsonStr("item.name", name, sizeof(name)) };
+    for (const char* cut : CUT) {
+      std::string body = cut;
+      BodyStream in(body);
+      unsigned long t0 = millis();
+      CHECK(!jsonExtract(in, fields, 2, 100));
+      unsigned long ms = millis() - t0;
+      if (ms >= 200) printf("FAIL %s: %lums\n", cut, ms);
+      CHECK(ms < 200);
+      // From memory there is nothing to wait for
+      CHECK(!jsonExtract((const uint8_t*)cut, strlen(cut), fields, 2));
+    }
+    puts("truncated bodies: ok");
+  }
+
+  // ── Spotify poll (GET /v1/me/player) ──
+  {
+    std::string body = load(dir, "player.json");
+    int  progress = 0, duration = 0;
+    bool playing  = false;
+    char id[32], track[96], artist[64], album[96], img1[128], img0[128], device[48];
+    JsonField fields[] = {
+      jsonInt ("progress_ms",              &progress),
+      jsonBool("is_playing",               &playing),
+      jsonStr ("item.id",                  id,     sizeof(id)),
+      jsonStr ("item.name",                track,  sizeof(track)),
+      jsonStr ("item.artists[0].name",     artist, sizeof(artist)),
+      jsonStr ("item.album.name",          album,  sizeof(album)),
+      jsonStr ("item.album.images[1].url", img1,   sizeof(img1)),
+      jsonStr ("item.album.images[0].url", img0,   sizeof(img0)),
+      jsonInt ("item.duration_ms",         &duration),
+      jsonStr ("device.name",              device, sizeof(device)),
+    };
+    const size_t N = sizeof(fields) / sizeof(fields[0]);
+    double pull = usPerRun(RUNS, [&] {
+      BodyStream in(body);
+      CHECK(jsonExtract(in, fields, N));
+    });
+    for (const JsonField& f : fields) CHECK(f.found);
+    // The reactor hands the poll its body in memory
+    char streamed[sizeof(track)];
+    strlcpy(streamed, track, sizeof(streamed));
+    CHECK(jsonExtract((const uint8_t*)body.data(), body.size(), fields, N));
+    for (const JsonField& f : fields) CHECK(f.found);
+    CHECK(!strcmp(streamed, track));
+    double aj = 0;
+    size_t heap = 0;
+#ifdef HAVE_ARDUINOJSON
+    // The filter the poll used before
+    JsonDocument filter;
+    filter["progress_ms"] = true;
+    filter["is_playing"] = true;
+    filter["item"]["id"] = true;
+    filter["item"]["name"] = true;
+    filter["item"]["artists"][0]["name"] = true;
+    filter["item"]["album"]["name"] = true;
+    filter["item"]["album"]["images"][0]["url"] = true;
+    filter["item"]["duration_ms"] = true;
+    filter["device"]["name"] = true;
+    CountingAllocator counter;
+    aj = usPerRun(RUNS, [&] {
+      JsonDocument doc(&counter);
+      BodyStream   in(body);
+      CHECK(!deserializeJson(doc, in, DeserializationOption::Filter(filter)));
+      CHECK(doc["progress_ms"].as<int>() == progress);
+      CHECK(!strcmp(doc["item"]["artists"][0]["name"] | "", artist));
+    });
+    heap = counter.peak;
+    JsonDocument doc;
+    deserializeJson(doc, body);
+    CHECK(!strcmp(doc["item"]["album"]["images"][0]["url"] | "", img0));
+    CHECK(!strcmp(doc["device"]["name"] | "", device));
+    CHECK(doc["item"]["duration_ms"].as<int>() == duration && doc["is_playing"] == playing);
+#endif
+    report("player", body.size(), pull, aj, heap);
+  }
+
+  // ── Token refresh ──
+  {
+    std::string body = load(dir, "token.json");
+    char at[400], rt[256];
+    int  expires = 0;
+    JsonField fields[] = {
+      jsonStr("access_token",  at, sizeof(at)),
+      jsonStr("refresh_token", rt, sizeof(rt)),
+      jsonInt("expires_in",    &expires),
+    };
+    double pull = usPerRun(RUNS, [&] {
+      BodyStream in(body);
+      CHECK(jsonExtract(in, fields, 3));
+    });
+    CHECK(fields[0].found && expires > 0);
+    double aj = 0;
+    size_t heap = 0;
+#ifdef HAVE_ARDUINOJSON
+    CountingAllocator counter;
+    aj = usPerRun(RUNS, [&] {
+      JsonDocument doc(&counter);
+      BodyStream   in(body);
+      CHECK(!deserializeJson(doc, in));
+      CHECK(!strcmp(doc["access_token"] | "", at) && doc["expires_in"] == expires);
+    });
+    heap = counter.peak;
+#endif
+    report("token", body.size(), pull, aj, heap);
+  }
+
+  // ── CoinGecko simple/price ──
+  {
+    std::string body = load(dir, "coingecko.json");
+    const char* IDS[] = { "bitcoin", "ethereum", "monero", "pax-gold" };
+    char  paths[4][2][48];
+    float price[4], chg[4];
+    JsonField fields[8];
+    for (int k = 0; k < 4; k++) {
+      snprintf(paths[k][0], sizeof(paths[k][0]), "%s.usd", IDS[k]);
+      snprintf(paths[k][1], sizeof(paths[k][1]), "%s.usd_24h_change", IDS[k]);
+      fields[2 * k]     = jsonFloat(paths[k][0], &price[k]);
+      fields[2 * k + 1] = jsonFloat(paths[k][1], &chg[k]);
+    }
+    double pull = usPerRun(RUNS, [&] {
+      BodyStream in(body);
+      CHECK(jsonExtract(in, fields, 8));
+    });
+    for (const JsonField& f : fields) CHECK(f.found);
+    double aj = 0;
+    size_t heap = 0;
+#ifdef HAVE_ARDUINOJSON
+    CountingAllocator counter;
+    aj = usPerRun(RUNS, [&] {
+      JsonDocument doc(&counter);
+      BodyStream   in(body);
+      CHECK(!deserializeJson(doc, in));
+      for (int k = 0; k < 4; k++) CHECK(near(doc[IDS[k]]["usd"].as<float>(), price[k]));
+    });
+    heap = counter.peak;
+#endif
+    report("coingecko", body.size(), pull, aj, heap);
+  }
+
+  // ── Finnhub quote ──
+  {
+    std::string body = load(dir, "finnhub.json");
+    float c = 0, dp = 0;
+    JsonField fields[] = { jsonFloat("c", &c), jsonFloat("dp", &dp) };
+    double pull = usPerRun(RUNS, [&] {
+      BodyStream in(body);
+      CHECK(jsonExtract(in, fields, 2));
+    });
+    CHECK(fields[0].found && fields[1].found);
+    double aj = 0;
+    size_t heap = 0;
+#ifdef HAVE_ARDUINOJSON
+    CountingAllocator counter;
+    aj = usPerRun(RUNS, [&] {
+      JsonDocument doc(&counter);
+      BodyStream   in(body);
+      CHECK(!deserializeJson(doc, in));
+      CHECK(near(doc["c"].as<float>(), c) && near(doc["dp"].as<float>(), dp));
+    });
+    heap = counter.peak;
+#endif
+    report("finnhub", body.size(), pull, aj, heap);
+  }
+  puts("OK");
+  return 0;
+}
@@ -0,0 +1,23 @@
+#!/bin/sh
+# jsonExtract() vs ArduinoJson on the API payloads in payloads/.
+# ArduinoJson (v7) is taken from ARDUINOJSON, or from PlatformIO's
+# copy once the firmware has been built; without it only jsonExtract
+# is timed.
+#   test/host/json/run.sh [runs]
+#   ARDUINOJSON=/path/to/ArduinoJson/src test/host/json/run.sh
+set -e
+cd "$(dirname "$0")"
+ROOT=../../..
+AJ=${ARDUINOJSON:-$ROOT/.pio/libdeps/esp32/ArduinoJson/src}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+FLAGS=""
+if [ -f "$AJ/ArduinoJson.h" ]; then
+  FLAGS="-DHAVE_ARDUINOJSON -I$AJ"
+else
+  echo "ArduinoJson not found ($AJ): timing jsonExtract only"
+fi
+g++ -std=gnu++17 -O2 -Wall -I../shim -I$ROOT/include $FLAGS \
+    bench.cpp $ROOT/src/jsonpull.cpp -o "$OUT/bench"
+"$OUT/bench" payloads ${1:-20000}
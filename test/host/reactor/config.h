@@ -0,0 +1,50 @@
+#pragma once
+// ============================================================
+//  Host build of the reactor: stands in for config.h
+// ============================================================
+//  The reactor, HttpClient, the HTTP/2 session, the pool, the
+//  breakers and the cache build unchanged against the real headers.
+//  TlsClient (tls_posix.cpp) is a plain TCP socket with the same
+//  non-blocking connect; its "handshake" is one line each way, in
+//  which the mock server (server.js) picks h2 or http/1.1 the way
+//  ALPN would.
+// ============================================================
+
+#include "Arduino.h"
+#include <atomic>
+
+#define LOG(...)    printf(__VA_ARGS__)
+#define LOGLN(x)    puts(x)
+
+typedef int  StaticSemaphore_t;
+typedef int* SemaphoreHandle_t;
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(int* b) { return b; }
+inline void xSemaphoreTake(SemaphoreHandle_t, int) {}
+inline void xSemaphoreGive(SemaphoreHandle_t) {}
+#define portMAX_DELAY 0
+
+inline uint32_t esp_random() { return (uint32_t)rand(); }
+inline void*    ps_realloc(void* p, size_t n) { return realloc(p, n); }
+
+struct EspClass {
+  unsigned getFreeHeap()  { return 256 * 1024; }
+  size_t   getFreePsram() { return 8 * 1024 * 1024; }
+  size_t   getPsramSize() { return 8 * 1024 * 1024; }
+};
+inline EspClass ESP;
+
+struct NetStats {
+  std::atomic<uint32_t> txBytes{0};
+  std::atomic<uint32_t> rxBytes{0};
+  std::atomic<uint32_t> rxDecoded{0};
+};
+
+// Local port the mock server answers `host` on (-1: no such host)
+int mockPort(const char* host);
+
+#include "tlsclient.h"
+#include "httpclient.h"
+#include "h2conn.h"
+#include "connpool.h"
+#include "breaker.h"
+#include "reactor.h"
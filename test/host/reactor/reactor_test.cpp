@@ -0,0 +1,270 @@
+// ============================================================
+//  Transfer reactor against a local mock server (see run.sh)
+// ============================================================
+//  Runs src/reactor.cpp with the real HttpClient, pool, breakers
+//  and cache: plain, chunked, gzip and 304 answers, a transfer that
+//  never gets an answer, one whose body stalls and one whose body is
+//  cut off, a stale keep-alive socket (sent again once) against a
+//  fresh one that closes (not sent again), a pipeline the server
+//  closes partway, a late request queued behind a slow one, a slow
+//  transfer that holds up no other, a busy HTTP/2 session shared by a
+//  second lease and answering it first, a server that declines h2,
+//  and a prewarmed session.
+// ============================================================
+
+#include "config.h"
+#include <string>
+#include <csignal>
+
+#define CHECK(x) do { if (!(x)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #x); exit(1); } } while (0)
+
+int portPlain = 0;
+
+int mockPort(const char* host) {
+  if (!strcmp(host, "down.test")) return portPlain + 2;   // nothing listens there
+  if (!strcmp(host, "h2.test"))   return portPlain + 1;
+  return strstr(host, ".test") ? portPlain : -1;
+}
+
+namespace {
+
+struct Result {
+  bool          done;
+  int           code;
+  std::string   body;
+  unsigned long at;     // ms after start
+};
+
+unsigned long t0;
+NetStats      net;
+Endpoint      ep = EP_SPOTIFY_API;   // failures spread so no breaker trips
+
+void onDone(int code, uint8_t* body, size_t len, void* ctx) {
+  Result& r = *(Result*)ctx;
+  CHECK(!r.done);   // exactly once
+  r.done = true;
+  r.code = code;
+  r.at   = millis() - t0;
+  if (body) r.body.assign((const char*)body, len);
+  free(body);
+}
+
+void useCache(HttpClient& http, void*)   { http.useCache(); }
+void acceptGzip(HttpClient& http, void*) { http.acceptGzip(); }
+
+bool start(Result& r, const char* host, const char* path, uint32_t deadlineMs = 3000,
+           uint8_t flags = 0, FetchHeaders headers = nullptr) {
+  r = Result{};
+  FetchReq req = { host, path, nullptr, nullptr, PRIO_SPOTIFY, ep, &net,
+                   deadlineMs, flags, headers };
+  return fetchRequest(req, onDone, &r);
+}
+
+// Step the reactor until nothing is in flight
+void run() {
+  unsigned long until = millis() + 10000;
+  while (fetchBusy()) {
+    CHECK((long)(millis() - until) < 0);
+    reactorRun(REACTOR_SLICE_MS);
+  }
+}
+
+Result one(const char* host, const char* path, uint32_t deadlineMs = 3000,
+           FetchHeaders headers = nullptr) {
+  Result r;
+  t0 = millis();
+  CHECK(start(r, host, path, deadlineMs, 0, headers));
+  run();
+  CHECK(r.done);
+  return r;
+}
+
+ReactorStats stats() {
+  ReactorStats s;
+  reactorStats(s);
+  return s;
+}
+
+// "conn" from a /json or /q answer
+int connOf(const Result& r) {
+  const char* p = strstr(r.body.c_str(), "\"conn\":");
+  return p ? atoi(p + 7) : -1;
+}
+
+// Pool slots held for `host`
+int slotsFor(const char* host) {
+  PoolStats ps;
+  poolStats(ps);
+  int n = 0;
+  for (int i = 0; i < ps.count; i++) n += !strcmp(ps.slots[i].host, host);
+  return n;
+}
+
+// The pool's slot for `host`, or nullptr
+const PoolSlotInfo* slotOf(PoolStats& ps, const char* host) {
+  poolStats(ps);
+  for (int i = 0; i < ps.count; i++) {
+    if (!strcmp(ps.slots[i].host, host)) return &ps.slots[i];
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  signal(SIGPIPE, SIG_IGN);
+  portPlain = argc > 1 ? atoi(argv[1]) : 18480;
+
+  // A prewarm only opens the session; the first request finds it open
+  PoolStats ps;
+  uint32_t  done = stats().done;
+  CHECK(fetchPrewarm("warm.test", PRIO_ART));
+  run();
+  const PoolSlotInfo* w = slotOf(ps, "warm.test");
+  CHECK(w && w->open && w->leases == 1 && stats().done == done);
+  Result wr = one("warm.test", "/json");
+  w = slotOf(ps, "warm.test");
+  CHECK(wr.code == 200 && wr.body.find("\"n\":1") != std::string::npos && w->leases == 2);
+  printf("prewarm: ok\n");
+
+  // Plain answers; the second request rides the kept-alive socket
+  Result a = one("plain.test", "/json");
+  CHECK(a.code == 200 && a.body.find("\"n\":1") != std::string::npos);
+  Result b = one("plain.test", "/json");
+  CHECK(b.code == 200 && connOf(b) == connOf(a) && b.body.find("\"n\":2") != std::string::npos);
+  printf("keep-alive: ok\n");
+
+  Result c = one("plain.test", "/chunked");
+  CHECK(c.code == 200 && c.body == "part0;part1;part2;part3;part4;");
+  printf("chunked: ok\n");
+
+  Result g = one("plain.test", "/gzip", 3000, acceptGzip);
+  CHECK(g.code == 200 && g.body.size() == 20010 && g.body.compare(0, 8, "{\"pad\":\"") == 0);
+  CHECK(net.rxDecoded > net.rxBytes);
+  printf("gzip: ok (%u bytes decoded)\n", (unsigned)g.body.size());
+
+  Result e1 = one("plain.test", "/etag", 3000, useCache);
+  Result e2 = one("plain.test", "/etag", 3000, useCache);
+  CHECK(e1.code == 200 && e1.body == "{\"v\":1}");
+  CHECK(e2.code == 304 && e2.body.empty());
+  printf("304: ok\n");
+
+  // Keep-alive socket closed by the server as the request went out:
+  // sent once more on a new connection
+  uint32_t retries = stats().retries;
+  Result s = one("plain.test", "/stale");
+  CHECK(s.code == 200 && s.body.find("fresh") != std::string::npos && connOf(s) != connOf(b));
+  CHECK(stats().retries == retries + 1);
+  printf("stale keep-alive: ok (retried)\n");
+
+  // The same on a reused socket that closes again: one retry, no more
+  ep = EP_ART;
+  Result d1 = one("plain.test", "/drop");
+  CHECK(d1.code == HTTP_ERR_READ && stats().retries == retries + 2);
+  // A fresh connection closed unanswered is an error, not a stale socket
+  Result d2 = one("fresh.test", "/drop");
+  CHECK(d2.code == HTTP_ERR_READ && stats().retries == retries + 2);
+  printf("closed unanswered: ok (fresh socket not retried)\n");
+
+  // Deadlines: no answer at all, then a body that stops halfway
+  uint32_t late = stats().late;
+  ep = EP_COINGECKO;
+  Result h = one("plain.test", "/hang", 300);
+  CHECK(h.code == HTTP_ERR_READ && h.at >= 300 && h.at < 600);
+  Result st = one("plain.test", "/stall", 400);
+  CHECK(st.code == HTTP_ERR_READ && st.at >= 400 && st.at < 700);
+  CHECK(stats().late == late + 2);
+  printf("deadline: ok (%lums, %lums)\n", h.at, st.at);
+
+  // A body cut off by the server fails at once, not at the deadline
+  ep = EP_FINNHUB;
+  Result cut = one("plain.test", "/cut", 3000);
+  CHECK(cut.code == HTTP_ERR_READ && cut.at < 1000 && stats().late == late + 2);
+  printf("cut body: ok (%lums)\n", cut.at);
+
+  Result down = one("down.test", "/json");
+  CHECK(down.code == HTTP_ERR_CONNECT);
+  printf("refused: ok\n");
+
+  // Five quotes pipelined on one connection; the server closes it
+  // after every third answer, and the rest go again on a new one
+  ep = EP_SPOTIFY_API;
+  retries = stats().retries;
+  Result q[5];
+  char   paths[5][16];
+  t0 = millis();
+  for (int i = 0; i < 5; i++) {
+    snprintf(paths[i], sizeof(paths[i]), "/q?i=%d", i);
+    CHECK(start(q[i], "pipe.test", paths[i], 3000, FETCH_PIPELINE));
+  }
+  run();
+  for (int i = 0; i < 5; i++) {
+    char want[16];
+    snprintf(want, sizeof(want), "{\"i\":%d,", i);
+    CHECK(q[i].code == 200 && q[i].body.find(want) == 0 && q[i].at < 200);
+  }
+  CHECK(connOf(q[0]) == connOf(q[2]) && connOf(q[3]) == connOf(q[4]) && connOf(q[2]) != connOf(q[3]));
+  CHECK(stats().retries == retries + 2);
+  printf("pipeline: ok (closed after 3, 2 sent again)\n");
+
+  // A request queued behind a slow one is reported at its deadline,
+  // without waiting for the slow answer
+  Result slow, behind;
+  t0 = millis();
+  CHECK(start(slow, "queue.test", "/slow?ms=600", 3000, FETCH_PIPELINE));
+  CHECK(start(behind, "queue.test", "/json", 200, FETCH_PIPELINE));
+  run();
+  CHECK(behind.code == HTTP_ERR_READ && behind.at >= 200 && behind.at < 500);
+  CHECK(slow.code == 200 && slow.at >= 600);
+  printf("late in queue: ok (%lums, slow one %lums)\n", behind.at, slow.at);
+
+  // Separate connections: a slow transfer holds up no other
+  Result s1, f1;
+  t0 = millis();
+  CHECK(start(s1, "slow.test", "/slow?ms=500"));
+  CHECK(start(f1, "plain.test", "/json"));
+  run();
+  CHECK(s1.code == 200 && f1.code == 200 && f1.at < 200 && s1.at >= 500);
+  printf("concurrent: ok (%lums while the slow one took %lums)\n", f1.at, s1.at);
+
+  // A second transfer to a busy HTTP/2 session is another stream on
+  // it, not a second slot, and its answer doesn't wait for the first
+  tlsOfferH2("h2.test", true);
+  Result h0 = one("h2.test", "/json");
+  CHECK(h0.code == 200 && h0.body.find("\"v\":\"2.0\"") != std::string::npos);
+  uint32_t shared = (poolStats(ps), ps.shared);
+  Result hs, hf;
+  t0 = millis();
+  CHECK(start(hs, "h2.test", "/slow?ms=400"));
+  CHECK(start(hf, "h2.test", "/json"));
+  run();
+  CHECK(hs.code == 200 && hf.code == 200 && hf.at < 200 && hs.at >= 400);
+  CHECK(connOf(hs) == connOf(h0) && connOf(hf) == connOf(h0));
+  CHECK(slotsFor("h2.test") == 1 && (poolStats(ps), ps.shared) == shared + 1);
+  printf("h2 shared: ok (%lums on the session the slow one held for %lums)\n", hf.at, hs.at);
+
+  // h2 offered to a server that only speaks HTTP/1.1: the requests go
+  // as HTTP/1.1, and a busy connection is not shared
+  tlsOfferH2("h1.test", true);
+  Result h1a, h1b;
+  t0 = millis();
+  CHECK(start(h1a, "h1.test", "/json"));
+  CHECK(start(h1b, "h1.test", "/json"));
+  run();
+  for (const Result* r : { &h1a, &h1b }) {
+    CHECK(r->code == 200 && r->body.find("\"v\":\"1.1\"") != std::string::npos);
+  }
+  CHECK(connOf(h1a) != connOf(h1b) && slotsFor("h1.test") == 2);
+  CHECK((poolStats(ps), ps.shared) == shared + 1);
+  printf("h2 declined: ok (HTTP/1.1 on two connections)\n");
+
+  // With the budget full, a prewarm closes no session to make room
+  CHECK(!fetchPrewarm("late.test", PRIO_ART));
+  printf("prewarm with the budget full: refused\n");
+
+  ReactorStats rs = stats();
+  printf("done %u failed %u late %u retries %u steps %u\n", (unsigned)rs.done,
+         (unsigned)rs.failed, (unsigned)rs.late, (unsigned)rs.retries, (unsigned)rs.steps);
+  printf("OK\n");
+  return 0;
+}
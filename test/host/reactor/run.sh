@@ -0,0 +1,25 @@
+#!/bin/sh
+# Transfer reactor host test: builds src/reactor.cpp with the real
+# HttpClient, HTTP/2 session, pool, breakers and cache over a plain
+# TCP TlsClient (tls_posix.cpp), and runs it against a local Node
+# mock server.
+# Needs g++, zlib and Node.js.
+#   test/host/reactor/run.sh
+set -e
+cd "$(dirname "$0")"
+ROOT=../../..
+PORT=18480
+OUT=$(mktemp -d)
+trap 'kill $SRV 2>/dev/null; rm -rf "$OUT"' EXIT
+
+g++ -std=gnu++17 -O1 -Wall -I. -I../shim -I$ROOT/include \
+    reactor_test.cpp tls_posix.cpp $ROOT/src/reactor.cpp $ROOT/src/httpclient.cpp \
+    $ROOT/src/h2conn.cpp $ROOT/src/hpack.cpp $ROOT/src/connpool.cpp \
+    $ROOT/src/breaker.cpp $ROOT/src/httpcache.cpp -lz -o "$OUT/reactor_test"
+node server.js $PORT > "$OUT/server.log" 2>&1 &
+SRV=$!
+for i in 1 2 3 4 5 6 7 8 9 10; do
+  grep -q listening "$OUT/server.log" && break
+  sleep 0.2
+done
+"$OUT/reactor_test" $PORT
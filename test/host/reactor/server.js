@@ -0,0 +1,109 @@
+// Mock server for the reactor host test (see run.sh).
+// Two ports: PLAIN speaks only HTTP/1.1, H2 also h2c. Each connection
+// opens with one line each way standing in for the TLS handshake:
+// "ALPN h2" or "ALPN http/1.1" from the client, the pick from us.
+const net   = require('net');
+const http  = require('http');
+const http2 = require('http2');
+const zlib  = require('zlib');
+const plain = +(process.argv[2] || 18480);
+const h2    = plain + 1;
+
+let conns = 0;
+function handle(req, res) {
+  const s = req.stream ? req.stream.session : req.socket;
+  const url = new URL(req.url, 'http://x');
+  const p = url.pathname;
+  // Requests seen on this connection, this one included
+  s.served = (s.served || 0) + 1;
+  const json = (o, extra) => {
+    const b = JSON.stringify(o);
+    res.writeHead(200, Object.assign({ 'content-type': 'application/json',
+                                       'content-length': b.length }, extra || {}));
+    res.end(b);
+  };
+
+  if (p === '/json') {
+    json({ conn: s.id, n: s.served, v: req.httpVersion });
+  } else if (p === '/chunked') {
+    res.writeHead(200, { 'content-type': 'text/plain' });
+    let i = 0;
+    const t = setInterval(() => {
+      res.write('part' + i + ';');
+      if (++i === 5) { clearInterval(t); res.end(); }
+    }, 20);
+  } else if (p === '/etag') {
+    if (req.headers['if-none-match'] === '"v1"') {
+      res.writeHead(304, { etag: '"v1"' });
+      res.end();
+    } else {
+      json({ v: 1 }, { etag: '"v1"', 'cache-control': 'no-cache' });
+    }
+  } else if (p === '/gzip') {
+    // 20 KB of JSON that packs into a few hundred bytes: the body
+    // buffer has to grow well past Content-Length
+    const b = JSON.stringify({ pad: 'x'.repeat(20000) });
+    if (/gzip/.test(req.headers['accept-encoding'] || '')) {
+      const z = zlib.gzipSync(b);
+      res.writeHead(200, { 'content-encoding': 'gzip', 'content-length': z.length });
+      res.end(z);
+    } else {
+      res.writeHead(200, { 'content-length': b.length });
+      res.end(b);
+    }
+  } else if (p === '/slow') {
+    setTimeout(() => json({ slow: true, conn: s.id }), +(url.searchParams.get('ms') || 500));
+  } else if (p === '/hang') {
+    // never answers
+  } else if (p === '/stall') {
+    res.writeHead(200, { 'content-length': 1000 });
+    res.write('x'.repeat(100));
+  } else if (p === '/cut') {
+    res.writeHead(200, { 'content-length': 1000 });
+    res.write('x'.repeat(100), () => setTimeout(() => s.destroy(), 50));
+  } else if (p === '/stale') {
+    // A kept-alive socket the server closed just as the request went out
+    if (s.served > 1) s.destroy();
+    else json({ conn: s.id, fresh: true });
+  } else if (p === '/drop') {
+    s.destroy();
+  } else if (p === '/q') {
+    // A server that closes every connection after three answers
+    json({ i: +url.searchParams.get('i'), conn: s.id },
+         s.served === 3 ? { connection: 'close' } : {});
+  } else {
+    res.writeHead(404, { 'content-length': 0 });
+    res.end();
+  }
+}
+
+const h1srv = http.createServer({ keepAliveTimeout: 60000 }, handle);
+const h2srv = http2.createServer({}, handle);
+h2srv.on('session', ss => { ss.id = ++conns; });
+
+function listen(port, mayH2) {
+  net.createServer(sock => {
+    sock.id = ++conns;
+    sock.setNoDelay(true);   // as the real servers: no Nagle delay on pipelined answers
+    let hello = Buffer.alloc(0);
+    const onData = d => {
+      hello = Buffer.concat([hello, d]);
+      const nl = hello.indexOf('\n');
+      if (nl < 0) return;
+      sock.removeListener('data', onData);
+      sock.pause();
+      const offered = hello.slice(0, nl).toString();
+      const proto   = mayH2 && /\bh2\b/.test(offered) ? 'h2' : 'http/1.1';
+      if (hello.length > nl + 1) sock.unshift(hello.slice(nl + 1));
+      sock.write(proto + '\n');
+      (proto === 'h2' ? h2srv : h1srv).emit('connection', sock);
+      sock.resume();
+    };
+    sock.on('data', onData);
+    sock.on('error', () => {});
+  }).listen(port, '127.0.0.1');
+}
+
+listen(plain, false);
+listen(h2, true);
+setTimeout(() => console.log('listening on ' + plain + ', ' + h2), 50);
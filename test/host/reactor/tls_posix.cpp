@@ -0,0 +1,182 @@
+// ============================================================
+//  TlsClient over a plain TCP socket (see config.h)
+// ============================================================
+//  Same calls and the same non-blocking connect as src/tlsclient.cpp.
+//  In place of the TLS handshake the client sends "ALPN h2" or
+//  "ALPN http/1.1" and the server answers with the protocol it
+//  picked, so connectStep() waits on the socket just as often.
+// ============================================================
+
+#include "config.h"
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace {
+
+char offerH2[4][TLS_HOST_MAX];
+
+bool offered(const char* host) {
+  for (const char* h : offerH2) {
+    if (!strcmp(h, host)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+void tlsOfferH2(const char* host, bool on) {
+  for (char* h : offerH2) {
+    if (on ? !h[0] : !strcmp(h, host)) {
+      strlcpy(h, on ? host : "", TLS_HOST_MAX);
+      return;
+    }
+  }
+}
+
+void     tlsForgetSession(const char*) {}
+void     tlsNoteFirstByte(const char*, unsigned long) {}
+uint32_t tlsSessionCost(uint32_t fallback) { return fallback; }
+bool     tlsAllocInstalled() { return false; }
+
+TlsClient::TlsClient()  { net_.fd = -1; }
+TlsClient::~TlsClient() { stop(); }
+
+int TlsClient::connect(IPAddress, uint16_t)          { return 0; }
+int TlsClient::connect(IPAddress, uint16_t, int32_t) { return 0; }
+int TlsClient::connect(const char* host, uint16_t port) { return connect(host, port, 0); }
+
+int TlsClient::connect(const char* host, uint16_t port, int32_t) {
+  if (!connectStart(host, port)) return 0;
+  for (unsigned long t0 = millis(); millis() - t0 < TLS_CONNECT_TIMEOUT_MS; delay(1)) {
+    TlsStep s = connectStep();
+    if (s != TLS_STEP_PENDING) return s == TLS_STEP_DONE;
+  }
+  stop();
+  return 0;
+}
+
+bool TlsClient::connectStart(const char* host, uint16_t) {
+  stop();
+  int port = mockPort(host);
+  if (port < 0) return false;
+  strlcpy(host_, host, sizeof(host_));
+  net_.fd = socket(AF_INET, SOCK_STREAM, 0);
+  fcntl(net_.fd, F_SETFL, O_NONBLOCK);
+  int one = 1;
+  setsockopt(net_.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  sockaddr_in a{};
+  a.sin_family      = AF_INET;
+  a.sin_port        = htons(port);
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (::connect(net_.fd, (sockaddr*)&a, sizeof(a)) && errno != EINPROGRESS) {
+    stop();
+    return false;
+  }
+  phase_ = CONN_TCP;
+  return true;
+}
+
+TlsStep TlsClient::connectStep() {
+  if (phase_ == CONN_TCP) {
+    pollfd p = { net_.fd, POLLOUT, 0 };
+    if (poll(&p, 1, 0) <= 0) return TLS_STEP_PENDING;
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(net_.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    const char* hello = offered(host_) ? "ALPN h2\n" : "ALPN http/1.1\n";
+    if (err || ::send(net_.fd, hello, strlen(hello), MSG_NOSIGNAL) != (ssize_t)strlen(hello)) {
+      stop();
+      return TLS_STEP_FAILED;
+    }
+    phase_ = CONN_TLS;
+    return TLS_STEP_PENDING;
+  }
+  if (phase_ != CONN_TLS) return TLS_STEP_FAILED;
+
+  char    line[16];
+  ssize_t n = recv(net_.fd, line, sizeof(line) - 1, MSG_PEEK | MSG_DONTWAIT);
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return TLS_STEP_PENDING;
+  char* nl = n > 0 ? (char*)memchr(line, '\n', n) : nullptr;
+  if (!nl) {
+    if (n > 0 && n < (ssize_t)sizeof(line) - 1) return TLS_STEP_PENDING;
+    stop();
+    return TLS_STEP_FAILED;
+  }
+  recv(net_.fd, line, nl - line + 1, 0);
+  *nl        = 0;
+  h2_        = !strcmp(line, "h2");
+  phase_     = CONN_IDLE;
+  connected_ = true;
+  closed_    = false;
+  epoch_++;
+  return TLS_STEP_DONE;
+}
+
+size_t TlsClient::write(uint8_t b) { return write(&b, 1); }
+
+size_t TlsClient::write(const uint8_t* buf, size_t size) {
+  if (!connected_) return 0;
+  size_t done = 0;
+  while (done < size) {
+    ssize_t r = ::send(net_.fd, buf + done, size - done, MSG_NOSIGNAL);
+    if (r > 0)                                        done += r;
+    else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) delay(1);
+    else {
+      closed_ = true;
+      break;
+    }
+  }
+  return done;
+}
+
+int TlsClient::available() {
+  if (!connected_) return 0;
+  int n = 0;
+  if (ioctl(net_.fd, FIONREAD, &n) < 0) n = 0;
+  if (n == 0 && !closed_) {
+    char    b;
+    ssize_t r = recv(net_.fd, &b, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) closed_ = true;
+  }
+  return n;
+}
+
+int TlsClient::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+int TlsClient::read(uint8_t* buf, size_t size) {
+  if (!connected_) return -1;
+  ssize_t r = recv(net_.fd, buf, size, MSG_DONTWAIT);
+  if (r == 0) closed_ = true;
+  return r > 0 ? (int)r : -1;
+}
+
+int  TlsClient::peek()  { return -1; }
+void TlsClient::flush() {}
+
+void TlsClient::stop() {
+  if (net_.fd >= 0) close(net_.fd);
+  net_.fd    = -1;
+  connected_ = false;
+  closed_    = false;
+  h2_        = false;
+  phase_     = CONN_IDLE;
+  wantWrite_ = false;
+}
+
+uint8_t TlsClient::connected() {
+  return connected_ && (available() > 0 || !closed_);
+}
+
+bool TlsClient::alive() {
+  return connected_ && available() == 0 && !closed_;
+}
@@ -0,0 +1,55 @@
+#pragma once
+// ============================================================
+//  Host stand-in for the few Arduino calls the tested modules use
+// ============================================================
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <strings.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using std::min;
+using std::max;
+
+inline unsigned long millis() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// newlib has these; glibc only from 2.38
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+inline size_t strlcpy(char* d, const char* s, size_t n) {
+  size_t len = strlen(s);
+  if (n) {
+    size_t k = len < n - 1 ? len : n - 1;
+    memcpy(d, s, k);
+    d[k] = 0;
+  }
+  return len;
+}
+inline size_t strlcat(char* d, const char* s, size_t n) {
+  size_t at = strnlen(d, n);
+  return at == n ? n + strlen(s) : at + strlcpy(d + at, s, n - at);
+}
+#endif
+
+struct IPAddress {};
+
+// The reading side, plus the writing calls a Stream subclass overrides
+class Stream {
+ public:
+  virtual ~Stream() {}
+  virtual int    available() = 0;
+  virtual int    read() = 0;
+  virtual size_t readBytes(char* buf, size_t n) = 0;
+  virtual int    peek() = 0;
+  virtual size_t write(uint8_t) { return 0; }
+  virtual void   flush() {}
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include "Arduino.h"
+
+class Client {
+ public:
+  virtual ~Client() {}
+  virtual int     connect(IPAddress, uint16_t) = 0;
+  virtual int     connect(const char*, uint16_t) = 0;
+  virtual size_t  write(uint8_t) = 0;
+  virtual size_t  write(const uint8_t*, size_t) = 0;
+  virtual int     available() = 0;
+  virtual int     read() = 0;
+  virtual int     read(uint8_t*, size_t) = 0;
+  virtual int     peek() = 0;
+  virtual void    flush() = 0;
+  virtual void    stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual operator bool() = 0;
+};
@@ -0,0 +1,11 @@
+#pragma once
+// TlsClient derives from WiFiClient; nothing else of it is used
+#include "Client.h"
+
+class WiFiClient : public Client {
+ public:
+  using Client::connect;
+  virtual int connect(IPAddress ip, uint16_t port, int32_t timeout) = 0;
+  virtual int connect(const char* host, uint16_t port, int32_t timeout) = 0;
+  operator bool() override { return connected(); }
+};
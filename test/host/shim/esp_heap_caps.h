@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdlib>
+
+#define MALLOC_CAP_SPIRAM    (1 << 10)
+#define MALLOC_CAP_INTERNAL  (1 << 11)
+#define MALLOC_CAP_8BIT      (1 << 2)
+
+// Zeroed, so a stand-in struct in a work area (rom/miniz.h) starts clean
+inline void* heap_caps_malloc(size_t n, int)           { return calloc(1, n); }
+inline void* heap_caps_calloc(size_t n, size_t s, int) { return calloc(n, s); }
+inline void  heap_caps_free(void* p)                   { free(p); }
+inline size_t heap_caps_get_free_size(int)             { return 256 * 1024; }
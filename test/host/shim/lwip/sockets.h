@@ -0,0 +1,6 @@
+#pragma once
+#include <sys/select.h>
+
+inline int lwip_select(int n, fd_set* rd, fd_set* wr, fd_set* ex, struct timeval* tv) {
+  return select(n, rd, wr, ex, tv);
+}
@@ -0,0 +1,2 @@
+#pragma once
+struct mbedtls_net_context { int fd; };
@@ -0,0 +1,9 @@
+#pragma once
+// The types TlsClient keeps as members; the host build has no TLS
+#include <cstddef>
+
+struct mbedtls_ssl_session { unsigned char master[48]; };
+struct mbedtls_ssl_context { int unused; };
+struct mbedtls_ssl_config  { int unused; };
+
+inline size_t mbedtls_ssl_get_bytes_avail(const mbedtls_ssl_context*) { return 0; }
@@ -0,0 +1,43 @@
+#pragma once
+// ============================================================
+//  The ROM's tinfl, as far as HttpInflate uses it, over zlib
+// ============================================================
+#include <cstring>
+#include <zlib.h>
+
+#define TINFL_LZ_DICT_SIZE         32768
+#define TINFL_FLAG_HAS_MORE_INPUT  2
+
+enum tinfl_status {
+  TINFL_STATUS_FAILED           = -1,
+  TINFL_STATUS_DONE             = 0,
+  TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+  TINFL_STATUS_HAS_MORE_OUTPUT  = 2,
+};
+
+struct tinfl_decompressor {
+  z_stream z;
+  bool     live;   // z holds an inflate state (the work area starts zeroed)
+};
+
+inline void tinfl_init(tinfl_decompressor* d) {
+  if (d->live) inflateEnd(&d->z);
+  memset(&d->z, 0, sizeof(d->z));
+  d->live = inflateInit2(&d->z, -15) == Z_OK;   // raw deflate
+}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor* d, const uint8_t* in, size_t* inSize,
+                                     uint8_t*, uint8_t* out, size_t* outSize, uint32_t flags) {
+  d->z.next_in   = (Bytef*)in;
+  d->z.avail_in  = *inSize;
+  d->z.next_out  = out;
+  d->z.avail_out = *outSize;
+  int rc = inflate(&d->z, Z_NO_FLUSH);
+  *inSize  -= d->z.avail_in;
+  *outSize -= d->z.avail_out;
+  if (rc == Z_STREAM_END)                return TINFL_STATUS_DONE;
+  if (rc != Z_OK && rc != Z_BUF_ERROR)   return TINFL_STATUS_FAILED;
+  if (!d->z.avail_out)                   return TINFL_STATUS_HAS_MORE_OUTPUT;
+  if (!(flags & TINFL_FLAG_HAS_MORE_INPUT)) return TINFL_STATUS_FAILED;
+  return TINFL_STATUS_NEEDS_MORE_INPUT;
+}